@@ -3196,6 +3196,130 @@ void CFCharacterSetInitInlineBuffer(CFCharacterSetRef cset, CFCharacterSetInline
 }
 
 
+/* Bulk scanning
+*/
+// The Latin-1 table is only built once this many characters have been tested one at a time without stopping, so that short scans, such as repeated searches for the next separator, never pay for it.
+#define __kCFCharacterSetLatin1TableThreshold (64)
+
+// Fills table with 1 for each Latin-1 character the scan stops at, so that eight characters can be tested with eight loads and one branch.
+static void __CFCharacterSetInlineBufferFillLatin1Table(const CFCharacterSetInlineBuffer *buffer, bool findNonMembers, uint8_t table[256]) {
+    for (UTF32Char character = 0; character < 256; character++) {
+        table[character] = ((CFCharacterSetInlineBufferIsLongCharacterMember(buffer, character) != findNonMembers) ? 1 : 0);
+    }
+}
+
+#define __CFCharacterSetLatin1TableHitsInEight(table, units, idx) (table[units[(idx)]] | table[units[(idx) + 1]] | table[units[(idx) + 2]] | table[units[(idx) + 3]] | table[units[(idx) + 4]] | table[units[(idx) + 5]] | table[units[(idx) + 6]] | table[units[(idx) + 7]])
+
+CFIndex _CFCharacterSetInlineBufferFindByte(const CFCharacterSetInlineBuffer *buffer, const uint8_t *bytes, CFIndex length, bool findNonMembers, bool backwards) {
+    uint8_t table[256];
+    CFIndex directLength = __CFMin(length, __kCFCharacterSetLatin1TableThreshold);
+
+    if (!backwards) {
+        CFIndex idx;
+        for (idx = 0; idx < directLength; idx++) {
+            if (CFCharacterSetInlineBufferIsLongCharacterMember(buffer, bytes[idx]) != findNonMembers) return idx;
+        }
+        if (idx == length) return kCFNotFound;
+
+        __CFCharacterSetInlineBufferFillLatin1Table(buffer, findNonMembers, table);
+        while ((idx + 8 <= length) && (0 == __CFCharacterSetLatin1TableHitsInEight(table, bytes, idx))) idx += 8;
+        for (; idx < length; idx++) {
+            if (0 != table[bytes[idx]]) return idx;
+        }
+    } else {
+        CFIndex idx;
+        for (idx = length; idx > length - directLength; idx--) {
+            if (CFCharacterSetInlineBufferIsLongCharacterMember(buffer, bytes[idx - 1]) != findNonMembers) return idx - 1;
+        }
+        if (idx == 0) return kCFNotFound;
+
+        __CFCharacterSetInlineBufferFillLatin1Table(buffer, findNonMembers, table);
+        while ((idx >= 8) && (0 == __CFCharacterSetLatin1TableHitsInEight(table, bytes, idx - 8))) idx -= 8;
+        while (idx-- > 0) {
+            if (0 != table[bytes[idx]]) return idx;
+        }
+    }
+    return kCFNotFound;
+}
+
+// Whether eight characters starting at idx are all Latin-1 and none of them stops the scan.
+CF_INLINE bool __CFCharacterSetLatin1TableSkipsEight(const uint8_t *table, const UniChar *characters, CFIndex idx) {
+    uint64_t first, second;
+    memcpy(&first, characters + idx, sizeof(first));
+    memcpy(&second, characters + idx + 4, sizeof(second));
+    if (0 != ((first | second) & 0xFF00FF00FF00FF00ULL)) return false;
+    return (0 == __CFCharacterSetLatin1TableHitsInEight(table, characters, idx));
+}
+
+CF_INLINE bool __CFCharacterSetInlineBufferIsMember(const CFCharacterSetInlineBuffer *buffer, const uint8_t *table, UTF32Char character, bool findNonMembers) {
+    if ((NULL != table) && (character < 256)) return (0 != table[character]) != findNonMembers;
+    return CFCharacterSetInlineBufferIsLongCharacterMember(buffer, character);
+}
+
+CFRange _CFCharacterSetInlineBufferFindCharacter(const CFCharacterSetInlineBuffer *buffer, const UniChar *characters, CFIndex length, bool findNonMembers, bool backwards) {
+    uint8_t latin1Table[256];
+    const uint8_t *table = NULL;
+
+    if (!backwards) {
+        CFIndex idx = 0;
+        while (idx < length) {
+            if (NULL != table) {
+                if ((idx + 8 <= length) && __CFCharacterSetLatin1TableSkipsEight(table, characters, idx)) {
+                    idx += 8;
+                    continue;
+                }
+            } else if (idx >= __kCFCharacterSetLatin1TableThreshold) {
+                __CFCharacterSetInlineBufferFillLatin1Table(buffer, findNonMembers, latin1Table);
+                table = latin1Table;
+                continue;
+            }
+
+            UTF32Char character = characters[idx];
+            CFIndex used = 1;
+            bool isMember;
+            if (CFUniCharIsSurrogateHighCharacter(character) && (idx + 1 < length) && CFUniCharIsSurrogateLowCharacter(characters[idx + 1])) {
+                isMember = CFCharacterSetInlineBufferIsLongCharacterMember(buffer, CFUniCharGetLongCharacterForSurrogatePair(character, characters[idx + 1]));
+                used = 2;
+            } else if ((character >= 0xD800) && (character <= 0xDFFF)) {
+                isMember = false; // Unpaired surrogates are never members
+            } else {
+                isMember = __CFCharacterSetInlineBufferIsMember(buffer, table, character, findNonMembers);
+            }
+            if (isMember != findNonMembers) return CFRangeMake(idx, used);
+            idx += used;
+        }
+    } else {
+        CFIndex idx = length;
+        while (idx > 0) {
+            if (NULL != table) {
+                if ((idx >= 8) && __CFCharacterSetLatin1TableSkipsEight(table, characters, idx - 8)) {
+                    idx -= 8;
+                    continue;
+                }
+            } else if (length - idx >= __kCFCharacterSetLatin1TableThreshold) {
+                __CFCharacterSetInlineBufferFillLatin1Table(buffer, findNonMembers, latin1Table);
+                table = latin1Table;
+                continue;
+            }
+
+            UTF32Char character = characters[idx - 1];
+            CFIndex used = 1;
+            bool isMember;
+            if (CFUniCharIsSurrogateLowCharacter(character) && (idx > 1) && CFUniCharIsSurrogateHighCharacter(characters[idx - 2])) {
+                isMember = CFCharacterSetInlineBufferIsLongCharacterMember(buffer, CFUniCharGetLongCharacterForSurrogatePair(characters[idx - 2], character));
+                used = 2;
+            } else if ((character >= 0xD800) && (character <= 0xDFFF)) {
+                isMember = false;
+            } else {
+                isMember = __CFCharacterSetInlineBufferIsMember(buffer, table, character, findNonMembers);
+            }
+            idx -= used;
+            if (isMember != findNonMembers) return CFRangeMake(idx, used);
+        }
+    }
+    return CFRangeMake(kCFNotFound, 0);
+}
+
 #if DEPLOYMENT_RUNTIME_SWIFT
 CFIndex __CFCharDigitValue(UniChar ch) {
     return u_charDigitValue(ch);
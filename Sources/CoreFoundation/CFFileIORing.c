@@ -0,0 +1,309 @@
+/*	CFFileIORing.c
+	Copyright (c) 2024, Apple Inc. and the Swift project authors
+
+	Portions Copyright (c) 2024, Apple Inc. and the Swift project authors
+	Licensed under Apache License v2.0 with Runtime Library Exception
+	See http://swift.org/LICENSE.txt for license information
+	See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+*/
+
+#include "CFInternal.h"
+#include "ForSwiftFoundationOnly.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if TARGET_OS_LINUX && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+// The rings are driven with the raw system calls so that Foundation does not pick up a dependency on liburing.
+// Reads and writes use IORING_OP_READ/WRITE, which arrived in Linux 5.6 together with IORING_FEAT_RW_CUR_POS;
+// kernels without that feature are treated as not supporting io_uring at all.
+#if TARGET_OS_LINUX && __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup) && defined(IORING_FEAT_RW_CUR_POS)
+
+struct _CFFileIORing {
+    int fd;
+    unsigned sqEntries;
+    unsigned cqEntries;
+
+    void *sqRing;
+    size_t sqRingSize;
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned sqMask;
+    unsigned *sqArray;
+    struct io_uring_sqe *sqes;
+    size_t sqesSize;
+    // Entries up to here have been filled in; entries up to `sqSubmitted` have been handed to the kernel.
+    unsigned sqPrepared;
+    unsigned sqSubmitted;
+
+    void *cqRing;
+    size_t cqRingSize;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned cqMask;
+    struct io_uring_cqe *cqes;
+};
+
+_CFFileIORingRef _Nullable _CFFileIORingCreate(unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+        return NULL;
+    }
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+        close(fd);
+        errno = ENOSYS;
+        return NULL;
+    }
+
+    struct _CFFileIORing *ring = calloc(1, sizeof(struct _CFFileIORing));
+    if (!ring) {
+        close(fd);
+        errno = ENOMEM;
+        return NULL;
+    }
+    ring->fd = fd;
+    ring->sqEntries = params.sq_entries;
+    ring->cqEntries = params.cq_entries;
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMapping) {
+        ring->sqRingSize = ring->cqRingSize = __CFMax(ring->sqRingSize, ring->cqRingSize);
+    }
+
+    ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->sqRing == MAP_FAILED) {
+        goto fail;
+    }
+    if (singleMapping) {
+        ring->cqRing = ring->sqRing;
+    } else {
+        ring->cqRing = mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (ring->cqRing == MAP_FAILED) {
+            ring->cqRing = NULL;
+            goto fail;
+        }
+    }
+    ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = NULL;
+        goto fail;
+    }
+
+    char *sq = ring->sqRing;
+    ring->sqHead = (unsigned *)(sq + params.sq_off.head);
+    ring->sqTail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sqMask = *(unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sqArray = (unsigned *)(sq + params.sq_off.array);
+    ring->sqPrepared = ring->sqSubmitted = *ring->sqTail;
+
+    char *cq = ring->cqRing;
+    ring->cqHead = (unsigned *)(cq + params.cq_off.head);
+    ring->cqTail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cqMask = *(unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    return ring;
+
+fail:;
+    int savedErrno = errno;
+    if (ring->sqRing && ring->sqRing != MAP_FAILED) munmap(ring->sqRing, ring->sqRingSize);
+    if (ring->cqRing && ring->cqRing != ring->sqRing) munmap(ring->cqRing, ring->cqRingSize);
+    close(fd);
+    free(ring);
+    errno = savedErrno;
+    return NULL;
+}
+
+void _CFFileIORingDestroy(_CFFileIORingRef ring) {
+    munmap(ring->sqes, ring->sqesSize);
+    if (ring->cqRing != ring->sqRing) {
+        munmap(ring->cqRing, ring->cqRingSize);
+    }
+    munmap(ring->sqRing, ring->sqRingSize);
+    close(ring->fd);
+    free(ring);
+}
+
+unsigned _CFFileIORingGetCompletionQueueCapacity(_CFFileIORingRef ring) {
+    return ring->cqEntries;
+}
+
+int _CFFileIORingRegisterBuffers(_CFFileIORingRef ring, void *base, size_t bufferSize, unsigned count) {
+    struct iovec *buffers = calloc(count, sizeof(struct iovec));
+    if (!buffers) {
+        return ENOMEM;
+    }
+    for (unsigned i = 0; i < count; i++) {
+        buffers[i].iov_base = (char *)base + i * bufferSize;
+        buffers[i].iov_len = bufferSize;
+    }
+    int result = 0;
+    if (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, buffers, count) < 0) {
+        result = errno;
+    }
+    free(buffers);
+    return result;
+}
+
+static struct io_uring_sqe *_Nullable __CFFileIORingNextEntry(_CFFileIORingRef ring, int fd, uint64_t userData) {
+    unsigned head = __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+    if (ring->sqPrepared - head >= ring->sqEntries) {
+        return NULL;
+    }
+    unsigned index = ring->sqPrepared & ring->sqMask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = fd;
+    sqe->user_data = userData;
+    ring->sqArray[index] = index;
+    ring->sqPrepared++;
+    return sqe;
+}
+
+static bool __CFFileIORingPrepareTransfer(_CFFileIORingRef ring, uint8_t opcode, uint8_t fixedOpcode, int fd, const void *buffer, unsigned length, int64_t offset, int bufferIndex, uint64_t userData) {
+    struct io_uring_sqe *sqe = __CFFileIORingNextEntry(ring, fd, userData);
+    if (!sqe) {
+        return false;
+    }
+    sqe->opcode = bufferIndex >= 0 ? fixedOpcode : opcode;
+    sqe->addr = (uint64_t)(uintptr_t)buffer;
+    sqe->len = length;
+    // An offset of -1 reads or writes at the file position and advances it, like read() and write().
+    sqe->off = (uint64_t)offset;
+    if (bufferIndex >= 0) {
+        sqe->buf_index = (uint16_t)bufferIndex;
+    }
+    return true;
+}
+
+bool _CFFileIORingPrepareRead(_CFFileIORingRef ring, int fd, void *buffer, unsigned length, int64_t offset, int bufferIndex, uint64_t userData) {
+    return __CFFileIORingPrepareTransfer(ring, IORING_OP_READ, IORING_OP_READ_FIXED, fd, buffer, length, offset, bufferIndex, userData);
+}
+
+bool _CFFileIORingPrepareWrite(_CFFileIORingRef ring, int fd, const void *buffer, unsigned length, int64_t offset, int bufferIndex, uint64_t userData) {
+    return __CFFileIORingPrepareTransfer(ring, IORING_OP_WRITE, IORING_OP_WRITE_FIXED, fd, buffer, length, offset, bufferIndex, userData);
+}
+
+bool _CFFileIORingPrepareFsync(_CFFileIORingRef ring, int fd, bool dataOnly, uint64_t userData) {
+    struct io_uring_sqe *sqe = __CFFileIORingNextEntry(ring, fd, userData);
+    if (!sqe) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fsync_flags = dataOnly ? IORING_FSYNC_DATASYNC : 0;
+    return true;
+}
+
+int _CFFileIORingSubmit(_CFFileIORingRef ring) {
+    __atomic_store_n(ring->sqTail, ring->sqPrepared, __ATOMIC_RELEASE);
+    while (ring->sqSubmitted != ring->sqPrepared) {
+        unsigned count = ring->sqPrepared - ring->sqSubmitted;
+        long result = syscall(__NR_io_uring_enter, ring->fd, count, 0, 0, NULL, 0);
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            return errno;
+        }
+        // Taking none of the entries is a refusal like EAGAIN; asking again straight away would only spin.
+        if (result == 0) return EAGAIN;
+        ring->sqSubmitted += (unsigned)result;
+    }
+    return 0;
+}
+
+unsigned _CFFileIORingGetUnsubmittedCount(_CFFileIORingRef ring) {
+    return ring->sqPrepared - ring->sqSubmitted;
+}
+
+unsigned _CFFileIORingDiscardUnsubmitted(_CFFileIORingRef ring) {
+    // The kernel only reads the submission queue inside io_uring_enter(), which the caller serializes with this.
+    unsigned count = ring->sqPrepared - ring->sqSubmitted;
+    ring->sqPrepared = ring->sqSubmitted;
+    __atomic_store_n(ring->sqTail, ring->sqSubmitted, __ATOMIC_RELEASE);
+    return count;
+}
+
+int _CFFileIORingWaitForCompletion(_CFFileIORingRef ring) {
+    while (__atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE) == *ring->cqHead) {
+        if (syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR) {
+            return errno;
+        }
+    }
+    return 0;
+}
+
+unsigned _CFFileIORingCopyCompletions(_CFFileIORingRef ring, uint64_t *userData, int32_t *results, unsigned maximum) {
+    unsigned head = *ring->cqHead;
+    unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+    unsigned count = 0;
+    while (head != tail && count < maximum) {
+        struct io_uring_cqe *cqe = &ring->cqes[head & ring->cqMask];
+        userData[count] = cqe->user_data;
+        results[count] = cqe->res;
+        head++;
+        count++;
+    }
+    __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+    return count;
+}
+
+#else
+
+_CFFileIORingRef _Nullable _CFFileIORingCreate(unsigned entries) {
+    errno = ENOSYS;
+    return NULL;
+}
+
+void _CFFileIORingDestroy(_CFFileIORingRef ring) { }
+
+unsigned _CFFileIORingGetCompletionQueueCapacity(_CFFileIORingRef ring) {
+    return 0;
+}
+
+int _CFFileIORingRegisterBuffers(_CFFileIORingRef ring, void *base, size_t bufferSize, unsigned count) {
+    return ENOSYS;
+}
+
+bool _CFFileIORingPrepareRead(_CFFileIORingRef ring, int fd, void *buffer, unsigned length, int64_t offset, int bufferIndex, uint64_t userData) {
+    return false;
+}
+
+bool _CFFileIORingPrepareWrite(_CFFileIORingRef ring, int fd, const void *buffer, unsigned length, int64_t offset, int bufferIndex, uint64_t userData) {
+    return false;
+}
+
+bool _CFFileIORingPrepareFsync(_CFFileIORingRef ring, int fd, bool dataOnly, uint64_t userData) {
+    return false;
+}
+
+int _CFFileIORingSubmit(_CFFileIORingRef ring) {
+    return ENOSYS;
+}
+
+unsigned _CFFileIORingGetUnsubmittedCount(_CFFileIORingRef ring) {
+    return 0;
+}
+
+unsigned _CFFileIORingDiscardUnsubmitted(_CFFileIORingRef ring) {
+    return 0;
+}
+
+int _CFFileIORingWaitForCompletion(_CFFileIORingRef ring) {
+    return ENOSYS;
+}
+
+unsigned _CFFileIORingCopyCompletions(_CFFileIORingRef ring, uint64_t *userData, int32_t *results, unsigned maximum) {
+    return 0;
+}
+
+#endif
@@ -2355,6 +2355,10 @@ CF_EXPORT int _CFPosixSpawnFileActionsChdir(_CFPosixSpawnFileActionsRef file_act
   return ENOSYS;
 }
 
+CF_EXPORT int _CFPosixSpawnFileActionsAddCloseFrom(_CFPosixSpawnFileActionsRef file_actions, int lowfiledes) {
+  return ENOSYS;
+}
+
 CF_EXPORT int _CFPosixSpawn(pid_t *_CF_RESTRICT pid, const char *_CF_RESTRICT path, _CFPosixSpawnFileActionsRef file_actions, _CFPosixSpawnAttrRef _Nullable _CF_RESTRICT attrp, char *_Nullable const argv[_Nullable _CF_RESTRICT], char *_Nullable const envp[_Nullable _CF_RESTRICT]) {
     _CFPosixSpawnInitialize();
     return _CFPosixSpawnImpl(pid, path, file_actions, attrp, argv, envp);
@@ -2445,6 +2449,17 @@ CF_EXPORT int _CFPosixSpawnFileActionsChdir(_CFPosixSpawnFileActionsRef file_act
   #endif
 }
 
+CF_EXPORT int _CFPosixSpawnFileActionsAddCloseFrom(_CFPosixSpawnFileActionsRef file_actions, int lowfiledes) {
+  #if defined(__GLIBC__) && __GLIBC_PREREQ(2, 34)
+  // Glibc 2.34 (August 2021) closes the descriptors in the child with close_range(2) where the kernel
+  // provides it, instead of the caller having to enumerate and close every open descriptor.
+  return posix_spawn_file_actions_addclosefrom_np((posix_spawn_file_actions_t *)file_actions, lowfiledes);
+  #else
+  // Callers fall back to adding a close action for each open descriptor.
+  return ENOSYS;
+  #endif
+}
+
 CF_EXPORT int _CFPosixSpawn(pid_t *_CF_RESTRICT pid, const char *_CF_RESTRICT path, _CFPosixSpawnFileActionsRef file_actions, _CFPosixSpawnAttrRef _Nullable _CF_RESTRICT attrp, char *_Nullable const argv[_Nullable _CF_RESTRICT], char *_Nullable const envp[_Nullable _CF_RESTRICT]) {
   return posix_spawn(pid, path, (posix_spawn_file_actions_t *)file_actions, (posix_spawnattr_t *)attrp, argv, envp);
 }
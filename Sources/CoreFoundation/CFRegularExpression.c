@@ -19,16 +19,53 @@
 
 #define STACK_BUFFER_SIZE 256
 
+#define MAX_FAST_PATH_ALTERNATIVES 32
+
+// Patterns simple enough to be matched without ICU, directly on the bytes of an 8-bit or ASCII string. None of
+// them has capture groups, and none can match the empty string.
+typedef enum {
+    __CFRegexFastPathLiteral,           // a literal string, such as "foo\.bar"
+    __CFRegexFastPathAlternation,       // literal strings tried in order at each position, such as "GET|HEAD|POST"
+    __CFRegexFastPathCharacterClass,    // one character from a set of ASCII characters, or a run of them with "+"
+} __CFRegexFastPathKind;
+
+struct __CFRegexFastPath {
+    __CFRegexFastPathKind kind;
+    Boolean repeats;
+    uint8_t firstBytes[32];     // Bitmap of the bytes a match can start with; for a character class, the class itself
+    CFIndex count;
+    CFIndex offsets[MAX_FAST_PATH_ALTERNATIVES + 1];    // Literal i is bytes[offsets[i]] up to bytes[offsets[i + 1]]
+    uint8_t bytes[];
+};
+
 struct ___CFRegularExpression {
     CFRuntimeBase _base;
     CFStringRef pattern;
     _CFRegularExpressionOptions options;
     URegularExpression *regex;
     int32_t _checkout;
+    // Clones of regex for callers that find it checked out, kept between matches instead of being closed.
+    // A clone is taken by swapping NULL into its slot and given back by swapping it into an empty slot, so
+    // concurrent matches never wait for each other. When every slot is full, returned clones are closed.
+    CFIndex _poolSize;
+    _Atomic(URegularExpression *) *_pool;
+    _Atomic(int64_t) _cloneCount;
+    _Atomic(int64_t) _reuseCount;
+    struct __CFRegexFastPath *_fastPath; // NULL unless the pattern can be matched without ICU
 };
 
+#define MAX_MATCHER_POOL_SIZE 64
+
 static void ___CFRegularExpressionDeallocate(CFTypeRef cf) {
     struct ___CFRegularExpression *item = (struct ___CFRegularExpression *)cf;
+    if (item->_pool) {
+        for (CFIndex idx = 0; idx < item->_poolSize; idx++) {
+            URegularExpression *pooled = atomic_load(&item->_pool[idx]);
+            if (pooled) uregex_close(pooled);
+        }
+        free(item->_pool);
+    }
+    if (item->_fastPath) free(item->_fastPath);
     if (item->regex) uregex_close(item->regex);
     if (item->pattern) CFRelease(item->pattern);
 }
@@ -90,6 +127,181 @@ CFStringRef _CFRegularExpressionCreateEscapedPattern(CFStringRef pattern) {
     return CFRetain(pattern);
 }
 
+CF_INLINE void __CFRegexFastPathAddByte(uint8_t *bitmap, uint8_t byte) {
+    bitmap[byte >> 3] |= (uint8_t)(1 << (byte & 7));
+}
+
+CF_INLINE Boolean __CFRegexFastPathHasByte(const uint8_t *bitmap, uint8_t byte) {
+    return (bitmap[byte >> 3] & (1 << (byte & 7))) != 0;
+}
+
+// The character an escape such as "\." or "\t" stands for, or 0 if the escape means something else to ICU.
+static UniChar __CFRegexFastPathEscapedCharacter(UniChar c) {
+    switch (c) {
+        case 't': return '\t';
+        case 'n': return '\n';
+        case 'r': return '\r';
+        case 'f': return '\f';
+        case 'e': return 0x1B;
+        default:
+            if (c > 0x20 && c < 0x7F && !(c >= '0' && c <= '9') && !(c >= 'a' && c <= 'z') && !(c >= 'A' && c <= 'Z')) return c;
+            return 0;
+    }
+}
+
+// Parses "[...]", "[...]+", "\d" and "\d+" where the set only lists ASCII characters and ranges. Negated sets,
+// properties, nested sets and set operations are left to ICU.
+static Boolean __CFRegexFastPathParseCharacterClass(const UniChar *pattern, CFIndex length, struct __CFRegexFastPath *fastPath) {
+    CFIndex idx = 0;
+    if (length >= 2 && pattern[0] == '\\' && pattern[1] == 'd') {
+        for (uint8_t digit = '0'; digit <= '9'; digit++) __CFRegexFastPathAddByte(fastPath->firstBytes, digit);
+        idx = 2;
+    } else if (length >= 1 && pattern[0] == '[') {
+        Boolean closed = false;
+        idx = 1;
+        if (idx < length && (pattern[idx] == '^' || pattern[idx] == ']' || pattern[idx] == ':')) return false;
+        while (idx < length) {
+            UniChar c = pattern[idx++];
+            if (c == ']') {
+                closed = true;
+                break;
+            }
+            if (c >= 0x80 || c == '[' || c == '&' || c == '$' || c == '{' || c == '}') return false;
+            if (c == '-' && idx < length && pattern[idx] == '-') return false;
+            if (c == '\\') {
+                if (idx == length) return false;
+                UniChar escaped = pattern[idx++];
+                if (escaped == 'd') {
+                    for (uint8_t digit = '0'; digit <= '9'; digit++) __CFRegexFastPathAddByte(fastPath->firstBytes, digit);
+                    continue;
+                }
+                c = __CFRegexFastPathEscapedCharacter(escaped);
+                if (c == 0) return false;
+            }
+            if (idx + 1 < length && pattern[idx] == '-' && pattern[idx + 1] != ']') {
+                UniChar last = pattern[idx + 1];
+                idx += 2;
+                if (last == '\\') {
+                    if (idx == length) return false;
+                    last = __CFRegexFastPathEscapedCharacter(pattern[idx++]);
+                    if (last == 0) return false;
+                } else if (last >= 0x80 || last == '[' || last == '&' || last == '$' || last == '{' || last == '}') {
+                    return false;
+                }
+                if (last < c) return false;
+                for (UniChar member = c; member <= last; member++) __CFRegexFastPathAddByte(fastPath->firstBytes, (uint8_t)member);
+                continue;
+            }
+            __CFRegexFastPathAddByte(fastPath->firstBytes, (uint8_t)c);
+        }
+        if (!closed) return false;
+    } else {
+        return false;
+    }
+    if (idx < length && pattern[idx] == '+') {
+        fastPath->repeats = true;
+        idx++;
+    }
+    if (idx != length) return false;
+    fastPath->kind = __CFRegexFastPathCharacterClass;
+    return true;
+}
+
+// Returns NULL for patterns that need ICU: anything but a literal, an alternation of literals or a simple
+// character class, or any pattern compiled with options that change how literals match.
+static struct __CFRegexFastPath *__CFRegexFastPathCreate(const UniChar *pattern, CFIndex length, _CFRegularExpressionOptions options) {
+    if ((options & (_kCFRegularExpressionCaseInsensitive | _kCFRegularExpressionAllowCommentsAndWhitespace)) != 0 || length == 0) return NULL;
+    struct __CFRegexFastPath *fastPath = (struct __CFRegexFastPath *)calloc(1, sizeof(struct __CFRegexFastPath) + length);
+    if (!fastPath) return NULL;
+    if (__CFRegexFastPathParseCharacterClass(pattern, length, fastPath)) return fastPath;
+    memset(fastPath->firstBytes, 0, sizeof(fastPath->firstBytes));
+    fastPath->repeats = false;
+
+    CFIndex idx = 0, used = 0;
+    while (true) {
+        CFIndex start = used;
+        while (idx < length && pattern[idx] != '|') {
+            UniChar c = pattern[idx++];
+            if (c == '\\') {
+                if (idx == length) goto fail;
+                c = __CFRegexFastPathEscapedCharacter(pattern[idx++]);
+                if (c == 0) goto fail;
+            } else if (c == 0 || c >= 0x80 || strchr("^$.?*+()[]{}", (int)c) != NULL) {
+                goto fail;
+            }
+            fastPath->bytes[used++] = (uint8_t)c;
+        }
+        // An empty alternative would match the empty string.
+        if (used == start || fastPath->count == MAX_FAST_PATH_ALTERNATIVES) goto fail;
+        __CFRegexFastPathAddByte(fastPath->firstBytes, fastPath->bytes[start]);
+        fastPath->count++;
+        fastPath->offsets[fastPath->count] = used;
+        if (idx == length) break;
+        idx++;
+    }
+    fastPath->kind = fastPath->count == 1 ? __CFRegexFastPathLiteral : __CFRegexFastPathAlternation;
+    return fastPath;
+
+fail:
+    free(fastPath);
+    return NULL;
+}
+
+// Compares literal `index` with the text at `position`. A literal that runs past `end` but matches up to it sets
+// *hitEnd, like ICU does when a match attempt needs more input than the range has.
+CF_INLINE Boolean __CFRegexFastPathMatchesLiteral(const struct __CFRegexFastPath *fastPath, CFIndex index, const uint8_t *text, CFIndex position, CFIndex end, CFIndex *matchEnd, Boolean *hitEnd) {
+    const uint8_t *literal = fastPath->bytes + fastPath->offsets[index];
+    CFIndex literalLength = fastPath->offsets[index + 1] - fastPath->offsets[index];
+    CFIndex available = end - position;
+    if (available >= literalLength) {
+        if (memcmp(text + position, literal, literalLength) == 0) {
+            *matchEnd = position + literalLength;
+            return true;
+        }
+    } else if (memcmp(text + position, literal, available) == 0) {
+        *hitEnd = true;
+    }
+    return false;
+}
+
+// Returns the start of the first match in text[from..<end] and sets *matchEnd, or returns kCFNotFound.
+static CFIndex __CFRegexFastPathFind(const struct __CFRegexFastPath *fastPath, const uint8_t *text, CFIndex from, CFIndex end, CFIndex *matchEnd, Boolean *hitEnd) {
+    switch (fastPath->kind) {
+        case __CFRegexFastPathLiteral: {
+            CFIndex position = from;
+            while (position < end) {
+                const uint8_t *candidate = (const uint8_t *)memchr(text + position, fastPath->bytes[0], end - position);
+                if (!candidate) break;
+                position = candidate - text;
+                if (__CFRegexFastPathMatchesLiteral(fastPath, 0, text, position, end, matchEnd, hitEnd)) return position;
+                position++;
+            }
+            break;
+        }
+        case __CFRegexFastPathAlternation:
+            for (CFIndex position = from; position < end; position++) {
+                if (!__CFRegexFastPathHasByte(fastPath->firstBytes, text[position])) continue;
+                for (CFIndex index = 0; index < fastPath->count; index++) {
+                    if (__CFRegexFastPathMatchesLiteral(fastPath, index, text, position, end, matchEnd, hitEnd)) return position;
+                }
+            }
+            break;
+        case __CFRegexFastPathCharacterClass:
+            for (CFIndex position = from; position < end; position++) {
+                if (!__CFRegexFastPathHasByte(fastPath->firstBytes, text[position])) continue;
+                CFIndex last = position + 1;
+                if (fastPath->repeats) {
+                    while (last < end && __CFRegexFastPathHasByte(fastPath->firstBytes, text[last])) last++;
+                    if (last == end) *hitEnd = true;
+                }
+                *matchEnd = last;
+                return position;
+            }
+            break;
+    }
+    return kCFNotFound;
+}
+
 _CFRegularExpressionRef _CFRegularExpressionCreate(CFAllocatorRef allocator, CFStringRef pattern, _CFRegularExpressionOptions options, CFErrorRef *errorPtr) {
     UniChar stackBuffer[STACK_BUFFER_SIZE], *patternBuffer = NULL;
     Boolean freePatternBuffer = false;
@@ -155,6 +367,12 @@ _CFRegularExpressionRef _CFRegularExpressionCreate(CFAllocatorRef allocator, CFS
     struct ___CFRegularExpression *regexObj = __CFRegularExpressionCreate(allocator);
     regexObj->regex = regex;
     regexObj->options = options;
+    // One matcher per processor covers a regex shared by every thread of a worker pool.
+    regexObj->_poolSize = __CFMin(__CFMax(__CFActiveProcessorCount(), 1), MAX_MATCHER_POOL_SIZE);
+    regexObj->_pool = (_Atomic(URegularExpression *) *)calloc(regexObj->_poolSize, sizeof(_Atomic(URegularExpression *)));
+    if (!regexObj->_pool) HALT;
+    regexObj->_fastPath = __CFRegexFastPathCreate(patternBuffer, patternLength, options);
+    if (freePatternBuffer) free(patternBuffer);
     if (pattern != originalPattern) {
         regexObj->pattern = pattern;
     } else if (pattern != NULL) {
@@ -229,16 +447,27 @@ static UBool regexFindProgressCallback(const void *context, int64_t matchIndex)
     return stop ? 0 : 1;
 }
 
-CF_INLINE URegularExpression *checkOutRegularExpression(void *internal, int32_t *checkout, Boolean *checkedOutRegex) {
+CF_INLINE URegularExpression *checkOutRegularExpression(struct ___CFRegularExpression *regexObj, Boolean *checkedOutRegex) {
     URegularExpression *regex = NULL;
     UErrorCode errorCode = U_ZERO_ERROR;
     Boolean checkedOut = false;
-    checkedOut = OSAtomicCompareAndSwap32Barrier(0, 1, (volatile int32_t *)checkout);
+    checkedOut = OSAtomicCompareAndSwap32Barrier(0, 1, (volatile int32_t *)&regexObj->_checkout);
     if (checkedOut) {
-        regex = (URegularExpression *)internal;
+        regex = regexObj->regex;
     } else {
-        regex = uregex_clone((const URegularExpression *)internal, &errorCode);
+        for (CFIndex idx = 0; idx < regexObj->_poolSize && !regex; idx++) {
+            if (atomic_load_explicit(&regexObj->_pool[idx], memory_order_relaxed)) {
+                regex = atomic_exchange_explicit(&regexObj->_pool[idx], NULL, memory_order_acquire);
+            }
+        }
+        if (!regex) {
+            atomic_fetch_add_explicit(&regexObj->_cloneCount, 1, memory_order_relaxed);
+            regex = uregex_clone(regexObj->regex, &errorCode);
+            *checkedOutRegex = false;
+            return regex;
+        }
     }
+    atomic_fetch_add_explicit(&regexObj->_reuseCount, 1, memory_order_relaxed);
     *checkedOutRegex = checkedOut;
     return regex;
 }
@@ -254,7 +483,7 @@ static UBool regexMatchCallback(const void *context, int32_t steps) {
 }
 
 
-CF_INLINE URegularExpression *prepareRegularExpression(void *internal, int32_t *checkout, CFStringRef string, CFRange range, UniChar *stackBuffer, const void *context, Boolean reportProgress, Boolean anchored, Boolean transparentBounds, Boolean nonAnchoringBounds, CFIndex *offset, void **bufferToFree, void **utextToFree, Boolean *checkedOutRegex) {
+CF_INLINE URegularExpression *prepareRegularExpression(struct ___CFRegularExpression *regexObj, CFStringRef string, CFRange range, UniChar *stackBuffer, const void *context, Boolean reportProgress, Boolean anchored, Boolean transparentBounds, Boolean nonAnchoringBounds, CFIndex *offset, void **bufferToFree, void **utextToFree, Boolean *checkedOutRegex) {
     // ??? consider reusing utext
     URegularExpression *regex = NULL;
     CFIndex length = CFStringGetLength(string);
@@ -308,7 +537,8 @@ CF_INLINE URegularExpression *prepareRegularExpression(void *internal, int32_t *
     }
     
     if (stringBuffer) {
-        regex = checkOutRegularExpression(internal, checkout, checkedOutRegex);
+        regex = checkOutRegularExpression(regexObj, checkedOutRegex);
+        if (!regex) return NULL;
         uregex_setText(regex, (const UChar *)stringBuffer, textLength, &errorCode);
     }
     
@@ -325,6 +555,12 @@ CF_INLINE URegularExpression *prepareRegularExpression(void *internal, int32_t *
             if (reportProgress || anchored) uregex_setFindProgressCallback(regex, NULL, NULL, &errorCode);
             if (transparentBounds) uregex_useTransparentBounds(regex, 0, &errorCode);
             if (nonAnchoringBounds) uregex_useAnchoringBounds(regex, 1, &errorCode);
+            if (*checkedOutRegex) {
+                OSMemoryBarrier();
+                regexObj->_checkout = 0;
+            } else {
+                uregex_close(regex);
+            }
             regex = NULL;
         }
     }
@@ -344,25 +580,87 @@ CF_INLINE _CFRegularExpressionMatchingFlags flagsForRegularExpression(URegularEx
 }
 
 
-CF_INLINE void returnRegularExpression(URegularExpression *regex, int32_t *checkout, Boolean checkedOutRegex, Boolean reportProgress, Boolean anchored, Boolean transparentBounds, Boolean nonAnchoringBounds, UniChar *stackBuffer, void *bufferToFree, void *utextToFree) {
+CF_INLINE void returnRegularExpression(URegularExpression *regex, struct ___CFRegularExpression *regexObj, Boolean checkedOutRegex, Boolean reportProgress, Boolean anchored, Boolean transparentBounds, Boolean nonAnchoringBounds, UniChar *stackBuffer, void *bufferToFree, void *utextToFree) {
     UErrorCode errorCode = U_ZERO_ERROR;
     if (regex) {
+        uregex_setText(regex, (const UChar *)stackBuffer, 0, &errorCode);
+        if (reportProgress) uregex_setMatchCallback(regex, NULL, NULL, &errorCode);
+        if (reportProgress || anchored) uregex_setFindProgressCallback(regex, NULL, NULL, &errorCode);
+        if (transparentBounds) uregex_useTransparentBounds(regex, 0, &errorCode);
+        if (nonAnchoringBounds) uregex_useAnchoringBounds(regex, 1, &errorCode);
         if (checkedOutRegex) {
-            uregex_setText(regex, (const UChar *)stackBuffer, 0, &errorCode);
-            if (reportProgress) uregex_setMatchCallback(regex, NULL, NULL, &errorCode);
-            if (reportProgress || anchored) uregex_setFindProgressCallback(regex, NULL, NULL, &errorCode);
-            if (transparentBounds) uregex_useTransparentBounds(regex, 0, &errorCode);
-            if (nonAnchoringBounds) uregex_useAnchoringBounds(regex, 1, &errorCode);
             OSMemoryBarrier();
-            *checkout = 0;
+            regexObj->_checkout = 0;
         } else {
-            uregex_close(regex);
+            Boolean pooled = false;
+            for (CFIndex idx = 0; idx < regexObj->_poolSize && !pooled; idx++) {
+                URegularExpression *expected = NULL;
+                pooled = atomic_compare_exchange_strong_explicit(&regexObj->_pool[idx], &expected, regex, memory_order_release, memory_order_relaxed);
+            }
+            if (!pooled) uregex_close(regex);
         }
     }
     if (bufferToFree) free(bufferToFree);
 }
 
+// Matches a fast-path pattern against the bytes of the string, without converting it to UTF-16. Returns false,
+// having reported nothing, if the string is neither stored in 8 bits nor ASCII, or if the options need ICU.
+static Boolean __CFRegularExpressionEnumerateFastPathMatches(const struct __CFRegexFastPath *fastPath, CFStringRef string, _CFRegularExpressionMatchingOptions options, CFRange range, void *matchContext, _CFRegularExpressionMatch match) {
+    if ((options & (_kCFRegularExpressionMatchingReportProgress | _kCFRegularExpressionMatchingAnchored)) != 0) return false;
+    if (range.location < 0 || range.length < 0 || range.location + range.length > CFStringGetLength(string)) return false;
+
+    // In an 8-bit string every byte is one UTF-16 unit, and the bytes a pattern can match are all ASCII.
+    uint8_t stackBuffer[STACK_BUFFER_SIZE * sizeof(UniChar)];
+    uint8_t *bufferToFree = NULL;
+    const uint8_t *text = (const uint8_t *)CFStringGetCStringPtr(string, kCFStringEncodingISOLatin1);
+    CFIndex base = 0;
+    if (!text) {
+        uint8_t *buffer = stackBuffer;
+        if (range.length > (CFIndex)sizeof(stackBuffer)) {
+            buffer = bufferToFree = (uint8_t *)malloc(range.length);
+            if (!buffer) return false;
+        }
+        if (CFStringGetBytes(string, range, kCFStringEncodingASCII, 0, false, buffer, range.length, NULL) != range.length) {
+            if (bufferToFree) free(bufferToFree);
+            return false;
+        }
+        text = buffer;
+        base = range.location;
+    }
+
+    Boolean omitResult = ((options & _kCFRegularExpressionMatchingOmitResult) != 0);
+    Boolean stop = false, hitEnd = false;
+    CFIndex from = range.location - base, end = range.location + range.length - base;
+    while (!stop) {
+        CFIndex matchEnd = 0;
+        hitEnd = false;
+        CFIndex start = __CFRegexFastPathFind(fastPath, text, from, end, &matchEnd, &hitEnd);
+        if (start == kCFNotFound) {
+            // A search that finds nothing has looked at everything up to the end of the range.
+            hitEnd = true;
+            break;
+        }
+        _CFRegularExpressionMatchingFlags flags = hitEnd ? _kCFRegularExpressionMatchingHitEnd : 0;
+        if (omitResult) {
+            match(matchContext, NULL, 0, flags, &stop);
+        } else {
+            CFRange matchedRange = CFRangeMake(base + start, matchEnd - start);
+            match(matchContext, &matchedRange, 1, flags, &stop);
+        }
+        from = matchEnd;
+    }
+    if ((options & _kCFRegularExpressionMatchingReportCompletion) != 0 && !stop) {
+        _CFRegularExpressionMatchingFlags flags = _kCFRegularExpressionMatchingCompleted | (hitEnd ? _kCFRegularExpressionMatchingHitEnd : 0);
+        match(matchContext, NULL, 0, flags, &stop);
+    }
+    if (bufferToFree) free(bufferToFree);
+    return true;
+}
+
 void _CFRegularExpressionEnumerateMatchesInString(_CFRegularExpressionRef regexObj, CFStringRef string, _CFRegularExpressionMatchingOptions options, CFRange range, void *matchContext, _CFRegularExpressionMatch match) {
+    if (regexObj->_fastPath && __CFRegularExpressionEnumerateFastPathMatches(regexObj->_fastPath, string, options, range, matchContext, match)) {
+        return;
+    }
     URegularExpression *regex = NULL;
     UniChar stackBuffer[STACK_BUFFER_SIZE];
     void *bufferToFree = NULL, *utextToFree = NULL;
@@ -386,7 +684,7 @@ void _CFRegularExpressionEnumerateMatchesInString(_CFRegularExpressionRef regexO
     context.stoppedByClient = NO;
     context.hitAnchorLimit = NO;
     
-    regex = prepareRegularExpression(regexObj->regex, (int32_t *)&regexObj->_checkout, string, range, stackBuffer, (const void *)&context, reportProgress, anchored, transparentBounds, nonAnchoringBounds, &offset, &bufferToFree, &utextToFree, &checkedOutRegex);
+    regex = prepareRegularExpression((struct ___CFRegularExpression *)regexObj, string, range, stackBuffer, (const void *)&context, reportProgress, anchored, transparentBounds, nonAnchoringBounds, &offset, &bufferToFree, &utextToFree, &checkedOutRegex);
     CFIndex numberOfCaptureGroups = _CFRegularExpressionGetNumberOfCaptureGroups(regexObj);
     if (regex) {
         while (uregex_findNext(regex, &errorCode) && U_SUCCESS(errorCode) && !stop && !context.stoppedByClient && !context.hitAnchorLimit) {
@@ -441,7 +739,7 @@ void _CFRegularExpressionEnumerateMatchesInString(_CFRegularExpressionRef regexO
         match(matchContext, NULL, 0, flags, &stop);
     }
 
-    returnRegularExpression(regex, (int32_t *)&regexObj->_checkout, checkedOutRegex, reportProgress, anchored, transparentBounds, nonAnchoringBounds, stackBuffer, bufferToFree, utextToFree);
+    returnRegularExpression(regex, (struct ___CFRegularExpression *)regexObj, checkedOutRegex, reportProgress, anchored, transparentBounds, nonAnchoringBounds, stackBuffer, bufferToFree, utextToFree);
 }
 
 CFStringRef _CFRegularExpressionGetPattern(_CFRegularExpressionRef regex) {
@@ -451,3 +749,9 @@ CFStringRef _CFRegularExpressionGetPattern(_CFRegularExpressionRef regex) {
 _CFRegularExpressionOptions _CFRegularExpressionGetOptions(_CFRegularExpressionRef regex) {
     return regex->options;
 }
+
+void _CFRegularExpressionGetMatcherStatistics(_CFRegularExpressionRef regex, CFIndex *cloneCount, CFIndex *reuseCount) {
+    struct ___CFRegularExpression *regexObj = (struct ___CFRegularExpression *)regex;
+    if (cloneCount) *cloneCount = (CFIndex)atomic_load_explicit(&regexObj->_cloneCount, memory_order_relaxed);
+    if (reuseCount) *reuseCount = (CFIndex)atomic_load_explicit(&regexObj->_reuseCount, memory_order_relaxed);
+}
@@ -2705,9 +2705,27 @@ static const u_char __ASCII_LOWERCASE_TABLE[] = {
     0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x7F,
 };
 
+// Sets the high bit of each byte of word that is in the ASCII range [first, last], for any first <= last <= 0x7F. With the high bits cleared, adding (0x80 - first) sets the high bit of a byte exactly when it is >= first, and adding (0x7F - last) exactly when it is > last; neither addition carries into the next byte. Bytes that are not ASCII are never in the range.
+#define __CFStringASCIIBytesInRange(word, first, last) \
+    (((((word) & 0x7F7F7F7F7F7F7F7FULL) + 0x0101010101010101ULL * (0x80 - (first))) ^ (((word) & 0x7F7F7F7F7F7F7F7FULL) + 0x0101010101010101ULL * (0x7F - (last)))) & ~(word) & 0x8080808080808080ULL)
+
 // This function is an implementation of strncasecmp_l that does not stop comparing at embedded null bytes
 // We are not calling to LibC APIs such as tolower_l here because calling to those APIs (as compared to using a lookup table) introduced significant performance regressions
 CF_INLINE int __CFStringCompareASCIICaseInsensitive(const u_char *str1, const u_char *str2, size_t n) {
+    // Skip eight bytes at a time while they match with their letters lowercased; the table finds the difference otherwise
+    while (n >= sizeof(uint64_t)) {
+        uint64_t word1, word2;
+        memcpy(&word1, str1, sizeof(uint64_t));
+        memcpy(&word2, str2, sizeof(uint64_t));
+        if (word1 != word2) {
+            word1 |= (__CFStringASCIIBytesInRange(word1, 'A', 'Z') >> 2);
+            word2 |= (__CFStringASCIIBytesInRange(word2, 'A', 'Z') >> 2);
+            if (word1 != word2) break;
+        }
+        str1 += sizeof(uint64_t);
+        str2 += sizeof(uint64_t);
+        n -= sizeof(uint64_t);
+    }
     if (n != 0) {
         do {
             u_char a = __ASCII_LOWERCASE_TABLE[*str1++];
@@ -3094,6 +3112,217 @@ CFComparisonResult CFStringCompare(CFStringRef string, CFStringRef str2, CFStrin
     return CFStringCompareWithOptions(string, str2, CFRangeMake(0, CFStringGetLength(string)), options);
 }
 
+/* Case-insensitive hashing hashes the same case-folded characters that kCFCompareCaseInsensitive compares, as scalars, so that strings that compare equal hash equally even when their lengths differ ("STRASSE" and "straße"). Only the first HashEverythingLimit folded characters count.
+*/
+CFHashCode _CFStringHashCaseInsensitive(CFStringRef string) {
+    CFIndex length = CFStringGetLength(string);
+    CFStringEncoding eightBitEncoding = __CFStringGetEightBitStringEncoding();
+    const uint8_t *bytes = (const uint8_t *)_CFStringGetCStringPtrInternal(string, eightBitEncoding, false, true);
+    CFHashCode result = 0;
+    CFIndex hashed = 0;
+
+    if ((NULL != bytes) && (kCFStringEncodingASCII == eightBitEncoding)) {
+        CFIndex limit = __CFMin(length, HashEverythingLimit);
+        for (; hashed < limit; hashed++) result = result * 257U + __ASCII_LOWERCASE_TABLE[bytes[hashed]];
+    } else {
+        CFStringInlineBuffer buffer;
+        UTF32Char folded[kCFStringStackBufferLength];
+        CFIndex idx = 0;
+
+        _CFStringInitInlineBufferInternal(string, &buffer, CFRangeMake(0, length), true);
+        while ((idx < length) && (hashed < HashEverythingLimit)) {
+            UTF32Char character = CFStringGetCharacterFromInlineBuffer(&buffer, idx);
+            CFIndex consumed = 1;
+            CFIndex foldedLength = __CFStringFoldCharacterClusterAtIndex(character, &buffer, idx, kCFCompareCaseInsensitive, NULL, folded, kCFStringStackBufferLength, &consumed, NULL);
+
+            if (foldedLength < 1) {
+                UniChar lowSurrogate;
+                if (CFUniCharIsSurrogateHighCharacter(character) && (idx + 1 < length) && CFUniCharIsSurrogateLowCharacter((lowSurrogate = CFStringGetCharacterFromInlineBuffer(&buffer, idx + 1)))) {
+                    character = CFUniCharGetLongCharacterForSurrogatePair(character, lowSurrogate);
+                    consumed = 2;
+                }
+                *folded = character;
+                foldedLength = 1;
+            }
+            for (CFIndex foldedIndex = 0; (foldedIndex < foldedLength) && (hashed < HashEverythingLimit); foldedIndex++, hashed++) result = result * 257U + folded[foldedIndex];
+            idx += consumed;
+        }
+    }
+    return result + (result << (hashed & 31));
+}
+
+bool _CFStringEqualCaseInsensitive(CFStringRef string1, CFStringRef string2) {
+    if (string1 == string2) return true;
+
+    // ASCII folds one character to one, so eight-bit strings of different lengths cannot match
+    CFIndex length1 = CFStringGetLength(string1);
+    CFStringEncoding eightBitEncoding = __CFStringGetEightBitStringEncoding();
+    if ((kCFStringEncodingASCII == eightBitEncoding) && (length1 != CFStringGetLength(string2)) && (NULL != _CFStringGetCStringPtrInternal(string1, eightBitEncoding, false, true)) && (NULL != _CFStringGetCStringPtrInternal(string2, eightBitEncoding, false, true))) return false;
+
+    return (kCFCompareEqualTo == CFStringCompareWithOptionsAndLocale(string1, string2, CFRangeMake(0, length1), kCFCompareCaseInsensitive, NULL));
+}
+
+static Boolean __CFStringCaseInsensitiveCollectionEqual(const void *ptr1, const void *ptr2) {
+    return _CFStringEqualCaseInsensitive((CFStringRef)ptr1, (CFStringRef)ptr2);
+}
+
+static CFHashCode __CFStringCaseInsensitiveCollectionHash(const void *ptr) {
+    return _CFStringHashCaseInsensitive((CFStringRef)ptr);
+}
+
+const CFDictionaryKeyCallBacks _kCFCaseInsensitiveStringDictionaryKeyCallBacks = {0, __CFStringCollectionCopy, __CFTypeCollectionRelease, CFCopyDescription, __CFStringCaseInsensitiveCollectionEqual, __CFStringCaseInsensitiveCollectionHash};
+
+// Literal searches, which match an exact run of code units, read both strings directly when they are stored contiguously. Otherwise the string to find is copied once and the string being searched is copied a window at a time, instead of going through inline buffers character by character.
+#define kCFStringLiteralSearchWindowLength (512)
+#define kCFStringLiteralSearchStackBufferLength (1024)
+
+typedef struct {
+    CFStringRef string;
+    CFIndex findStrLen;
+    const uint8_t *str1Bytes;           // Set, along with str2Bytes, when both strings are 8-bit
+    const uint8_t *str2Bytes;
+    const UniChar *str1Characters;      // NULL when string is read a window at a time
+    const UniChar *str2Characters;
+    UniChar *window;
+    UniChar *allocatedBuffer;
+    UniChar stackBuffer[kCFStringLiteralSearchStackBufferLength];
+} __CFStringLiteralSearch;
+
+// Whether a search with these options matches exactly the same ranges as comparing code units. The 8-bit contents are ASCII, which none of the equality options but case insensitivity and ignored characters fold.
+static bool __CFStringIsLiteralSearch(CFStringCompareFlags compareOptions, bool hasIgnoredCharacters, const uint8_t *str1Bytes, const uint8_t *str2Bytes) {
+    if (hasIgnoredCharacters) return false;
+    if (0 == (compareOptions & (kCFCompareCaseInsensitive|kCFCompareNonliteral|kCFCompareDiacriticInsensitive|kCFCompareWidthInsensitive))) return true;
+    return ((NULL != str1Bytes) && (NULL != str2Bytes) && (kCFStringEncodingASCII == __CFStringGetEightBitStringEncoding()) && (0 == (compareOptions & kCFCompareCaseInsensitive)));
+}
+
+static void __CFStringLiteralSearchInit(__CFStringLiteralSearch *search, CFStringRef string, CFStringRef stringToFind, CFIndex findStrLen, const uint8_t *str1Bytes, const uint8_t *str2Bytes) {
+    search->string = string;
+    search->findStrLen = findStrLen;
+    search->str1Bytes = search->str2Bytes = NULL;
+    search->str1Characters = search->str2Characters = NULL;
+    search->window = search->allocatedBuffer = NULL;
+
+    if ((NULL != str1Bytes) && (NULL != str2Bytes)) {
+        search->str1Bytes = str1Bytes;
+        search->str2Bytes = str2Bytes;
+        return;
+    }
+
+    search->str1Characters = CFStringGetCharactersPtr(string);
+    search->str2Characters = CFStringGetCharactersPtr(stringToFind);
+
+    CFIndex bufferLength = ((NULL == search->str2Characters) ? findStrLen : 0) + ((NULL == search->str1Characters) ? kCFStringLiteralSearchWindowLength + findStrLen - 1 : 0);
+    UniChar *buffer = search->stackBuffer;
+    if (bufferLength > kCFStringLiteralSearchStackBufferLength) {
+        buffer = search->allocatedBuffer = (UniChar *)CFAllocatorAllocate(kCFAllocatorSystemDefault, bufferLength * sizeof(UniChar), 0);
+        if (!buffer) __CFStringHandleOutOfMemory(NULL);
+    }
+    if (NULL == search->str2Characters) {
+        CFStringGetCharacters(stringToFind, CFRangeMake(0, findStrLen), buffer);
+        search->str2Characters = buffer;
+        buffer += findStrLen;
+    }
+    if (NULL == search->str1Characters) search->window = buffer;
+}
+
+static void __CFStringLiteralSearchFinish(__CFStringLiteralSearch *search) {
+    if (search->allocatedBuffer) CFAllocatorDeallocate(kCFAllocatorSystemDefault, search->allocatedBuffer);
+}
+
+// These return the offset of the first, or searching backwards the last, of count candidate positions at which needle occurs, or kCFNotFound. The contents must extend length - 1 past the last candidate.
+// Only candidates whose first and last units match are compared in full; memchr() and the word-at-a-time test below skip the rest several units at a time.
+static CFIndex __CFStringFindBytes(const uint8_t *bytes, CFIndex count, const uint8_t *needle, CFIndex length, bool backwards) {
+    const uint8_t first = needle[0], last = needle[length - 1];
+    if (!backwards) {
+        const uint8_t *current = bytes, *limit = bytes + count;
+        while ((current < limit) && (NULL != (current = (const uint8_t *)memchr(current, first, limit - current)))) {
+            if ((current[length - 1] == last) && (0 == memcmp(current + 1, needle + 1, length - 1))) return current - bytes;
+            ++current;
+        }
+    } else {
+        for (CFIndex idx = count - 1; idx >= 0; idx--) {
+            if ((bytes[idx] == first) && (bytes[idx + length - 1] == last) && (0 == memcmp(bytes + idx + 1, needle + 1, length - 1))) return idx;
+        }
+    }
+    return kCFNotFound;
+}
+
+static CFIndex __CFStringFindCharacters(const UniChar *characters, CFIndex count, const UniChar *needle, CFIndex length, bool backwards) {
+    const UniChar first = needle[0], last = needle[length - 1];
+    if (!backwards) {
+        const uint64_t ones = 0x0001000100010001ULL, highBits = 0x8000800080008000ULL, pattern = ones * first;
+        CFIndex idx = 0;
+        while (idx < count) {
+            if (count - idx >= 4) {
+                uint64_t word;
+                memcpy(&word, characters + idx, sizeof(word));
+                word ^= pattern;
+                // Nonzero if any of the four characters is first; it may also flag a character right after one that is.
+                if (0 == ((word - ones) & ~word & highBits)) {
+                    idx += 4;
+                    continue;
+                }
+            }
+            if ((characters[idx] == first) && (characters[idx + length - 1] == last) && (0 == memcmp(characters + idx + 1, needle + 1, (length - 1) * sizeof(UniChar)))) return idx;
+            ++idx;
+        }
+    } else {
+        for (CFIndex idx = count - 1; idx >= 0; idx--) {
+            if ((characters[idx] == first) && (characters[idx + length - 1] == last) && (0 == memcmp(characters + idx + 1, needle + 1, (length - 1) * sizeof(UniChar)))) return idx;
+        }
+    }
+    return kCFNotFound;
+}
+
+// Returns the first, or searching backwards the last, location between from and to (inclusive) at which the string to find starts, or kCFNotFound.
+static CFIndex __CFStringLiteralSearchNext(__CFStringLiteralSearch *search, CFIndex from, CFIndex to, bool backwards) {
+    CFIndex length = search->findStrLen;
+    CFIndex count = to - from + 1;
+    CFIndex found;
+
+    if (count <= 0) return kCFNotFound;
+
+    if (NULL != search->str1Bytes) {
+        found = __CFStringFindBytes(search->str1Bytes + from, count, search->str2Bytes, length, backwards);
+        return (kCFNotFound == found) ? kCFNotFound : from + found;
+    }
+    if (NULL != search->str1Characters) {
+        found = __CFStringFindCharacters(search->str1Characters + from, count, search->str2Characters, length, backwards);
+        return (kCFNotFound == found) ? kCFNotFound : from + found;
+    }
+
+    while (count > 0) {
+        CFIndex windowCount = __CFMin(count, kCFStringLiteralSearchWindowLength);
+        CFIndex windowLocation = backwards ? (from + count - windowCount) : from;
+        CFStringGetCharacters(search->string, CFRangeMake(windowLocation, windowCount + length - 1), search->window);
+        found = __CFStringFindCharacters(search->window, windowCount, search->str2Characters, length, backwards);
+        if (kCFNotFound != found) return windowLocation + found;
+        if (!backwards) from += windowCount;
+        count -= windowCount;
+    }
+    return kCFNotFound;
+}
+
+static Boolean __CFStringFindLiteral(CFStringRef string, CFStringRef stringToFind, CFIndex findStrLen, CFRange rangeToSearch, CFStringCompareFlags compareOptions, const uint8_t *str1Bytes, const uint8_t *str2Bytes, CFRange *result) {
+    if (findStrLen > rangeToSearch.length) return false;
+
+    bool backwards = ((compareOptions & kCFCompareBackwards) ? true : false);
+    CFIndex from = rangeToSearch.location;
+    CFIndex to = rangeToSearch.location + rangeToSearch.length - findStrLen;
+    if (compareOptions & kCFCompareAnchored) {
+        if (backwards) from = to; else to = from;
+    }
+
+    __CFStringLiteralSearch search;
+    __CFStringLiteralSearchInit(&search, string, stringToFind, findStrLen, str1Bytes, str2Bytes);
+    CFIndex found = __CFStringLiteralSearchNext(&search, from, to, backwards);
+    __CFStringLiteralSearchFinish(&search);
+
+    if (kCFNotFound == found) return false;
+    if (NULL != result) *result = CFRangeMake(found, findStrLen);
+    return true;
+}
+
 Boolean CFStringFindWithOptionsAndLocale(CFStringRef string, CFStringRef stringToFind, CFRange rangeToSearch, CFStringCompareFlags compareOptions, CFLocaleRef locale, CFRange *result)  {
     /* No objc dispatch needed here since CFStringInlineBuffer works with both CFString and NSString */
     CFIndex findStrLen = CFStringGetLength(stringToFind);
@@ -3129,6 +3358,10 @@ Boolean CFStringFindWithOptionsAndLocale(CFStringRef string, CFStringRef stringT
 	bool backwardAnchor = (((kCFCompareBackwards|kCFCompareAnchored) == (compareOptions & (kCFCompareBackwards|kCFCompareAnchored))) ? true : false);
         int8_t delta;
 
+        if (__CFStringIsLiteralSearch(compareOptions, (NULL != ignoredChars), str1Bytes, str2Bytes)) {
+            return __CFStringFindLiteral(string, stringToFind, findStrLen, rangeToSearch, compareOptions, str1Bytes, str2Bytes, result);
+        }
+
         if (NULL == locale) {
             if (compareOptions & kCFCompareLocalized) {
                 CFLocaleRef currentLocale = CFLocaleCopyCurrent();
@@ -3275,7 +3508,7 @@ Boolean CFStringFindWithOptionsAndLocale(CFStringRef string, CFStringRef stringT
                 if (fromLoc == toLoc) break;
                 fromLoc += delta;
             }
-        } else if (equalityOptions) {
+        } else {
             UTF16Char otherChar;
             CFIndex str1UsedLen, str2UsedLen, strBuf1Index = 0, strBuf2Index = 0;
             bool diacriticsInsensitive = ((compareOptions & kCFCompareDiacriticInsensitive) ? true : false);
@@ -3522,26 +3755,6 @@ Boolean CFStringFindWithOptionsAndLocale(CFStringRef string, CFStringRef stringT
                     }
                 }
                 
-                if (fromLoc == toLoc) break;
-                fromLoc += delta;
-            }
-        } else {
-            while (1) {
-                str1Index = fromLoc;
-                str2Index = 0;
-                
-                while (str2Index < findStrLen) {
-                    if (CFStringGetCharacterFromInlineBuffer(&inlineBuf1, str1Index) != CFStringGetCharacterFromInlineBuffer(&inlineBuf2, str2Index)) break;
-
-                    ++str1Index; ++str2Index;
-                }
-                
-                if (str2Index == findStrLen) {
-                    didFind = true;
-                    if (NULL != result) *result = CFRangeMake(fromLoc, findStrLen);
-                    break;
-                }
-                
                 if (fromLoc == toLoc) break;
                 fromLoc += delta;
             }
@@ -3554,6 +3767,59 @@ Boolean CFStringFindWithOptionsAndLocale(CFStringRef string, CFStringRef stringT
 
 Boolean CFStringFindWithOptions(CFStringRef string, CFStringRef stringToFind, CFRange rangeToSearch, CFStringCompareFlags compareOptions, CFRange *result) { return CFStringFindWithOptionsAndLocale(string, stringToFind, rangeToSearch, compareOptions, NULL, result); }
 
+CFIndex _CFStringFindAllWithOptionsAndLocale(CFStringRef string, CFStringRef stringToFind, CFRange rangeToSearch, CFStringCompareFlags compareOptions, CFLocaleRef locale, void *context, bool (*handler)(void *context, CFRange foundRange)) {
+    bool backwards = ((compareOptions & kCFCompareBackwards) ? true : false);
+    CFIndex endIndex = rangeToSearch.location + rangeToSearch.length;
+    CFIndex findStrLen = CFStringGetLength(stringToFind);
+    CFIndex foundCount = 0;
+    CFRange foundRange;
+
+    if ((findStrLen == 0) || (rangeToSearch.length == 0)) return 0;
+
+    CFCharacterSetInlineBuffer csetBuffer;
+    CFStringEncoding eightBitEncoding = __CFStringGetEightBitStringEncoding();
+    const uint8_t *str1Bytes = (const uint8_t *)_CFStringGetCStringPtrInternal(string, eightBitEncoding, false, true);
+    const uint8_t *str2Bytes = (const uint8_t *)_CFStringGetCStringPtrInternal(stringToFind, eightBitEncoding, false, true);
+
+    if (__CFStringIsLiteralSearch(compareOptions, __CFStringFillCharacterSetInlineBuffer(&csetBuffer, compareOptions), str1Bytes, str2Bytes)) {
+        // Keep one search for all occurrences, so the string to find is copied at most once.
+        __CFStringLiteralSearch search;
+        __CFStringLiteralSearchInit(&search, string, stringToFind, findStrLen, str1Bytes, str2Bytes);
+        while (rangeToSearch.length >= findStrLen) {
+            CFIndex from = rangeToSearch.location;
+            CFIndex to = rangeToSearch.location + rangeToSearch.length - findStrLen;
+            if (compareOptions & kCFCompareAnchored) {
+                if (backwards) from = to; else to = from;
+            }
+            CFIndex found = __CFStringLiteralSearchNext(&search, from, to, backwards);
+            if (kCFNotFound == found) break;
+            foundRange = CFRangeMake(found, findStrLen);
+
+            if (backwards) {
+                rangeToSearch.length = foundRange.location - rangeToSearch.location;
+            } else {
+                rangeToSearch.location = foundRange.location + foundRange.length;
+                rangeToSearch.length = endIndex - rangeToSearch.location;
+            }
+            foundCount++;
+            if (!handler(context, foundRange)) break;
+        }
+        __CFStringLiteralSearchFinish(&search);
+    } else {
+        while ((rangeToSearch.length > 0) && CFStringFindWithOptionsAndLocale(string, stringToFind, rangeToSearch, compareOptions, locale, &foundRange)) {
+            if (backwards) {
+                rangeToSearch.length = foundRange.location - rangeToSearch.location;
+            } else {
+                rangeToSearch.location = foundRange.location + foundRange.length;
+                rangeToSearch.length = endIndex - rangeToSearch.location;
+            }
+            foundCount++;
+            if (!handler(context, foundRange)) break;
+        }
+    }
+    return foundCount;
+}
+
 // Functions to deal with special arrays of CFRange, CFDataRef, created by CFStringCreateArrayWithFindResults()
 
 static const void *__rangeRetain(CFAllocatorRef allocator, const void *ptr) {
@@ -3577,38 +3843,40 @@ static Boolean	__rangeEqual(const void *ptr1, const void *ptr2) {
 }
 
 
+typedef struct {
+    CFAllocatorRef allocator;
+    CFMutableDataRef rangeStorage;	// Basically an array of CFRange, CFDataRef (packed)
+    uint8_t *rangeStorageBytes;
+    CFIndex foundCount;
+    CFIndex capacity;		// Number of CFRange, CFDataRef element slots in rangeStorage
+} __CFStringFindResultsStorage;
+
+static bool __CFStringAppendFindResult(void *context, CFRange foundRange) {
+    __CFStringFindResultsStorage *storage = (__CFStringFindResultsStorage *)context;
+
+    // If necessary, grow the data and squirrel away the found range
+    if (storage->foundCount >= storage->capacity) {
+	if (storage->rangeStorage == NULL) storage->rangeStorage = CFDataCreateMutable(storage->allocator, 0);
+	storage->capacity = (storage->capacity + 4) * 2;
+	CFDataSetLength(storage->rangeStorage, storage->capacity * (sizeof(CFRange) + sizeof(CFDataRef)));
+	storage->rangeStorageBytes = (uint8_t *)CFDataGetMutableBytePtr(storage->rangeStorage) + storage->foundCount * (sizeof(CFRange) + sizeof(CFDataRef));
+    }
+    memmove(storage->rangeStorageBytes, &foundRange, sizeof(CFRange));	// The range
+    memmove(storage->rangeStorageBytes + sizeof(CFRange), &storage->rangeStorage, sizeof(CFDataRef));	// The data
+    storage->rangeStorageBytes += (sizeof(CFRange) + sizeof(CFDataRef));
+    storage->foundCount++;
+    return true;
+}
+
 CFArrayRef CFStringCreateArrayWithFindResults(CFAllocatorRef alloc, CFStringRef string, CFStringRef stringToFind, CFRange rangeToSearch, CFStringCompareFlags compareOptions) {
-    CFRange foundRange;
-    Boolean backwards = ((compareOptions & kCFCompareBackwards) != 0);
-    UInt32 endIndex = rangeToSearch.location + rangeToSearch.length;
-    CFMutableDataRef rangeStorage = NULL;	// Basically an array of CFRange, CFDataRef (packed)
     uint8_t *rangeStorageBytes = NULL;
-    CFIndex foundCount = 0;
-    CFIndex capacity = 0;		// Number of CFRange, CFDataRef element slots in rangeStorage
-    
-    if (alloc == NULL) alloc = __CFGetDefaultAllocator();
 
-    while ((rangeToSearch.length > 0) && CFStringFindWithOptions(string, stringToFind, rangeToSearch, compareOptions, &foundRange)) {
-	// Determine the next range
-        if (backwards) {
-            rangeToSearch.length = foundRange.location - rangeToSearch.location;
-        } else {
-            rangeToSearch.location = foundRange.location + foundRange.length;
-            rangeToSearch.length = endIndex - rangeToSearch.location;
-        }
+    if (alloc == NULL) alloc = __CFGetDefaultAllocator();
 
-	// If necessary, grow the data and squirrel away the found range 
-	if (foundCount >= capacity) {
-	    if (rangeStorage == NULL) rangeStorage = CFDataCreateMutable(alloc, 0);
-	    capacity = (capacity + 4) * 2;
-	    CFDataSetLength(rangeStorage, capacity * (sizeof(CFRange) + sizeof(CFDataRef)));
-	    rangeStorageBytes = (uint8_t *)CFDataGetMutableBytePtr(rangeStorage) + foundCount * (sizeof(CFRange) + sizeof(CFDataRef));
-	}
-	memmove(rangeStorageBytes, &foundRange, sizeof(CFRange));	// The range
-	memmove(rangeStorageBytes + sizeof(CFRange), &rangeStorage, sizeof(CFDataRef));	// The data
-	rangeStorageBytes += (sizeof(CFRange) + sizeof(CFDataRef));
-	foundCount++;
-    }
+    __CFStringFindResultsStorage storage = {alloc, NULL, NULL, 0, 0};
+    _CFStringFindAllWithOptionsAndLocale(string, stringToFind, rangeToSearch, compareOptions, NULL, &storage, __CFStringAppendFindResult);
+    CFMutableDataRef rangeStorage = storage.rangeStorage;
+    CFIndex foundCount = storage.foundCount;
 
     if (foundCount > 0) {
 	CFIndex cnt;
@@ -4571,6 +4839,67 @@ CFRange CFStringGetRangeOfComposedCharactersAtIndex(CFStringRef theString, CFInd
     return CFStringGetRangeOfCharacterClusterAtIndex(theString, theIndex, kCFStringComposedCharacterCluster);
 }
 
+// Scans for a member (or non-member) of theSet a window at a time, reading the contents directly when they are stored contiguously. Windows never end between the two halves of a surrogate pair, so pairs are always tested as one character.
+#define kCFStringCharacterSetSearchWindowLength (512)
+
+bool _CFStringFindCharacterFromSet(CFStringRef theString, CFCharacterSetRef theSet, CFRange rangeToSearch, CFStringCompareFlags searchOptions, bool findNonMembers, CFRange *result) {
+    CFCharacterSetInlineBuffer csetBuffer;
+    const bool backwards = ((searchOptions & kCFCompareBackwards) != 0);
+    CFRange found = CFRangeMake(kCFNotFound, 0);
+
+    if ((rangeToSearch.location + rangeToSearch.length > CFStringGetLength(theString)) || (rangeToSearch.length == 0)) return false;
+
+    CFRange range = rangeToSearch;
+    if (searchOptions & kCFCompareAnchored) {
+        // Only the character at the edge of the range can match, and it is at most a surrogate pair long
+        range.length = __CFMin(range.length, 2);
+        if (backwards) range.location = rangeToSearch.location + rangeToSearch.length - range.length;
+    }
+
+    CFCharacterSetInitInlineBuffer(theSet, &csetBuffer);
+
+    const CFStringEncoding eightBitEncoding = __CFStringGetEightBitStringEncoding();
+    const uint8_t *bytes = NULL;
+    const UniChar *characters = NULL;
+    if ((kCFStringEncodingASCII == eightBitEncoding) || (kCFStringEncodingISOLatin1 == eightBitEncoding)) bytes = (const uint8_t *)_CFStringGetCStringPtrInternal(theString, eightBitEncoding, false, true);
+    if (NULL == bytes) characters = CFStringGetCharactersPtr(theString);
+
+    if (NULL != bytes) {
+        CFIndex idx = _CFCharacterSetInlineBufferFindByte(&csetBuffer, bytes + range.location, range.length, findNonMembers, backwards);
+        if (kCFNotFound != idx) found = CFRangeMake(range.location + idx, 1);
+    } else if (NULL != characters) {
+        found = _CFCharacterSetInlineBufferFindCharacter(&csetBuffer, characters + range.location, range.length, findNonMembers, backwards);
+        if (kCFNotFound != found.location) found.location += range.location;
+    } else {
+        UniChar window[kCFStringCharacterSetSearchWindowLength];
+        CFIndex start = range.location, limit = range.location + range.length;
+        while ((start < limit) && (kCFNotFound == found.location)) {
+            CFIndex windowLength = __CFMin(limit - start, kCFStringCharacterSetSearchWindowLength);
+            CFIndex windowLocation = backwards ? limit - windowLength : start;
+            CFIndex skipped = 0;
+            CFStringGetCharacters(theString, CFRangeMake(windowLocation, windowLength), window);
+            if (!backwards && (windowLength > 1) && (windowLocation + windowLength < limit) && CFUniCharIsSurrogateHighCharacter(window[windowLength - 1])) {
+                windowLength--;
+            } else if (backwards && (windowLength > 1) && (windowLocation > start) && CFUniCharIsSurrogateLowCharacter(window[0])) {
+                skipped = 1;
+                windowLocation++;
+                windowLength--;
+            }
+            if (backwards) limit = windowLocation; else start = windowLocation + windowLength;
+
+            found = _CFCharacterSetInlineBufferFindCharacter(&csetBuffer, window + skipped, windowLength, findNonMembers, backwards);
+            if (kCFNotFound != found.location) found.location += windowLocation;
+        }
+    }
+
+    if (kCFNotFound == found.location) return false;
+    if (searchOptions & kCFCompareAnchored) {
+        if (backwards ? (found.location + found.length != rangeToSearch.location + rangeToSearch.length) : (found.location != rangeToSearch.location)) return false;
+    }
+    if (result) *result = found;
+    return true;
+}
+
 /*!
 	@function CFStringFindCharacterFromSet
 	Query the range of characters contained in the specified character set.
@@ -4597,77 +4926,9 @@ CFRange CFStringGetRangeOfComposedCharactersAtIndex(CFStringRef theString, CFInd
 	@result true, if at least a character which is a member of the character
 			set is found and result is filled, otherwise, false.
 */
-#define SURROGATE_START 0xD800
-#define SURROGATE_END 0xDFFF
-
 CF_EXPORT Boolean CFStringFindCharacterFromSet(CFStringRef theString, CFCharacterSetRef theSet, CFRange rangeToSearch, CFStringCompareFlags searchOptions, CFRange *result) {
-    CFStringInlineBuffer stringBuffer;
-    CFCharacterSetInlineBuffer csetBuffer;
-    UniChar ch;
-    CFIndex step;
-    CFIndex fromLoc, toLoc, cnt;	// fromLoc and toLoc are inclusive
-    Boolean found = false;
-    Boolean done = false;
-
 //#warning FIX ME !! Should support kCFCompareNonliteral
-
-    if ((rangeToSearch.location + rangeToSearch.length > CFStringGetLength(theString)) || (rangeToSearch.length == 0)) return false;
-
-    if (searchOptions & kCFCompareBackwards) {
-        fromLoc = rangeToSearch.location + rangeToSearch.length - 1;
-        toLoc = rangeToSearch.location;
-    } else {       
-        fromLoc = rangeToSearch.location;
-        toLoc = rangeToSearch.location + rangeToSearch.length - 1;
-    }
-    if (searchOptions & kCFCompareAnchored) {
-	toLoc = fromLoc;
-    }
-
-    step = (fromLoc <= toLoc) ? 1 : -1;
-    cnt = fromLoc;
-    
-    _CFStringInitInlineBufferInternal(theString, &stringBuffer, rangeToSearch, true);
-    CFCharacterSetInitInlineBuffer(theSet, &csetBuffer);
-
-    do {
-	ch = CFStringGetCharacterFromInlineBuffer(&stringBuffer, cnt - rangeToSearch.location);
-        if ((ch >= SURROGATE_START) && (ch <= SURROGATE_END)) {
-            int otherCharIndex = cnt + step;
-
-            if (((step < 0) && (otherCharIndex < toLoc)) || ((step > 0) && (otherCharIndex > toLoc))) {
-                done = true;
-            } else {
-                UniChar highChar;
-                UniChar lowChar = CFStringGetCharacterFromInlineBuffer(&stringBuffer, otherCharIndex - rangeToSearch.location);
-
-                if (cnt < otherCharIndex) {
-                    highChar = ch;
-                } else {
-                    highChar = lowChar;
-                    lowChar = ch;
-                }
-
-                if (CFUniCharIsSurrogateHighCharacter(highChar) && CFUniCharIsSurrogateLowCharacter(lowChar) && CFCharacterSetInlineBufferIsLongCharacterMember(&csetBuffer, CFUniCharGetLongCharacterForSurrogatePair(highChar, lowChar))) {
-                    if (result) *result = CFRangeMake((cnt < otherCharIndex ? cnt : otherCharIndex), 2);
-                    return true;
-                } else if (otherCharIndex == toLoc) {
-                    done = true;
-                } else {
-                    cnt = otherCharIndex + step;
-                }
-            }
-        } else if (CFCharacterSetInlineBufferIsLongCharacterMember(&csetBuffer, ch)) {
-	    done = found = true;
-        } else if (cnt == toLoc) {
-            done = true;
-        } else {
-            cnt += step;
-        }
-    } while (!done);
-
-    if (found && result) *result = CFRangeMake(cnt, 1);
-    return found;
+    return _CFStringFindCharacterFromSet(theString, theSet, rangeToSearch, searchOptions, false, result);
 }
 
 /* Line range code */
@@ -4770,6 +5031,60 @@ void CFStringGetParagraphBounds(CFStringRef string, CFRange range, CFIndex *parB
     __CFStringGetLineOrParagraphBounds(string, range, parBeginIndex, parEndIndex, contentsEndIndex, false);
 }
 
+/* Returns the index of the first '\n' or '\r' in bytes[from, to), or to. Checks a word at a time; a word that holds a byte from '\n' to '\r' is checked byte by byte, since the range also covers '\v' and '\f'.
+*/
+static CFIndex __CFStringFindASCIILineBreak(const uint8_t *bytes, CFIndex from, CFIndex to) {
+    while (from + 8 <= to) {
+        uint64_t word;
+        memcpy(&word, bytes + from, 8);
+        if (__CFStringASCIIBytesInRange(word, NewLine, CarriageReturn)) {
+            for (CFIndex idx = from; idx < from + 8; idx++) {
+                if (bytes[idx] == NewLine || bytes[idx] == CarriageReturn) return idx;
+            }
+        }
+        from += 8;
+    }
+    for (; from < to; from++) {
+        if (bytes[from] == NewLine || bytes[from] == CarriageReturn) return from;
+    }
+    return to;
+}
+
+CFIndex _CFStringGetLineBoundsInRange(CFStringRef string, CFRange range, bool paragraphs, CFRange *lineRanges, CFIndex *contentsEnds, CFIndex maxCount) {
+    CFIndex len = CFStringGetLength(string);
+    CFIndex rangeEnd = range.location + range.length;
+    CFIndex location = range.location;
+    CFIndex count = 0;
+    CFStringInlineBuffer buf;
+
+    if (range.length <= 0 || maxCount <= 0) return 0;
+
+    // Only '\n' and '\r' can end a line in ASCII, so ASCII contents are searched for just those two bytes.
+    const uint8_t *bytes = (const uint8_t *)_CFStringGetCStringPtrInternal(string, kCFStringEncodingASCII, false, true);
+    if (!bytes) _CFStringInitInlineBufferInternal(string, &buf, CFRangeMake(0, len), true);
+
+    while (location < rangeEnd && count < maxCount) {
+        CFIndex contentsEnd, lineEnd;
+        if (bytes) {
+            contentsEnd = __CFStringFindASCIILineBreak(bytes, location, len);
+        } else {
+            contentsEnd = location;
+            while (contentsEnd < len && !isALineSeparatorTypeCharacter(CFStringGetCharacterFromInlineBuffer(&buf, contentsEnd), !paragraphs)) contentsEnd++;
+        }
+        lineEnd = contentsEnd;
+        if (contentsEnd < len) {
+            UniChar ch = bytes ? bytes[contentsEnd] : CFStringGetCharacterFromInlineBuffer(&buf, contentsEnd);
+            lineEnd++;
+            if (ch == CarriageReturn && lineEnd < len && (bytes ? bytes[lineEnd] : CFStringGetCharacterFromInlineBuffer(&buf, lineEnd)) == NewLine) lineEnd++;
+        }
+        lineRanges[count] = CFRangeMake(location, lineEnd - location);
+        if (contentsEnds) contentsEnds[count] = contentsEnd;
+        count++;
+        location = lineEnd;
+    }
+    return count;
+}
+
 
 CFStringRef CFStringCreateByCombiningStrings(CFAllocatorRef alloc, CFArrayRef array, CFStringRef separatorString) {
     CFIndex numChars;
@@ -5184,40 +5499,42 @@ void CFStringAppendFormat(CFMutableStringRef str, CFDictionaryRef formatOptions,
 }
 
 
+typedef struct {
+    CFRange *ranges;
+    CFRange *stackRanges;
+    CFIndex foundCount;
+    CFIndex capacity;
+} __CFStringFindAndReplaceRanges;
+
+static bool __CFStringAppendReplacementRange(void *context, CFRange foundRange) {
+    __CFStringFindAndReplaceRanges *storage = (__CFStringFindAndReplaceRanges *)context;
+
+    // If necessary, grow the array
+    if (storage->foundCount >= storage->capacity) {
+        bool firstAlloc = (storage->ranges == storage->stackRanges) ? true : false;
+        CFIndex stackCapacity = storage->capacity;
+        storage->capacity = (storage->capacity + 4) * 2;
+        // Note that reallocate with NULL previous pointer is same as allocate
+        storage->ranges = __CFSafelyReallocateWithAllocator(kCFAllocatorSystemDefault, firstAlloc ? NULL : storage->ranges, storage->capacity * sizeof(CFRange), 0, NULL);
+        if (firstAlloc) memmove(storage->ranges, storage->stackRanges, stackCapacity * sizeof(CFRange));
+    }
+    storage->ranges[storage->foundCount] = foundRange;
+    storage->foundCount++;
+    return true;
+}
+
 CFIndex CFStringFindAndReplace(CFMutableStringRef string, CFStringRef stringToFind, CFStringRef replacementString, CFRange rangeToSearch, CFStringCompareFlags compareOptions) {
     CF_OBJC_FUNCDISPATCHV(_kCFRuntimeIDCFString, CFIndex, (NSMutableString *)string, replaceOccurrencesOfString:(NSString *)stringToFind withString:(NSString *)replacementString options:(NSStringCompareOptions)compareOptions range:NSMakeRange(rangeToSearch.location, rangeToSearch.length));
-    CFRange foundRange;
     Boolean backwards = ((compareOptions & kCFCompareBackwards) != 0);
-    UInt32 endIndex = rangeToSearch.location + rangeToSearch.length;
 #define MAX_RANGES_ON_STACK (1000 / sizeof(CFRange))
     CFRange rangeBuffer[MAX_RANGES_ON_STACK];	// Used to avoid allocating memory
-    CFRange *ranges = rangeBuffer;
-    CFIndex foundCount = 0;
-    CFIndex capacity = MAX_RANGES_ON_STACK;
 
     __CFAssertRangeIsInStringBounds(string, rangeToSearch.location, rangeToSearch.length);
 
-    // Note: This code is very similar to the one in CFStringCreateArrayWithFindResults().
-    while ((rangeToSearch.length > 0) && CFStringFindWithOptions(string, stringToFind, rangeToSearch, compareOptions, &foundRange)) {
-	// Determine the next range
-        if (backwards) {
-            rangeToSearch.length = foundRange.location - rangeToSearch.location;
-        } else {
-            rangeToSearch.location = foundRange.location + foundRange.length;
-            rangeToSearch.length = endIndex - rangeToSearch.location;
-        }
-
-	// If necessary, grow the array 
-	if (foundCount >= capacity) {
-            bool firstAlloc = (ranges == rangeBuffer) ? true : false;
-            capacity = (capacity + 4) * 2;
-            // Note that reallocate with NULL previous pointer is same as allocate
-            ranges = __CFSafelyReallocateWithAllocator(kCFAllocatorSystemDefault, firstAlloc ? NULL : ranges, capacity * sizeof(CFRange), 0, NULL);
-            if (firstAlloc) memmove(ranges, rangeBuffer, MAX_RANGES_ON_STACK * sizeof(CFRange));
-	}
-        ranges[foundCount] = foundRange;
-	foundCount++;
-    }
+    __CFStringFindAndReplaceRanges storage = {rangeBuffer, rangeBuffer, 0, MAX_RANGES_ON_STACK};
+    _CFStringFindAllWithOptionsAndLocale(string, stringToFind, rangeToSearch, compareOptions, NULL, &storage, __CFStringAppendReplacementRange);
+    CFRange *ranges = storage.ranges;
+    CFIndex foundCount = storage.foundCount;
 
     if (foundCount > 0) {
         if (backwards) {	// Reorder the ranges to be incrementing (better to do this here, then to check other places)
@@ -5389,6 +5706,30 @@ void CFStringTrimWhitespace(CFMutableStringRef string) {
     }
 }
 
+/* Maps the ASCII letters in bytes to lowercase, or to uppercase if toUpper is true, in place, up to the first byte that is not ASCII. Returns the number of bytes it got through.
+*/
+static CFIndex __CFStringMapASCIICase(uint8_t *bytes, CFIndex length, bool toUpper) {
+    const uint8_t first = (toUpper ? 'a' : 'A');
+    const uint8_t last = (toUpper ? 'z' : 'Z');
+    CFIndex idx = 0;
+
+    for (; idx + (CFIndex)sizeof(uint64_t) <= length; idx += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, bytes + idx, sizeof(uint64_t));
+        if (word & 0x8080808080808080ULL) break;
+        uint64_t letters = __CFStringASCIIBytesInRange(word, first, last);
+        if (letters) {
+            word ^= (letters >> 2); // 0x20 is the case bit
+            memcpy(bytes + idx, &word, sizeof(uint64_t));
+        }
+    }
+    for (; idx < length; idx++) {
+        if (bytes[idx] > 127) break;
+        if (bytes[idx] >= first && bytes[idx] <= last) bytes[idx] ^= 0x20;
+    }
+    return idx;
+}
+
 void CFStringLowercase(CFMutableStringRef string, CFLocaleRef locale) {
     CFIndex currentIndex = 0;
     CFIndex length;
@@ -5405,13 +5746,7 @@ void CFStringLowercase(CFMutableStringRef string, CFLocaleRef locale) {
 
     if (!langCode && isEightBit) {
         uint8_t *contents = (uint8_t *)__CFStrContents(string) + __CFStrSkipAnyLengthByte(string);
-        for (;currentIndex < length;currentIndex++) {
-            if (contents[currentIndex] >= 'A' && contents[currentIndex] <= 'Z') {
-                contents[currentIndex] += 'a' - 'A';
-            } else if (contents[currentIndex] > 127) {
-                break;
-            }
-        }
+        currentIndex = __CFStringMapASCIICase(contents, length, false);
     }
 
     if (currentIndex < length) {
@@ -5426,6 +5761,11 @@ void CFStringLowercase(CFMutableStringRef string, CFLocaleRef locale) {
         contents = (UniChar *)__CFStrContents(string);
 
         for (;currentIndex < length;currentIndex++) {
+            if (!langCode && (contents[currentIndex] < 0x80)) { // ASCII maps to itself or its lowercase letter
+                if (contents[currentIndex] >= 'A' && contents[currentIndex] <= 'Z') contents[currentIndex] += 'a' - 'A';
+                flags = 0;
+                continue;
+            }
 
             if (CFUniCharIsSurrogateHighCharacter(contents[currentIndex]) && (currentIndex + 1 < length) && CFUniCharIsSurrogateLowCharacter(contents[currentIndex + 1])) {
                 currentChar = CFUniCharGetLongCharacterForSurrogatePair(contents[currentIndex], contents[currentIndex + 1]);
@@ -5496,13 +5836,7 @@ void CFStringUppercase(CFMutableStringRef string, CFLocaleRef locale) {
 
     if (!langCode && isEightBit) {
         uint8_t *contents = (uint8_t *)__CFStrContents(string) + __CFStrSkipAnyLengthByte(string);
-        for (;currentIndex < length;currentIndex++) {
-            if (contents[currentIndex] >= 'a' && contents[currentIndex] <= 'z') {
-                contents[currentIndex] -= 'a' - 'A';
-            } else if (contents[currentIndex] > 127) {
-                break;
-            }
-        }
+        currentIndex = __CFStringMapASCIICase(contents, length, true);
     }
 
     if (currentIndex < length) {
@@ -5517,6 +5851,11 @@ void CFStringUppercase(CFMutableStringRef string, CFLocaleRef locale) {
         contents = (UniChar *)__CFStrContents(string);
 
         for (;currentIndex < length;currentIndex++) {
+            if (!langCode && (contents[currentIndex] < 0x80)) { // ASCII maps to itself or its uppercase letter
+                if (contents[currentIndex] >= 'a' && contents[currentIndex] <= 'z') contents[currentIndex] -= 'a' - 'A';
+                continue;
+            }
+
             if (CFUniCharIsSurrogateHighCharacter(contents[currentIndex]) && (currentIndex + 1 < length) && CFUniCharIsSurrogateLowCharacter(contents[currentIndex + 1])) {
                 currentChar = CFUniCharGetLongCharacterForSurrogatePair(contents[currentIndex], contents[currentIndex + 1]);
             } else {
@@ -5593,6 +5932,17 @@ void CFStringCapitalize(CFMutableStringRef string, CFLocaleRef locale) {
     if (!langCode && isEightBit) {
         uint8_t *contents = (uint8_t *)__CFStrContents(string) + __CFStrSkipAnyLengthByte(string);
         for (;currentIndex < length;currentIndex++) {
+            if (isLastCased && (currentIndex + (CFIndex)sizeof(uint64_t) <= length)) { // Inside a word, a run of eight letters is lowercased as a whole
+                uint64_t word;
+                memcpy(&word, contents + currentIndex, sizeof(uint64_t));
+                uint64_t upper = __CFStringASCIIBytesInRange(word, 'A', 'Z');
+                if ((upper | __CFStringASCIIBytesInRange(word, 'a', 'z')) == 0x8080808080808080ULL) {
+                    word |= (upper >> 2);
+                    memcpy(contents + currentIndex, &word, sizeof(uint64_t));
+                    currentIndex += sizeof(uint64_t) - 1;
+                    continue;
+                }
+            }
             if (contents[currentIndex] > 127) {
                 break;
             } else if (contents[currentIndex] >= 'A' && contents[currentIndex] <= 'Z') {
@@ -5619,6 +5969,21 @@ void CFStringCapitalize(CFMutableStringRef string, CFLocaleRef locale) {
         contents = (UniChar *)__CFStrContents(string);
 
         for (;currentIndex < length;currentIndex++) {
+            if (!langCode && (contents[currentIndex] < 0x80)) { // ASCII, as in the eight-bit loop above
+                UniChar character = contents[currentIndex];
+                if (character >= 'A' && character <= 'Z') {
+                    contents[currentIndex] += (isLastCased ? 'a' - 'A' : 0);
+                    isLastCased = true;
+                } else if (character >= 'a' && character <= 'z') {
+                    contents[currentIndex] -= (!isLastCased ? 'a' - 'A' : 0);
+                    isLastCased = true;
+                } else if (!CFUniCharIsMemberOfBitmap(character, caseIgnorableForBMP)) {
+                    isLastCased = false;
+                }
+                flags = 0;
+                continue;
+            }
+
             if (CFUniCharIsSurrogateHighCharacter(contents[currentIndex]) && (currentIndex + 1 < length) && CFUniCharIsSurrogateLowCharacter(contents[currentIndex + 1])) {
                 currentChar = CFUniCharGetLongCharacterForSurrogatePair(contents[currentIndex], contents[currentIndex + 1]);
             } else {
@@ -5714,6 +6079,142 @@ CF_INLINE void __CFFillInUTF16(const UTF32Char *characters, UTF16Char *dst, uint
     }
 }
 
+/* Normalization quick check
+
+ A run of characters that each map to themselves in a form, and that cannot combine with the character before them, is already in that form as long as its combining classes are in canonical order. This is the NFD_QC/NFC_QC check from UAX #15, but the properties are derived from the same decomposition and precomposition tables CFStringNormalize() uses, so the two can never disagree; "maybe" is treated as "no".
+*/
+CF_INLINE uint8_t __CFStringGetCombiningClass(UTF32Char character, const uint8_t *combiningBMP) {
+    return CFUniCharGetCombiningPropertyForCharacter(character, (const uint8_t *)((character < 0x10000) ? combiningBMP : CFUniCharGetUnicodePropertyDataForPlane(kCFUniCharCombiningProperty, (character >> 16))));
+}
+
+CF_INLINE bool __CFStringIsCanonicallyDecomposable(UTF32Char character) {
+    if ((character >= HANGUL_SBASE) && (character < HANGUL_SBASE + HANGUL_SCOUNT)) return true;
+    return CFUniCharIsMemberOfBitmap(character, CFUniCharGetBitmapPtrForPlane(kCFUniCharCanonicalDecomposableCharacterSet, (character >> 16)));
+}
+
+// Whether a starter is left unchanged by the precomposing forms and never combines with the character before it
+static bool __CFStringIsStableInFormC(UTF32Char character) {
+    if (0 != __CFStringGetCombiningClass(character, (const uint8_t *)CFUniCharGetUnicodePropertyDataForPlane(kCFUniCharCombiningProperty, 0))) return false;
+    if (CFUniCharIsPrecomposableCombiningCharacter(character)) return false;
+    if ((character >= HANGUL_LBASE) && (character < HANGUL_LBASE + 0x100)) return false; // Conjoining jamo
+    if ((character >= HANGUL_SBASE) && (character < HANGUL_SBASE + HANGUL_SCOUNT)) return true;
+    if (!__CFStringIsCanonicallyDecomposable(character)) return true;
+
+    // Precomposed characters are stable unless they are excluded from composition
+    UTF32Char decomposed[MAX_DECOMP_BUF];
+    CFIndex decomposedLength = CFUniCharDecomposeCharacter(character, decomposed, MAX_DECOMP_BUF);
+    if (decomposedLength == 0) return false;
+    UTF32Char composed = decomposed[0];
+    for (CFIndex idx = 1; idx < decomposedLength; idx++) {
+        composed = CFUniCharPrecomposeCharacter(composed, decomposed[idx]);
+        if (composed == 0xFFFD) return false;
+    }
+    return (composed == character);
+}
+
+static uint8_t __CFStringUnstableInFormCBMP[0x10000 >> 3];
+
+static const uint8_t *__CFStringGetUnstableInFormCBitmap(void) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        for (UTF32Char character = 0x80; character < 0x10000; character++) {
+            if (!__CFStringIsStableInFormC(character)) CFUniCharAddCharacterToBitmap(character, __CFStringUnstableInFormCBMP);
+        }
+    });
+    return __CFStringUnstableInFormCBMP;
+}
+
+/* Returns how many of the characters are known to be in theForm already, or length if all of them are. Normalization can start over from that index: it is the start of a starter that nothing before it combines with. lastClass carries the combining class of the last character across calls for consecutive runs, and should start at 0.
+*/
+static CFIndex __CFStringNormalizationQuickCheck(const UTF16Char *characters, CFIndex length, CFStringNormalizationForm theForm, uint8_t *lastClass) {
+    const uint8_t *combiningBMP = (const uint8_t *)CFUniCharGetUnicodePropertyDataForPlane(kCFUniCharCombiningProperty, 0);
+    const uint8_t *unstableInFormC = ((theForm == kCFStringNormalizationFormC) ? __CFStringGetUnstableInFormCBitmap() : NULL);
+    CFIndex stableIndex = 0;
+    CFIndex idx = 0;
+
+    while (idx < length) {
+        if (idx + 4 <= length) {
+            uint64_t word;
+            memcpy(&word, characters + idx, sizeof(word));
+            if (0 == (word & 0xFF80FF80FF80FF80ULL)) { // ASCII is the same in every form
+                idx += 4;
+                stableIndex = idx - 1;
+                *lastClass = 0;
+                continue;
+            }
+        }
+
+        UTF32Char character = characters[idx];
+        CFIndex used = 1;
+        if (CFUniCharIsSurrogateHighCharacter(character) && (idx + 1 < length) && CFUniCharIsSurrogateLowCharacter(characters[idx + 1])) {
+            character = CFUniCharGetLongCharacterForSurrogatePair(character, characters[idx + 1]);
+            used = 2;
+        }
+
+        if (character >= 0x80) {
+            uint8_t currentClass = __CFStringGetCombiningClass(character, combiningBMP);
+            bool isStable;
+
+            if ((currentClass != 0) && (*lastClass > currentClass)) return stableIndex;
+
+            switch (theForm) {
+                case kCFStringNormalizationFormD:
+                    isStable = !__CFStringIsCanonicallyDecomposable(character);
+                    break;
+                case kCFStringNormalizationFormKD:
+                    isStable = !__CFStringIsCanonicallyDecomposable(character) && !CFUniCharIsMemberOf(character, kCFUniCharCompatibilityDecomposableCharacterSet);
+                    break;
+                case kCFStringNormalizationFormC:
+                    isStable = ((character < 0x10000) ? !CFUniCharIsMemberOfBitmap(character, unstableInFormC) : __CFStringIsStableInFormC(character));
+                    break;
+                default:
+                    isStable = false;
+                    break;
+            }
+            if (!isStable) return stableIndex;
+
+            if (currentClass == 0) stableIndex = idx;
+            *lastClass = currentClass;
+        } else {
+            stableIndex = idx;
+            *lastClass = 0;
+        }
+        idx += used;
+    }
+    return length;
+}
+
+#define kCFStringNormalizationQuickCheckWindowLength (512)
+
+bool _CFStringIsNormalized(CFStringRef string, CFStringNormalizationForm theForm) {
+    CFIndex length = CFStringGetLength(string);
+    const CFStringEncoding eightBitEncoding = __CFStringGetEightBitStringEncoding();
+    const uint8_t *bytes = (const uint8_t *)_CFStringGetCStringPtrInternal(string, eightBitEncoding, false, true);
+    uint8_t lastClass = 0;
+
+    if (NULL != bytes) {
+        if (theForm == kCFStringNormalizationFormC) return true; // Same as CFStringNormalize(): 8-bit contents have no decomposition
+        for (CFIndex idx = 0; idx < length; idx++) {
+            if (bytes[idx] > 127) return false;
+        }
+        return true;
+    }
+
+    const UniChar *characters = CFStringGetCharactersPtr(string);
+    if (NULL != characters) return (__CFStringNormalizationQuickCheck(characters, length, theForm, &lastClass) == length);
+
+    UniChar window[kCFStringNormalizationQuickCheckWindowLength];
+    CFIndex start = 0;
+    while (start < length) {
+        CFIndex windowLength = __CFMin(length - start, kCFStringNormalizationQuickCheckWindowLength);
+        CFStringGetCharacters(string, CFRangeMake(start, windowLength), window);
+        if ((windowLength > 1) && (start + windowLength < length) && CFUniCharIsSurrogateHighCharacter(window[windowLength - 1])) windowLength--; // Keep surrogate pairs together
+        if (__CFStringNormalizationQuickCheck(window, windowLength, theForm, &lastClass) != windowLength) return false;
+        start += windowLength;
+    }
+    return true;
+}
+
 void CFStringNormalize(CFMutableStringRef string, CFStringNormalizationForm theForm) {
     CFIndex currentIndex = 0;
     CFIndex length;
@@ -5739,6 +6240,10 @@ void CFStringNormalize(CFMutableStringRef string, CFStringNormalizationForm theF
                 break;
             }
         }
+    } else {
+        // Skip the part that is already normalized; this is usually all of it
+        uint8_t lastClass = 0;
+        currentIndex = __CFStringNormalizationQuickCheck((const UTF16Char *)__CFStrContents(string), length, theForm, &lastClass);
     }
 
     if (currentIndex < length) {
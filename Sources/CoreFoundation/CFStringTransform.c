@@ -484,29 +484,88 @@ static const char *__CFStringTransformGetICUIdentifier(CFStringRef identifier) {
     return NULL;
 }
 
-/* Main entry point
+/* Transliteration through UniChar buffers
+
+   Going through UReplaceable costs a callback for every character ICU looks at, and a CFStringReplace() plus a fresh inline buffer for every piece it replaces. Instead the string is copied out once, each transliterator runs over the buffer with utrans_transUChars(), and the result is written back with a single replace. The whole string is copied, not just the range, so the transliterators see the same context around the range as they do through UReplaceable.
 */
 
-Boolean CFStringTransform(CFMutableStringRef string, CFRange *range, CFStringRef transform, Boolean reverse)
-{
-    Boolean result = false;
-#if LITE_CACHE
-    UTransliterator *tl = __CFStringTransformAcquire(transform, (reverse != 0));
-    if (!tl) return false;
-#else
-    struct transform_element *element = __CFStringTransformAcquire(transform, (reverse != 0));
-    if (element == NULL)
-        return false;
-    UTransliterator *tl = element->_transliterator;
-#endif
+typedef struct {
+    UniChar *_text;         // The current contents
+    UniChar *_scratch;      // Each step runs here, so that _text survives a step that overflows
+    CFIndex _length;
+    CFIndex _capacity;      // Of each of _text and _scratch
+    UniChar *_allocated;    // NULL while the buffers are the ones passed to __CFStringTransformBufferInit()
+} __CFStringTransformBuffer;
+
+static void __CFStringTransformBufferInit(__CFStringTransformBuffer *buffer, UniChar *_Nullable storage, CFIndex capacity) {
+    buffer->_text = storage;
+    buffer->_scratch = storage ? storage + capacity : NULL;
+    buffer->_length = 0;
+    buffer->_capacity = storage ? capacity : 0;
+    buffer->_allocated = NULL;
+}
 
-    CFRange everything;
-    if (range == NULL) {
-        everything.location = 0;
-        everything.length = CFStringGetLength(string);
-        range = &everything;
+static void __CFStringTransformBufferDestroy(__CFStringTransformBuffer *buffer) {
+    if (buffer->_allocated) CFAllocatorDeallocate(kCFAllocatorSystemDefault, buffer->_allocated);
+    buffer->_allocated = NULL;
+}
+
+static bool __CFStringTransformBufferReserve(__CFStringTransformBuffer *buffer, CFIndex capacity) {
+    if (capacity <= buffer->_capacity) return true;
+    if (capacity > INT32_MAX) return false;
+    CFIndex newCapacity = __CFMin(__CFMax(capacity, buffer->_capacity + buffer->_capacity / 2), INT32_MAX);
+    UniChar *storage = (UniChar *)CFAllocatorAllocate(kCFAllocatorSystemDefault, 2 * newCapacity * sizeof(UniChar), 0);
+    if (storage == NULL) return false;
+    if (buffer->_length > 0) memmove(storage, buffer->_text, buffer->_length * sizeof(UniChar));
+    __CFStringTransformBufferDestroy(buffer);
+    buffer->_allocated = storage;
+    buffer->_text = storage;
+    buffer->_scratch = storage + newCapacity;
+    buffer->_capacity = newCapacity;
+    return true;
+}
+
+static bool __CFStringTransformBufferLoad(__CFStringTransformBuffer *buffer, CFStringRef string) {
+    CFIndex length = CFStringGetLength(string);
+    buffer->_length = 0;
+    /* Most transforms change the length little, so leave some room to avoid the retry after an overflow.
+    */
+    if (!__CFStringTransformBufferReserve(buffer, length + length / 4 + 16)) return false;
+    CFStringGetCharacters(string, CFRangeMake(0, length), buffer->_text);
+    buffer->_length = length;
+    return true;
+}
+
+/* Applies tl to the characters from start up to *limit, and updates *limit to the end of the result.
+*/
+static bool __CFStringTransformBufferApply(__CFStringTransformBuffer *buffer, UTransliterator *tl, CFIndex start, CFIndex *limit) {
+    for (;;) {
+        memmove(buffer->_scratch, buffer->_text, buffer->_length * sizeof(UniChar));
+        int32_t textLength = (int32_t)buffer->_length;
+        int32_t stepLimit = (int32_t)*limit;
+        UErrorCode icuStatus = U_ZERO_ERROR;
+        utrans_transUChars(tl, (UChar *)buffer->_scratch, &textLength, (int32_t)buffer->_capacity, (int32_t)start, &stepLimit, &icuStatus);
+        if (icuStatus == U_BUFFER_OVERFLOW_ERROR) {
+            /* textLength is the length the result needs. Grow and start the step over from _text.
+            */
+            if (!__CFStringTransformBufferReserve(buffer, (CFIndex)textLength + 16)) return false;
+            continue;
+        }
+        if (U_FAILURE(icuStatus)) return false;
+
+        UniChar *result = buffer->_scratch;
+        buffer->_scratch = buffer->_text;
+        buffer->_text = result;
+        buffer->_length = textLength;
+        *limit = stepLimit;
+        return true;
     }
-    
+}
+
+/* Transliteration through UReplaceable, for strings too long to copy out
+*/
+
+static bool __CFStringTransformReplaceable(CFMutableStringRef string, CFRange *range, UTransliterator *tl) {
     /* Set up the UReplaceable
     */
     _CFStringUReplaceable replaceable;
@@ -527,10 +586,56 @@ Boolean CFStringTransform(CFMutableStringRef string, CFRange *range, CFStringRef
         CFRelease(replaceable._externalMutable);
     }
 
-    if (U_SUCCESS(icuStatus)) {
-        range->length = limit - range->location;
-        result = true;
+    if (U_FAILURE(icuStatus)) return false;
+    range->length = limit - range->location;
+    return true;
+}
+
+/* Writes the transformed range back over the original one
+*/
+static void __CFStringTransformBufferStore(__CFStringTransformBuffer *buffer, CFMutableStringRef string, CFRange range, CFIndex limit) {
+    CFStringRef replacement = CFStringCreateWithCharactersNoCopy(kCFAllocatorSystemDefault, buffer->_text + range.location, limit - range.location, kCFAllocatorNull);
+    CFStringReplace(string, range, replacement);
+    CFRelease(replacement);
+}
+
+/* Main entry point
+*/
+
+Boolean CFStringTransform(CFMutableStringRef string, CFRange *range, CFStringRef transform, Boolean reverse)
+{
+    Boolean result = false;
+#if LITE_CACHE
+    UTransliterator *tl = __CFStringTransformAcquire(transform, (reverse != 0));
+    if (!tl) return false;
+#else
+    struct transform_element *element = __CFStringTransformAcquire(transform, (reverse != 0));
+    if (element == NULL)
+        return false;
+    UTransliterator *tl = element->_transliterator;
+#endif
+
+    CFRange everything;
+    if (range == NULL) {
+        everything.location = 0;
+        everything.length = CFStringGetLength(string);
+        range = &everything;
+    }
+    
+    UniChar stackStorage[2 * kCFStringTransformStackBufferSize];
+    __CFStringTransformBuffer buffer;
+    __CFStringTransformBufferInit(&buffer, stackStorage, kCFStringTransformStackBufferSize);
+    if (__CFStringTransformBufferLoad(&buffer, string)) {
+        CFIndex limit = range->location + range->length;
+        if (__CFStringTransformBufferApply(&buffer, tl, range->location, &limit)) {
+            __CFStringTransformBufferStore(&buffer, string, *range, limit);
+            range->length = limit - range->location;
+            result = true;
+        }
+    } else {
+        result = __CFStringTransformReplaceable(string, range, tl);
     }
+    __CFStringTransformBufferDestroy(&buffer);
 
 #if LITE_CACHE
     __CFStringTransformRelease(transform, (reverse != 0), tl);
@@ -541,4 +646,208 @@ Boolean CFStringTransform(CFMutableStringRef string, CFRange *range, CFStringRef
     return result;
 }
 
+/* Transformers
+
+   A transformer applies a fixed list of transforms in sequence. The transforms are looked up once, when the transformer is created, and are kept as prototypes. Each call takes an instance, which holds clones of the prototypes together with the buffers they run over, from the transformer's idle list, or clones a new one if every instance is in use on another thread. So after the first few calls, applying a transformer neither opens transliterators nor allocates buffers.
+*/
+
+#define kCFStringTransformerMaxIdleInstances 8
+
+struct __CFStringTransformerInstance {
+    struct __CFStringTransformerInstance *_next;
+    __CFStringTransformBuffer _buffer;
+    UTransliterator *_transliterators[];
+};
+
+struct _CFStringTransformer {
+    CFLock_t _lock;
+    struct __CFStringTransformerInstance *_idle;    // Guarded by _lock
+    CFIndex _idleCount;                             // Guarded by _lock
+    CFIndex _count;
+    UTransliterator *_prototypes[];
+};
+
+/* Clones the transliterator for a transform from the transform cache, or creates it
+*/
+static UTransliterator *__CFStringTransformCopyTransliterator(CFStringRef identifier, bool reverse) {
+#if LITE_CACHE
+    UTransliterator *tl = __CFStringTransformAcquire(identifier, reverse);
+    if (!tl) return NULL;
+#else
+    struct transform_element *element = __CFStringTransformAcquire(identifier, reverse);
+    if (element == NULL)
+        return NULL;
+    UTransliterator *tl = element->_transliterator;
+#endif
+
+    UErrorCode icuStatus = U_ZERO_ERROR;
+    UTransliterator *copy = utrans_clone(tl, &icuStatus);
+
+#if LITE_CACHE
+    __CFStringTransformRelease(identifier, reverse, tl);
+#else
+    __CFStringTransformRelease(identifier, reverse, element);
+#endif
+
+    if (U_FAILURE(icuStatus)) {
+        if (copy)
+            utrans_close(copy);
+        return NULL;
+    }
+    return copy;
+}
+
+static void __CFStringTransformerInstanceDestroy(_CFStringTransformerRef transformer, struct __CFStringTransformerInstance *instance) {
+    for (CFIndex idx = 0; idx < transformer->_count; idx++) {
+        if (instance->_transliterators[idx])
+            utrans_close(instance->_transliterators[idx]);
+    }
+    __CFStringTransformBufferDestroy(&instance->_buffer);
+    CFAllocatorDeallocate(kCFAllocatorSystemDefault, instance);
+}
+
+static struct __CFStringTransformerInstance *_Nullable __CFStringTransformerAcquire(_CFStringTransformerRef transformer) {
+    __CFLock(&transformer->_lock);
+    struct __CFStringTransformerInstance *instance = transformer->_idle;
+    if (instance) {
+        transformer->_idle = instance->_next;
+        transformer->_idleCount--;
+        __CFUnlock(&transformer->_lock);
+        return instance;
+    }
+    __CFUnlock(&transformer->_lock);
+
+    instance = (struct __CFStringTransformerInstance *)CFAllocatorAllocate(kCFAllocatorSystemDefault, sizeof(struct __CFStringTransformerInstance) + transformer->_count * sizeof(UTransliterator *), 0);
+    if (instance == NULL)
+        return NULL;
+    instance->_next = NULL;
+    __CFStringTransformBufferInit(&instance->_buffer, NULL, 0);
+    memset(instance->_transliterators, 0, transformer->_count * sizeof(UTransliterator *));
+
+    /* Cloning only reads the prototype, but ICU does not promise that is safe while another thread clones the same one.
+    */
+    bool failed = false;
+    __CFLock(&transformer->_lock);
+    for (CFIndex idx = 0; idx < transformer->_count && !failed; idx++) {
+        UErrorCode icuStatus = U_ZERO_ERROR;
+        instance->_transliterators[idx] = utrans_clone(transformer->_prototypes[idx], &icuStatus);
+        failed = U_FAILURE(icuStatus) || instance->_transliterators[idx] == NULL;
+    }
+    __CFUnlock(&transformer->_lock);
+
+    if (failed) {
+        __CFStringTransformerInstanceDestroy(transformer, instance);
+        return NULL;
+    }
+    return instance;
+}
+
+static void __CFStringTransformerRelease(_CFStringTransformerRef transformer, struct __CFStringTransformerInstance *instance) {
+    __CFLock(&transformer->_lock);
+    if (transformer->_idleCount < kCFStringTransformerMaxIdleInstances) {
+        instance->_next = transformer->_idle;
+        transformer->_idle = instance;
+        transformer->_idleCount++;
+        instance = NULL;
+    }
+    __CFUnlock(&transformer->_lock);
+    if (instance)
+        __CFStringTransformerInstanceDestroy(transformer, instance);
+}
+
+/* Runs every step of the transformer over the range of the string in the instance's buffer
+*/
+static bool __CFStringTransformerRun(_CFStringTransformerRef transformer, struct __CFStringTransformerInstance *instance, CFStringRef string, CFRange range, CFIndex *limit) {
+    if (!__CFStringTransformBufferLoad(&instance->_buffer, string))
+        return false;
+    *limit = range.location + range.length;
+    for (CFIndex idx = 0; idx < transformer->_count; idx++) {
+        if (!__CFStringTransformBufferApply(&instance->_buffer, instance->_transliterators[idx], range.location, limit))
+            return false;
+    }
+    return true;
+}
+
+_CFStringTransformerRef _Nullable _CFStringTransformerCreate(CFArrayRef transforms, bool reverse) {
+    CFIndex count = CFArrayGetCount(transforms);
+    struct _CFStringTransformer *transformer = (struct _CFStringTransformer *)CFAllocatorAllocate(kCFAllocatorSystemDefault, sizeof(struct _CFStringTransformer) + count * sizeof(UTransliterator *), 0);
+    if (transformer == NULL)
+        return NULL;
+    transformer->_lock = CFLockInit;
+    transformer->_idle = NULL;
+    transformer->_idleCount = 0;
+    transformer->_count = count;
+    memset(transformer->_prototypes, 0, count * sizeof(UTransliterator *));
+
+    /* Each transform gets its own transliterator rather than being joined into one compound ID, since some of the predefined transforms begin with a global filter, which is only allowed at the start of an ID. Reversed, the last transform runs first.
+    */
+    for (CFIndex idx = 0; idx < count; idx++) {
+        CFStringRef identifier = (CFStringRef)CFArrayGetValueAtIndex(transforms, reverse ? count - 1 - idx : idx);
+        transformer->_prototypes[idx] = __CFStringTransformCopyTransliterator(identifier, reverse);
+        if (transformer->_prototypes[idx] == NULL) {
+            _CFStringTransformerDestroy(transformer);
+            return NULL;
+        }
+    }
+    return transformer;
+}
+
+void _CFStringTransformerDestroy(_CFStringTransformerRef transformer) {
+    struct __CFStringTransformerInstance *instance = transformer->_idle;
+    while (instance) {
+        struct __CFStringTransformerInstance *next = instance->_next;
+        __CFStringTransformerInstanceDestroy(transformer, instance);
+        instance = next;
+    }
+    for (CFIndex idx = 0; idx < transformer->_count; idx++) {
+        if (transformer->_prototypes[idx])
+            utrans_close(transformer->_prototypes[idx]);
+    }
+    CFAllocatorDeallocate(kCFAllocatorSystemDefault, transformer);
+}
+
+bool _CFStringTransformerApply(_CFStringTransformerRef transformer, CFMutableStringRef string, CFRange *range) {
+    CFRange everything;
+    if (range == NULL) {
+        everything = CFRangeMake(0, CFStringGetLength(string));
+        range = &everything;
+    }
+    struct __CFStringTransformerInstance *instance = __CFStringTransformerAcquire(transformer);
+    if (instance == NULL)
+        return false;
+
+    CFIndex limit;
+    bool result = __CFStringTransformerRun(transformer, instance, string, *range, &limit);
+    if (result) {
+        __CFStringTransformBufferStore(&instance->_buffer, string, *range, limit);
+        range->length = limit - range->location;
+    }
+    __CFStringTransformerRelease(transformer, instance);
+    return result;
+}
+
+CFArrayRef _Nullable _CFStringTransformerCreateArrayByApplying(_CFStringTransformerRef transformer, CFArrayRef strings) {
+    struct __CFStringTransformerInstance *instance = __CFStringTransformerAcquire(transformer);
+    if (instance == NULL)
+        return NULL;
+
+    CFIndex count = CFArrayGetCount(strings);
+    CFMutableArrayRef results = CFArrayCreateMutable(kCFAllocatorSystemDefault, 0, &kCFTypeArrayCallBacks);
+    for (CFIndex idx = 0; idx < count; idx++) {
+        CFStringRef string = (CFStringRef)CFArrayGetValueAtIndex(strings, idx);
+        CFIndex limit;
+        if (!__CFStringTransformerRun(transformer, instance, string, CFRangeMake(0, CFStringGetLength(string)), &limit)) {
+            CFRelease(results);
+            results = NULL;
+            break;
+        }
+        /* The whole string was transformed, so the buffer is the result.
+        */
+        CFStringRef result = CFStringCreateWithCharacters(kCFAllocatorSystemDefault, instance->_buffer._text, limit);
+        CFArrayAppendValue(results, result);
+        CFRelease(result);
+    }
+    __CFStringTransformerRelease(transformer, instance);
+    return results;
+}
 
@@ -426,21 +426,107 @@ static UCollator *__CFStringCopyDefaultCollator(CFLocaleRef compareLocale) {
 }
 
 #if TARGET_OS_MAC || TARGET_OS_WIN32 || TARGET_OS_LINUX || TARGET_OS_WASI
-static void __collatorFinalize(UCollator *collator) {
-    CFLocaleRef locale = _CFGetTSD(__CFTSDKeyCollatorLocale);
-    _CFSetTSD(__CFTSDKeyCollatorUCollator, NULL, NULL);
-    _CFSetTSD(__CFTSDKeyCollatorLocale, NULL, NULL);
-    os_unfair_lock_lock_with_options(&__CFDefaultCollatorLock, OS_UNFAIR_LOCK_DATA_SYNCHRONIZATION);
-    if ((__CFDefaultCollatorLocale == locale) && (__CFDefaultCollatorsCount < kCFMaxCachedDefaultCollators)) {
-        __CFDefaultCollators[__CFDefaultCollatorsCount++] = collator;
-        collator = NULL;
+// Each thread keeps the collators it used most recently, so that comparing in a few locales in turn, or creating sort keys with different options, neither reopens collators nor takes __CFDefaultCollatorLock.
+// Entries are matched by the locale's collator identifier, so that equivalent locales created separately share a collator. The locale of the last lookup is remembered as well, which lets repeated lookups with the same locale skip the identifier comparison.
+#define kCFMaxCachedThreadCollators (4)
+
+// The options that change how a collator for sort keys is configured.
+#define __kCFCollatorSortKeyOptions (kCFCompareCaseInsensitive | kCFCompareDiacriticInsensitive | kCFCompareNumerically)
+// Marks collators configured for sort keys. Collators without it keep the defaults set by __CFStringCreateCollator, which __CompareTextDefault relies on.
+#define __kCFCollatorConfiguredForSortKeys (1UL << 31)
+
+typedef struct {
+    CFLocaleRef locale;
+    CFStringRef collatorID;
+    CFOptionFlags configuration;
+    UCollator *collator;
+} __CFThreadCollator;
+
+typedef struct {
+    CFIndex count;
+    __CFThreadCollator entries[kCFMaxCachedThreadCollators]; // Most recently used first
+} __CFThreadCollatorCache;
+
+static void __CFThreadCollatorRelease(__CFThreadCollator *entry) {
+    UCollator *collator = entry->collator;
+    if (0 == entry->configuration) {
+        os_unfair_lock_lock_with_options(&__CFDefaultCollatorLock, OS_UNFAIR_LOCK_DATA_SYNCHRONIZATION);
+        if ((__CFDefaultCollatorLocale == entry->locale) && (__CFDefaultCollatorsCount < kCFMaxCachedDefaultCollators)) {
+            __CFDefaultCollators[__CFDefaultCollatorsCount++] = collator;
+            collator = NULL;
+        }
+        os_unfair_lock_unlock(&__CFDefaultCollatorLock);
     }
-    os_unfair_lock_unlock(&__CFDefaultCollatorLock);
     if (NULL != collator) ucol_close(collator);
-#ifndef __clang_analyzer__
-    // This release is unbalanced from perspective of analyzer, but it is retained when __CFTSDKeyCollatorLocale is set
-    if (locale) CFRelease(locale);
-#endif
+    CFRelease(entry->locale);
+    CFRelease(entry->collatorID);
+}
+
+static void __collatorFinalize(__CFThreadCollatorCache *cache) {
+    for (CFIndex idx = 0; idx < cache->count; idx++) {
+        __CFThreadCollatorRelease(&cache->entries[idx]);
+    }
+    free(cache);
+}
+
+static Boolean __CFStringConfigureCollatorForSortKeys(UCollator *collator, CFOptionFlags options) {
+    UErrorCode icuStatus = U_ZERO_ERROR;
+    ucol_setAttribute(collator, UCOL_NORMALIZATION_MODE, UCOL_ON, &icuStatus);
+    ucol_setAttribute(collator, UCOL_STRENGTH, (options & kCFCompareDiacriticInsensitive) ? UCOL_PRIMARY : ((options & kCFCompareCaseInsensitive) ? UCOL_SECONDARY : UCOL_TERTIARY), &icuStatus);
+    ucol_setAttribute(collator, UCOL_CASE_LEVEL, (options & kCFCompareCaseInsensitive) ? UCOL_OFF : UCOL_ON, &icuStatus);
+    ucol_setAttribute(collator, UCOL_NUMERIC_COLLATION, (options & kCFCompareNumerically) ? UCOL_ON : UCOL_OFF, &icuStatus);
+    return U_SUCCESS(icuStatus);
+}
+
+// Returns a collator for compareLocale configured as described by configuration. The collator remains owned by the calling thread's cache; it must not be closed, and is only valid until the next lookup on this thread.
+static UCollator *__CFStringGetThreadCollator(CFLocaleRef compareLocale, CFOptionFlags configuration) {
+    __CFThreadCollatorCache *cache = (__CFThreadCollatorCache *)_CFGetTSD(__CFTSDKeyCollatorUCollator);
+    if (NULL == cache) {
+        cache = (__CFThreadCollatorCache *)calloc(1, sizeof(__CFThreadCollatorCache));
+        if (NULL == cache) return NULL;
+        _CFSetTSD(__CFTSDKeyCollatorUCollator, cache, (void *)__collatorFinalize);
+    }
+
+    CFStringRef collatorID = NULL;
+    CFIndex idx;
+    for (idx = 0; idx < cache->count; idx++) {
+        __CFThreadCollator *entry = &cache->entries[idx];
+        if (entry->configuration != configuration) continue;
+        if (entry->locale == compareLocale) break;
+        if (NULL == collatorID) collatorID = (CFStringRef)CFLocaleGetValue(compareLocale, __kCFLocaleCollatorID);
+        if (CFEqual(collatorID, entry->collatorID)) {
+            CFRetain(compareLocale);
+            CFRelease(entry->locale);
+            entry->locale = compareLocale;
+            break;
+        }
+    }
+
+    __CFThreadCollator found;
+    if (idx < cache->count) {
+        if (0 == idx) return cache->entries[0].collator;
+        found = cache->entries[idx];
+    } else {
+        UCollator *collator = (0 == configuration) ? __CFStringCopyDefaultCollator(compareLocale) : NULL;
+        if (NULL == collator) collator = __CFStringCreateCollator(compareLocale);
+        if (NULL == collator) return NULL;
+        if ((0 != configuration) && !__CFStringConfigureCollatorForSortKeys(collator, configuration)) {
+            ucol_close(collator);
+            return NULL;
+        }
+        if (NULL == collatorID) collatorID = (CFStringRef)CFLocaleGetValue(compareLocale, __kCFLocaleCollatorID);
+        found.locale = (CFLocaleRef)CFRetain(compareLocale);
+        found.collatorID = (CFStringRef)CFRetain(collatorID);
+        found.configuration = configuration;
+        found.collator = collator;
+        if (cache->count == kCFMaxCachedThreadCollators) {
+            __CFThreadCollatorRelease(&cache->entries[--cache->count]);
+        }
+        idx = cache->count++;
+    }
+    memmove(&cache->entries[1], &cache->entries[0], idx * sizeof(__CFThreadCollator));
+    cache->entries[0] = found;
+    return found.collator;
 }
 #endif
 
@@ -612,18 +698,8 @@ CF_PRIVATE CFComparisonResult _CFCompareStringsWithLocale(CFStringInlineBuffer *
     }
 
 #if TARGET_OS_MAC || TARGET_OS_WIN32 || TARGET_OS_LINUX || TARGET_OS_WASI
-    // First we try to use the last one used on this thread, if the locale is the same,
-    // otherwise we try to check out a default one, or then we create one.
-    UCollator *threadCollator = _CFGetTSD(__CFTSDKeyCollatorUCollator);
-    CFLocaleRef threadLocale = _CFGetTSD(__CFTSDKeyCollatorLocale);
-    if (compareLocale == threadLocale) {
-	collator = threadCollator;
-    } else {
-	collator = __CFStringCopyDefaultCollator((CFLocaleRef)compareLocale);
-	if (NULL == collator) {
-	    collator = __CFStringCreateCollator((CFLocaleRef)compareLocale);
-	}
-    }
+    // The thread's cache checks out a default collator, or creates one, the first time it sees the locale.
+    collator = __CFStringGetThreadCollator((CFLocaleRef)compareLocale, 0);
 #endif
 
     characters1 = CFStringGetCharactersPtrFromInlineBuffer(str1, range1);
@@ -753,20 +829,37 @@ CF_PRIVATE CFComparisonResult _CFCompareStringsWithLocale(CFStringInlineBuffer *
         if (buffer2Len > 0) CFAllocatorDeallocate(kCFAllocatorSystemDefault, buffer2);
     }
 
+    return compResult;
+}
+
+
+CFIndex _CFStringGetCollationSortKey(CFStringRef string, CFRange range, CFOptionFlags options, CFLocaleRef locale, uint8_t *buffer, CFIndex bufferLength) {
 #if TARGET_OS_MAC || TARGET_OS_WIN32 || TARGET_OS_LINUX || TARGET_OS_WASI
-    if (collator == threadCollator) {
-	// do nothing, already cached
-    } else {
-	if (threadLocale) __collatorFinalize((UCollator *)_CFGetTSD(__CFTSDKeyCollatorUCollator)); // need to dealloc collators
+    if ((range.length > INT32_MAX) || (NULL == locale)) return 0;
 
-	_CFSetTSD(__CFTSDKeyCollatorUCollator, collator, (void *)__collatorFinalize);
-#ifndef __clang_analyzer__
-        // This retain is unbalanced from perspective of analyzer, but it is released in __collatorFinalize
-	_CFSetTSD(__CFTSDKeyCollatorLocale, (void *)CFRetain(compareLocale), NULL);
-#endif
+    UCollator *collator = __CFStringGetThreadCollator(locale, __kCFCollatorConfiguredForSortKeys | (options & __kCFCollatorSortKeyOptions));
+    if (NULL == collator) return 0;
+
+    UniChar sBuffer[kCFStringCompareAllocationIncrement];
+    UniChar *allocated = NULL;
+    const UniChar *characters = CFStringGetCharactersPtr(string);
+    if (NULL != characters) {
+        characters += range.location;
+    } else {
+        UniChar *copied = sBuffer;
+        if (range.length > kCFStringCompareAllocationIncrement) {
+            allocated = copied = (UniChar *)CFAllocatorAllocate(kCFAllocatorSystemDefault, sizeof(UniChar) * range.length, 0);
+            if (!allocated) __CFStringHandleOutOfMemory(NULL);
+        }
+        CFStringGetCharacters(string, range, copied);
+        characters = copied;
     }
+
+    int32_t length = ucol_getSortKey(collator, (const UChar *)characters, (int32_t)range.length, buffer, (int32_t)__CFMin(bufferLength, INT32_MAX));
+
+    if (allocated) CFAllocatorDeallocate(kCFAllocatorSystemDefault, allocated);
+    return length;
+#else
+    return 0;
 #endif
-    
-    return compResult;
 }
-
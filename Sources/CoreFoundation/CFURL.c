@@ -179,6 +179,14 @@ struct _CFURLAdditionalData {
     UInt32 _additionalDataFlags; // these flags only apply to things we need to keep state for in _CFURLAdditionalData (like the XXXX_DIFFERS flags)
 };
 
+//	The component accessors are called over and over on the same URL by networking code, so the strings they
+//	return are kept here once created.  The first row holds components as they appear in _string, the second
+//	row the same components with percent escapes removed.  Slots are filled with compare-and-swap and never
+//	change afterwards, so readers need no lock.
+struct _CFURLComponentCache {
+    _Atomic(CFStringRef) _strings[2][MAX_COMPONENTS];
+};
+
 struct __CFURL {
     CFRuntimeBase _cfBase;
     UInt32 _flags;
@@ -187,6 +195,7 @@ struct __CFURL {
     CFURLRef _base;
     struct _CFURLAdditionalData* _extra;
     _Atomic(void *)_resourceInfo;    // For use by CoreServicesInternal to cache property values. Retained and released by CFURL.
+    _Atomic(struct _CFURLComponentCache *) _componentCache; // Allocated the first time a component string is copied
 #if DEPLOYMENT_RUNTIME_SWIFT
     CFRange _ranges[9]; // constant length (9) array of ranges in Swift
 #else
@@ -1645,6 +1654,16 @@ static void __CFURLDeallocate(CFTypeRef  cf) {
     if (url->_base) CFRelease(url->_base);
     if (url->_extra && url->_extra->_sanitizedString) CFRelease(url->_extra->_sanitizedString);
     if ( url->_extra != NULL ) CFAllocatorDeallocate( alloc, url->_extra );
+    struct _CFURLComponentCache *componentCache = atomic_load(&((struct __CFURL *)url)->_componentCache);
+    if (componentCache) {
+        for (CFIndex row = 0; row < 2; row++) {
+            for (CFIndex idx = 0; idx < MAX_COMPONENTS; idx++) {
+                CFStringRef str = atomic_load(&componentCache->_strings[row][idx]);
+                if (str) CFRelease(str);
+            }
+        }
+        CFAllocatorDeallocate(alloc, componentCache);
+    }
     void *resourceInfo = _getResourceInfo(url);
 #if DEPLOYMENT_RUNTIME_SWIFT
     if (resourceInfo) _CFSwiftRelease(resourceInfo);
@@ -1727,6 +1746,27 @@ static void constructBuffers(CFAllocatorRef alloc, CFStringRef string, UInt8 *in
 
     length = CFStringGetLength(string);
     rg = CFRangeMake(0, length);
+    // Nearly all URL strings are ASCII, so copy the characters out as bytes in a single pass rather than measuring
+    // first; only if that stops early is it worth finding out whether the string has to be widened to UTF-16.
+    {
+        char *buf;
+        if ( (inBuffer != NULL) && (length <= inBufferSize) ) {
+            buf = (char *)inBuffer;
+            *freeCharacters = false;
+        }
+        else {
+            buf = (char *)malloc(length);
+            *freeCharacters = true;
+        }
+        if (CFStringGetBytes(string, rg, kCFStringEncodingASCII, 0, false, (uint8_t *)buf, length, NULL) == length) {
+            *cstring = buf;
+            *useCString = true;
+            return;
+        }
+        if (*freeCharacters) {
+            free(buf);
+        }
+    }
     CFStringGetBytes(string, rg, kCFStringEncodingISOLatin1, 0, false, NULL, INT_MAX, &neededLength);
     if (neededLength == length) {
         char *buf;
@@ -3059,7 +3099,7 @@ static CFRange _rangeForComponent(UInt32 flags, const CFRange *ranges, UInt32 co
     return ranges[idx];
 }
  
-static CFStringRef _retainedComponentString(CFURLRef url, UInt32 compFlag, Boolean fromOriginalString, Boolean removePercentEscapes) CF_RETURNS_RETAINED {
+static CFStringRef _createComponentString(CFURLRef url, UInt32 compFlag, Boolean fromOriginalString, Boolean removePercentEscapes) CF_RETURNS_RETAINED {
     CFRange rg;
     CFStringRef comp;
     CFAllocatorRef alloc = CFGetAllocator(url);
@@ -3127,6 +3167,45 @@ static CFStringRef _retainedComponentString(CFURLRef url, UInt32 compFlag, Boole
     return comp;
 }
 
+static CFStringRef _retainedComponentString(CFURLRef url, UInt32 compFlag, Boolean fromOriginalString, Boolean removePercentEscapes) CF_RETURNS_RETAINED {
+    if (!(url->_flags & compFlag)) {
+        return NULL;
+    }
+    // Corrected components only exist for URLs whose string had to be sanitized; those are rare, so they are not cached.
+    Boolean corrected = !fromOriginalString && !removePercentEscapes && !(url->_flags & ORIGINAL_AND_URL_STRINGS_MATCH) && (_getAdditionalDataFlags(url) & compFlag);
+    if (corrected) {
+        return _createComponentString(url, compFlag, fromOriginalString, removePercentEscapes);
+    }
+    
+    struct __CFURL *mutableURL = (struct __CFURL *)url;
+    struct _CFURLComponentCache *cache = atomic_load_explicit(&mutableURL->_componentCache, memory_order_acquire);
+    if (!cache) {
+        struct _CFURLComponentCache *newCache = (struct _CFURLComponentCache *)CFAllocatorAllocate(CFGetAllocator(url), sizeof(struct _CFURLComponentCache), 0);
+        memset(newCache, 0, sizeof(struct _CFURLComponentCache));
+        if (atomic_compare_exchange_strong_explicit(&mutableURL->_componentCache, &cache, newCache, memory_order_acq_rel, memory_order_acquire)) {
+            cache = newCache;
+        } else {
+            // 'cache' now holds the one another thread installed.
+            CFAllocatorDeallocate(CFGetAllocator(url), newCache);
+        }
+    }
+    
+    _Atomic(CFStringRef) *slot = &cache->_strings[removePercentEscapes ? 1 : 0][__builtin_ctz(compFlag)];
+    CFStringRef comp = atomic_load_explicit(slot, memory_order_acquire);
+    if (!comp) {
+        CFStringRef newComp = _createComponentString(url, compFlag, true, removePercentEscapes);
+        if (!newComp) {
+            return NULL;
+        }
+        if (atomic_compare_exchange_strong_explicit(slot, &comp, newComp, memory_order_acq_rel, memory_order_acquire)) {
+            comp = newComp;
+        } else {
+            CFRelease(newComp);
+        }
+    }
+    return (CFStringRef)CFRetain(comp);
+}
+
 CFStringRef  CFURLCopyScheme(CFURLRef  anURL) {
     CFStringRef scheme;
     if (CF_IS_OBJC(CFURLGetTypeID(), anURL)) {
@@ -89,6 +89,11 @@ UTF32Char CFUniCharPrecomposeCharacter(UTF32Char base, UTF32Char combining) {
     return (value ? value : 0xFFFD);
 }
 
+CF_PRIVATE
+bool CFUniCharIsPrecomposableCombiningCharacter(UTF32Char character) {
+    return (0 != __CFUniCharGetMappedValue_P((const __CFUniCharPrecomposeMappings *)__CFUniCharPrecompSourceTable, __CFUniCharPrecompositionTableLength, character));
+}
+
 #define HANGUL_SBASE 0xAC00
 #define HANGUL_LBASE 0x1100
 #define HANGUL_VBASE 0x1161
@@ -538,6 +538,28 @@ CF_INLINE bool CFCharacterSetInlineBufferIsLongCharacterMember(const CFCharacter
 #define CFCharacterSetInlineBufferIsLongCharacterMember(buffer, character) (CFCharacterSetIsLongCharacterMember(buffer->cset, character))
 #endif /* CF_INLINE */
 
+/*!
+@function _CFCharacterSetInlineBufferFindCharacter
+ Finds the first (or last) character in a UTF-16 buffer that is (or is not) in the character set.
+ Surrogate pairs are tested as one character; unpaired surrogates are never members.
+	@param buffer The reference to the inline buffer to be searched.
+	@param characters The UTF-16 characters to scan.
+	@param length The number of UTF-16 units in characters.
+	@param findNonMembers If true, the scan stops at the first character that is not in the character set.
+	@param backwards If true, the scan starts at the end of characters.
+ @result The range of the character found, 1 or 2 units long, or {kCFNotFound, 0}.
+ */
+CF_EXPORT
+CFRange _CFCharacterSetInlineBufferFindCharacter(const CFCharacterSetInlineBuffer *buffer, const UniChar *characters, CFIndex length, bool findNonMembers, bool backwards);
+
+/*!
+@function _CFCharacterSetInlineBufferFindByte
+ Same as _CFCharacterSetInlineBufferFindCharacter, for a buffer of ISO Latin-1 (or ASCII) characters.
+ @result The index of the character found, or kCFNotFound.
+ */
+CF_EXPORT
+CFIndex _CFCharacterSetInlineBufferFindByte(const CFCharacterSetInlineBuffer *buffer, const uint8_t *bytes, CFIndex length, bool findNonMembers, bool backwards);
+
 
 #if TARGET_OS_WIN32
 CF_EXPORT CFMutableStringRef _CFCreateApplicationRepositoryPath(CFAllocatorRef alloc, int nFolder);
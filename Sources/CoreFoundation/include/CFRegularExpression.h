@@ -63,6 +63,9 @@ void _CFRegularExpressionEnumerateMatchesInString(_CFRegularExpressionRef regexO
 CFStringRef _CFRegularExpressionGetPattern(_CFRegularExpressionRef regex);
 _CFRegularExpressionOptions _CFRegularExpressionGetOptions(_CFRegularExpressionRef regex);
 
+// How many matches had to clone the compiled expression, and how many reused the expression itself or a pooled clone.
+void _CFRegularExpressionGetMatcherStatistics(_CFRegularExpressionRef regex, CFIndex *_Nullable cloneCount, CFIndex *_Nullable reuseCount);
+
 CF_IMPLICIT_BRIDGING_DISABLED
 CF_ASSUME_NONNULL_END
 #endif /* __COREFOUNDATION_CFREGULAREXPRESSION__ */
@@ -395,6 +395,46 @@ CF_EXPORT CFStringRef const _kCFStringFormatMetadataArgumentObjectKey;
 CF_EXPORT CFStringRef const _kCFStringFormatMetadataArgumentNumberKey;
 CF_EXPORT CFStringRef _Nullable _CFStringCreateWithFormatAndArgumentsReturningMetadata(CFAllocatorRef _Nullable alloc, CFStringRef _Nonnull (*_Nullable copyDescFunc)(void *, const void *loc), CFStringRef _Nonnull (*_Nullable contextDescFunc)(void *, const void *, const void *, bool, bool *), CFDictionaryRef _Nullable formatOptions, CFDictionaryRef _Nullable formatConfiguration, CFStringRef format, CFArrayRef _Nullable *_Nullable outMetadata, va_list arguments);
 
+/* Calls handler with each occurrence of stringToFind in rangeToSearch that repeated calls to CFStringFindWithOptionsAndLocale(), each continuing past the previous occurrence, would find, until handler returns false. Returns the number of occurrences passed to handler. CFStringCreateArrayWithFindResults() and CFStringFindAndReplace() are built on this.
+*/
+CF_EXPORT CFIndex _CFStringFindAllWithOptionsAndLocale(CFStringRef string, CFStringRef stringToFind, CFRange rangeToSearch, CFStringCompareFlags compareOptions, CFLocaleRef _Nullable locale, void *_Nullable context, bool (*handler)(void *_Nullable context, CFRange foundRange));
+
+/* Finds the bounds of up to maxCount consecutive lines, or paragraphs if paragraphs is true, in one forward pass. The first line starts at range.location, which must be the start of a line, and lines are reported until one reaches the end of the range; the last may extend past it. Each line's range includes its terminator, and contentsEnds receives the end of its contents. Returns the number of lines found; call again from the end of the last one for more.
+*/
+CF_EXPORT CFIndex _CFStringGetLineBoundsInRange(CFStringRef string, CFRange range, bool paragraphs, CFRange *lineRanges, CFIndex *_Nullable contentsEnds, CFIndex maxCount);
+
+/* Same as CFStringFindCharacterFromSet(), but finds characters that are not in theSet if findNonMembers is true. Surrogate pairs are tested as one character and unpaired surrogates are never members.
+*/
+CF_EXPORT bool _CFStringFindCharacterFromSet(CFStringRef theString, CFCharacterSetRef theSet, CFRange rangeToSearch, CFStringCompareFlags searchOptions, bool findNonMembers, CFRange *_Nullable result);
+
+/* Whether CFStringNormalize() would leave string unchanged, checked in one pass without allocating. This can report false for some strings that are normalized already.
+*/
+CF_EXPORT bool _CFStringIsNormalized(CFStringRef string, CFStringNormalizationForm theForm);
+
+/* Writes the ICU sort key of the characters in range to buffer, configured by the kCFCompareCaseInsensitive, kCFCompareDiacriticInsensitive and kCFCompareNumerically options. Keys compare bytewise with memcmp(). Returns the length of the whole key including its terminating zero byte, which may exceed bufferLength; pass a NULL buffer to measure. Returns 0 on failure.
+*/
+CF_EXPORT CFIndex _CFStringGetCollationSortKey(CFStringRef string, CFRange range, CFOptionFlags options, CFLocaleRef locale, uint8_t *_Nullable buffer, CFIndex bufferLength);
+
+/* Hash and equality for case-insensitive string keys: strings that are equal under CFStringCompare() with kCFCompareCaseInsensitive hash to the same value. The dictionary key callbacks copy their keys, like kCFCopyStringDictionaryKeyCallBacks.
+*/
+CF_EXPORT CFHashCode _CFStringHashCaseInsensitive(CFStringRef string);
+CF_EXPORT bool _CFStringEqualCaseInsensitive(CFStringRef string1, CFStringRef string2);
+CF_EXPORT const CFDictionaryKeyCallBacks _kCFCaseInsensitiveStringDictionaryKeyCallBacks;
+
+/* A transformer applies a list of CFStringTransform() transforms in sequence, in reverse order and each one reversed if reverse is true. It looks the transforms up once, and keeps the transliterators and buffers it runs them with between calls, so applying it repeatedly neither opens transliterators nor allocates buffers. A transformer can be used from several threads at once. Create returns NULL if any of the transforms is invalid.
+*/
+typedef struct _CFStringTransformer *_CFStringTransformerRef;
+CF_EXPORT _CFStringTransformerRef _Nullable _CFStringTransformerCreate(CFArrayRef transforms, bool reverse);
+CF_EXPORT void _CFStringTransformerDestroy(_CFStringTransformerRef transformer);
+
+/* Same as CFStringTransform(), with the transformer's transforms.
+*/
+CF_EXPORT bool _CFStringTransformerApply(_CFStringTransformerRef transformer, CFMutableStringRef string, CFRange *_Nullable range);
+
+/* Returns the results of applying the transformer to each of strings, or NULL if any of them fails.
+*/
+CF_EXPORT CFArrayRef _Nullable _CFStringTransformerCreateArrayByApplying(_CFStringTransformerRef transformer, CFArrayRef strings);
+
 /* For NSString (and NSAttributedString) usage, mutate with isMutable check
 */
 enum {_CFStringErrNone = 0, _CFStringErrNotMutable = 1, _CFStringErrNilArg = 2, _CFStringErrBounds = 3};
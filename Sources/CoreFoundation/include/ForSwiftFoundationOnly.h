@@ -62,6 +62,8 @@
 #include <sys/sysmacros.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
 #endif
 
 #if TARGET_OS_ANDROID
@@ -374,6 +376,26 @@ CF_EXPORT void _cf_uuid_unparse(const _cf_uuid_t _Nonnull uu, _cf_uuid_string_t
 CF_EXPORT void _cf_uuid_unparse_lower(const _cf_uuid_t _Nonnull uu, _cf_uuid_string_t _Nonnull out);
 CF_EXPORT void _cf_uuid_unparse_upper(const _cf_uuid_t _Nonnull uu, _cf_uuid_string_t _Nonnull out);
 
+// An io_uring submission and completion queue pair, used by FileHandle for asynchronous I/O on Linux.
+// _CFFileIORingCreate() returns NULL and sets errno where io_uring is unavailable. The ring does no locking:
+// preparing and submitting entries must be serialized by the caller, as must copying completions.
+// Functions returning int return 0 or an errno value; a bufferIndex of -1 means the buffer is not registered.
+typedef struct _CFFileIORing *_CFFileIORingRef;
+CF_EXPORT _CFFileIORingRef _Nullable _CFFileIORingCreate(unsigned entries);
+CF_EXPORT void _CFFileIORingDestroy(_CFFileIORingRef _Nonnull ring);
+CF_EXPORT unsigned _CFFileIORingGetCompletionQueueCapacity(_CFFileIORingRef _Nonnull ring);
+CF_EXPORT int _CFFileIORingRegisterBuffers(_CFFileIORingRef _Nonnull ring, void *_Nonnull base, size_t bufferSize, unsigned count);
+CF_EXPORT bool _CFFileIORingPrepareRead(_CFFileIORingRef _Nonnull ring, int fd, void *_Nonnull buffer, unsigned length, int64_t offset, int bufferIndex, uint64_t userData);
+CF_EXPORT bool _CFFileIORingPrepareWrite(_CFFileIORingRef _Nonnull ring, int fd, const void *_Nonnull buffer, unsigned length, int64_t offset, int bufferIndex, uint64_t userData);
+CF_EXPORT bool _CFFileIORingPrepareFsync(_CFFileIORingRef _Nonnull ring, int fd, bool dataOnly, uint64_t userData);
+CF_EXPORT int _CFFileIORingSubmit(_CFFileIORingRef _Nonnull ring);
+// The number of prepared entries that the last _CFFileIORingSubmit() could not hand to the kernel.
+CF_EXPORT unsigned _CFFileIORingGetUnsubmittedCount(_CFFileIORingRef _Nonnull ring);
+// Withdraws the prepared entries that the last _CFFileIORingSubmit() could not hand to the kernel, and returns how many.
+CF_EXPORT unsigned _CFFileIORingDiscardUnsubmitted(_CFFileIORingRef _Nonnull ring);
+CF_EXPORT int _CFFileIORingWaitForCompletion(_CFFileIORingRef _Nonnull ring);
+CF_EXPORT unsigned _CFFileIORingCopyCompletions(_CFFileIORingRef _Nonnull ring, uint64_t *_Nonnull userData, int32_t *_Nonnull results, unsigned maximum);
+
 
 CF_PRIVATE CFStringRef _CFProcessNameString(void);
 CF_PRIVATE CFIndex __CFProcessorCount(void);
@@ -551,12 +573,13 @@ _statx(int dfd, const char *filename, unsigned int flags, unsigned int mask, str
 // At the moment the only extra information statx() is used for is to get the btime (file creation time).
 // This function is here instead of in FileManager.swift because there is no way of setting a conditional
 // define that could be used with a #if in the Swift code.
+// A relative filename is resolved against dirfd, which may be AT_FDCWD.
 static inline int
-_stat_with_btime(const char *filename, struct stat *buffer, struct timespec *btime) {
+_stat_with_btime_at(int dirfd, const char *filename, struct stat *buffer, struct timespec *btime) {
     struct statx statx_buffer = {0};
     *btime = (struct timespec) {0};
 
-    int ret = _statx(AT_FDCWD, filename, AT_SYMLINK_NOFOLLOW | AT_STATX_SYNC_AS_STAT, STATX_ALL, &statx_buffer);
+    int ret = _statx(dirfd, filename, AT_SYMLINK_NOFOLLOW | AT_STATX_SYNC_AS_STAT, STATX_ALL, &statx_buffer);
     if (ret == 0) {
         *buffer = (struct stat) {
             .st_dev = makedev(statx_buffer.stx_dev_major, statx_buffer.stx_dev_minor),
@@ -591,14 +614,52 @@ _stat_with_btime(const char *filename, struct stat *buffer, struct timespec *bti
 #else
 
 // Dummy version when compiled where struct statx is not defined in the headers.
-// Just calles lstat() instead.
+// Just calles fstatat() instead.
 static inline int
-_stat_with_btime(const char *filename, struct stat *buffer, struct timespec *btime) {
+_stat_with_btime_at(int dirfd, const char *filename, struct stat *buffer, struct timespec *btime) {
     *btime = (struct timespec) {0};
-    return lstat(filename, buffer) == 0 ? 0 : errno;
+    return fstatat(dirfd, filename, buffer, AT_SYMLINK_NOFOLLOW) == 0 ? 0 : errno;
 }
 #endif // __NR_statx
 
+static inline int
+_stat_with_btime(const char *filename, struct stat *buffer, struct timespec *btime) {
+    return _stat_with_btime_at(AT_FDCWD, filename, buffer, btime);
+}
+
+// glibc only exposes directory entries through readdir(), which allocates a DIR per directory and
+// hands out one entry per call. getdents64() fills a caller-provided buffer with as many entries as fit.
+struct _CFLinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+#ifdef SYS_getdents64
+static inline long _CF_getdents64(int fd, void *_Nonnull buffer, size_t length) {
+    return syscall(SYS_getdents64, fd, buffer, length);
+}
+#else
+static inline long _CF_getdents64(int fd, void *_Nonnull buffer, size_t length) {
+    errno = ENOSYS;
+    return -1;
+}
+#endif // SYS_getdents64
+
+static inline unsigned short _CFDirent64GetRecordLength(const void *_Nonnull entry) {
+    return ((const struct _CFLinuxDirent64 *)entry)->d_reclen;
+}
+
+static inline unsigned char _CFDirent64GetType(const void *_Nonnull entry) {
+    return ((const struct _CFLinuxDirent64 *)entry)->d_type;
+}
+
+static inline const char *_Nonnull _CFDirent64GetName(const void *_Nonnull entry) {
+    return ((const struct _CFLinuxDirent64 *)entry)->d_name;
+}
+
 static unsigned int const _CF_renameat2_RENAME_EXCHANGE = 1 << 1;
 #ifdef SYS_renameat2
 static bool const _CFHasRenameat2 = 1;
@@ -614,6 +675,54 @@ static inline int _CF_renameat2(int olddirfd, const char *_Nonnull oldpath,
 }
 #endif // __SYS_renameat2
 
+// Kernel-side copying for FileManager. FICLONE makes the destination share the source's extents on file systems
+// that support reflinks (btrfs, xfs, bcachefs); copy_file_range() and sendfile() copy without bouncing the data
+// through user space. All three report failure through errno.
+static inline int _CF_ficlone(int dstfd, int srcfd) {
+#ifdef FICLONE
+    return ioctl(dstfd, FICLONE, srcfd);
+#else
+    return ioctl(dstfd, _IOW(0x94, 9, int), srcfd);
+#endif
+}
+
+#ifdef SYS_copy_file_range
+static inline ssize_t _CF_copy_file_range(int infd, off_t *_Nullable inoff, int outfd, off_t *_Nullable outoff, size_t length) {
+    return syscall(SYS_copy_file_range, infd, inoff, outfd, outoff, length, 0);
+}
+#else
+static inline ssize_t _CF_copy_file_range(int infd, off_t *_Nullable inoff, int outfd, off_t *_Nullable outoff, size_t length) {
+    errno = ENOSYS;
+    return -1;
+}
+#endif // SYS_copy_file_range
+
+static inline ssize_t _CF_sendfile(int outfd, int infd, off_t *_Nullable offset, size_t count) {
+    return sendfile(outfd, infd, offset, count);
+}
+
+// Moves up to `length` bytes from a pipe to `outfd` inside the kernel, for Process output capture. Called through
+// syscall() because glibc only declares splice() under _GNU_SOURCE.
+#ifdef SYS_splice
+static inline ssize_t _CF_splice_from_pipe(int pipefd, int outfd, size_t length) {
+    return syscall(SYS_splice, pipefd, NULL, outfd, NULL, length, 1 /* SPLICE_F_MOVE */);
+}
+#else
+static inline ssize_t _CF_splice_from_pipe(int pipefd, int outfd, size_t length) {
+    errno = ENOSYS;
+    return -1;
+}
+#endif // SYS_splice
+
+// SEEK_DATA and SEEK_HOLE are only declared by glibc under _GNU_SOURCE.
+#ifdef SEEK_DATA
+static int const _CF_SEEK_DATA = SEEK_DATA;
+static int const _CF_SEEK_HOLE = SEEK_HOLE;
+#else
+static int const _CF_SEEK_DATA = 3;
+static int const _CF_SEEK_HOLE = 4;
+#endif
+
 
 #endif // TARGET_OS_LINUX
 
@@ -670,6 +779,7 @@ CF_EXPORT void _CFPosixSpawnFileActionsDealloc(_CFPosixSpawnFileActionsRef file_
 CF_EXPORT int _CFPosixSpawnFileActionsAddDup2(_CFPosixSpawnFileActionsRef file_actions, int filedes, int newfiledes);
 CF_EXPORT int _CFPosixSpawnFileActionsAddClose(_CFPosixSpawnFileActionsRef file_actions, int filedes);
 CF_EXPORT int _CFPosixSpawnFileActionsChdir(_CFPosixSpawnFileActionsRef file_actions, const char *path);
+CF_EXPORT int _CFPosixSpawnFileActionsAddCloseFrom(_CFPosixSpawnFileActionsRef file_actions, int lowfiledes);
 #if TARGET_OS_ANDROID
 CF_EXPORT _CFPosixSpawnAttrRef _CFPosixSpawnAttrAlloc(void);
 CF_EXPORT int _CFPosixSpawnAttrInit(_CFPosixSpawnAttrRef spawn_attr);
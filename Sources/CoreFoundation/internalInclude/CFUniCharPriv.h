@@ -38,5 +38,8 @@ CF_PRIVATE uint32_t CFUniCharGetUnicodeProperty(UTF32Char character, uint32_t pr
 // As you can see, this function cannot precompose Hangul Jamo
 CF_PRIVATE UTF32Char CFUniCharPrecomposeCharacter(UTF32Char base, UTF32Char combining);
 
+// Whether character is the second character of any canonical precomposition, that is, whether it can combine with the character before it
+CF_PRIVATE bool CFUniCharIsPrecomposableCombiningCharacter(UTF32Char character);
+
 #endif /* ! __COREFOUNDATION_CFUNICHARPRIV__ */
 
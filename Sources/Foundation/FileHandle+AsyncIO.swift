@@ -0,0 +1,485 @@
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2024 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+
+@_implementationOnly import CoreFoundation
+#if canImport(Dispatch)
+import Dispatch
+#endif
+
+extension FileHandle {
+    /// Asynchronous reads, writes and synchronization for a file handle.
+    ///
+    /// On Linux 5.6 and later the operations of all file handles are queued on one shared io_uring, submitted to the kernel in batches and completed by a single thread, so no thread is blocked per operation. Transfers of up to 64 KB go through buffers registered with the kernel. Elsewhere, or when io_uring is unavailable (for instance because a seccomp profile blocks it, or `FOUNDATION_DISABLE_IO_URING` is set in the environment), each operation runs the corresponding synchronous call on a global dispatch queue.
+    ///
+    /// Reads and writes start at the handle's current offset and advance it. Issue one read or write at a time on a given handle; concurrent ones are carried out in an unspecified order.
+    public struct AsyncIO : Sendable {
+        public let fileHandle: FileHandle
+
+        /// Whether operations are carried out by io_uring in this process.
+        public static var usesIORing: Bool {
+#if os(Linux)
+            return _FileIORing.shared != nil
+#else
+            return false
+#endif
+        }
+
+        /// Reads up to `count` bytes, stopping early only at the end of the file. Returns `nil` at the end of the file.
+        public func read(upToCount count: Int) async throws -> Data? {
+#if os(Linux)
+            if let ring = _ring {
+                return try await ring.read(from: fileHandle.fileDescriptor, upToCount: count)
+            }
+#endif
+            let fileHandle = self.fileHandle
+            return try await AsyncIO._offload { try fileHandle.read(upToCount: count) }
+        }
+
+        /// Reads everything up to the end of the file. Returns `nil` if the handle is already at the end of the file.
+        public func readToEnd() async throws -> Data? {
+            var result: Data?
+            while let data = try await read(upToCount: 1024 * 1024) {
+                if result == nil {
+                    result = data
+                } else {
+                    result!.append(data)
+                }
+            }
+            return result
+        }
+
+        /// Writes all of `data`.
+        public func write<T: DataProtocol>(contentsOf data: T) async throws {
+#if os(Linux)
+            if let ring = _ring {
+                return try await ring.write(to: fileHandle.fileDescriptor, contentsOf: data)
+            }
+#endif
+            let fileHandle = self.fileHandle
+            let contents = data as? Data ?? Data(data)
+            try await AsyncIO._offload { try fileHandle.write(contentsOf: contents) }
+        }
+
+        /// Flushes the file's data, and unless `dataOnly` is true its metadata, to permanent storage, like `synchronize()`.
+        public func synchronize(dataOnly: Bool = false) async throws {
+#if os(Linux)
+            if let ring = _ring {
+                return try await ring.synchronize(fileHandle.fileDescriptor, dataOnly: dataOnly)
+            }
+#endif
+            let fileHandle = self.fileHandle
+            try await AsyncIO._offload { try fileHandle.synchronize() }
+        }
+
+#if os(Linux)
+        // The null device and closed handles take the synchronous path, which knows how to treat them.
+        private var _ring: _FileIORing? {
+            guard let ring = _FileIORing.shared, fileHandle._isPlatformHandleValid, fileHandle !== FileHandle._nulldeviceFileHandle else {
+                return nil
+            }
+            return ring
+        }
+#endif
+
+        private static func _offload<T: Sendable>(_ body: @escaping @Sendable () throws -> T) async throws -> T {
+#if canImport(Dispatch)
+            return try await withCheckedThrowingContinuation { continuation in
+                DispatchQueue.global().async {
+                    continuation.resume(with: Result { try body() })
+                }
+            }
+#else
+            return try body()
+#endif
+        }
+    }
+
+    /// Asynchronous I/O on this handle. See `FileHandle.AsyncIO`.
+    public var asyncIO: AsyncIO {
+        return AsyncIO(fileHandle: self)
+    }
+}
+
+#if os(Linux)
+/// The io_uring shared by `FileHandle.AsyncIO`.
+///
+/// Callers append requests to `queued`. Whichever caller finds no submission in progress becomes the submitter and
+/// moves everything queued into the submission ring with a single io_uring_enter(), so under load requests that
+/// arrive during a submission are batched into the next one. A dedicated thread waits for completions and resumes
+/// the waiting tasks. At most as many requests as the completion ring holds are in flight, so it can't overflow.
+///
+/// Requests the kernel does not accept are carried out with the equivalent system call on a global dispatch queue
+/// instead, like the operations of `FileHandle.AsyncIO` where there is no ring. If the ring fails outright, every
+/// later request takes that path too.
+internal final class _FileIORing : @unchecked Sendable {
+    static let shared: _FileIORing? = {
+        if ProcessInfo.processInfo.environment["FOUNDATION_DISABLE_IO_URING"] != nil {
+            return nil
+        }
+        return _FileIORing()
+    }()
+
+    private static let submissionEntries = 256
+    private static let registeredBufferSize = 64 * 1024
+    private static let registeredBufferCount = 64
+    // How many times a submission the kernel turned away with EAGAIN or EBUSY is retried before its entries are
+    // carried out synchronously instead.
+    private static let submissionAttempts = 16
+    // The result that sends a request to the synchronous path; no operation returns it.
+    private static let unavailable = Int32.min
+
+    // The buffers of a request belong to the task awaiting it until the request has completed.
+    fileprivate enum Kind : @unchecked Sendable {
+        case read(UnsafeMutableRawPointer, Int, bufferIndex: Int32)
+        case write(UnsafeRawPointer, Int, bufferIndex: Int32)
+        case fsync(dataOnly: Bool)
+    }
+
+    private struct Request {
+        let fd: Int32
+        let kind: Kind
+        let continuation: CheckedContinuation<Int32, Never>
+    }
+
+    private let ring: _CFFileIORingRef
+    private let completionCapacity: Int
+    private let registeredBuffers: UnsafeMutableRawPointer?
+
+    // Protected by `lock`.
+    private let lock = NSLock()
+    private var queued: [Request] = []
+    private var inFlight: [UInt64 : CheckedContinuation<Int32, Never>] = [:]
+    private var nextIdentifier: UInt64 = 1
+    private var isSubmitting = false
+    private var awaitsResubmission = false
+    private var isBroken = false
+    private var freeBufferIndices: [Int32] = []
+
+    // Only the thread that set `isSubmitting` touches these. The identifiers are those of the prepared entries the
+    // kernel has not accepted yet, oldest first.
+    private var unsubmitted: [UInt64] = []
+    private var refusedSubmissions = 0
+
+    private init?() {
+        guard let ring = _CFFileIORingCreate(UInt32(_FileIORing.submissionEntries)) else {
+            return nil
+        }
+        self.ring = ring
+        self.completionCapacity = Int(_CFFileIORingGetCompletionQueueCapacity(ring))
+
+        // Registering pins the buffers once instead of on every transfer. It counts against RLIMIT_MEMLOCK, so
+        // carry on without them when that is too low.
+        let buffers = UnsafeMutableRawPointer.allocate(byteCount: _FileIORing.registeredBufferSize * _FileIORing.registeredBufferCount, alignment: NSPageSize())
+        if _CFFileIORingRegisterBuffers(ring, buffers, _FileIORing.registeredBufferSize, UInt32(_FileIORing.registeredBufferCount)) == 0 {
+            registeredBuffers = buffers
+            freeBufferIndices = (0..<Int32(_FileIORing.registeredBufferCount)).reversed()
+        } else {
+            buffers.deallocate()
+            registeredBuffers = nil
+        }
+
+        let thread = Thread { [unowned self] in
+            self._reapCompletions()
+        }
+        thread.name = "org.swift.Foundation.FileIORing"
+        thread.start()
+    }
+
+    func read(from fd: Int32, upToCount count: Int) async throws -> Data? {
+        var data = Data()
+        while data.count < count {
+            let length = min(count - data.count, 1 << 30)
+            let result: Int32
+            if length <= _FileIORing.registeredBufferSize, let index = _acquireBuffer() {
+                let buffer = _registeredBuffer(index)
+                result = await _perform(fd, .read(buffer, length, bufferIndex: index))
+                if result > 0 {
+                    data.append(buffer.assumingMemoryBound(to: UInt8.self), count: Int(result))
+                }
+                _releaseBuffer(index)
+            } else {
+                let buffer = UnsafeMutableRawPointer.allocate(byteCount: length, alignment: 16)
+                result = await _perform(fd, .read(buffer, length, bufferIndex: -1))
+                if result > 0 && data.isEmpty {
+                    data = Data(bytesNoCopy: buffer, count: Int(result), deallocator: .custom({ buffer, _ in buffer.deallocate() }))
+                } else {
+                    if result > 0 {
+                        data.append(buffer.assumingMemoryBound(to: UInt8.self), count: Int(result))
+                    }
+                    buffer.deallocate()
+                }
+            }
+            if result == -EINTR {
+                continue
+            }
+            if result < 0 {
+                throw _NSErrorWithErrno(-result, reading: true)
+            }
+            if result == 0 {
+                break
+            }
+        }
+        return data.isEmpty ? nil : data
+    }
+
+    func write<T: DataProtocol>(to fd: Int32, contentsOf data: T) async throws {
+        // The bytes are copied once: straight into a registered buffer when they fit one, otherwise into memory of
+        // their own that stays put while the kernel reads from it.
+        if data.count <= _FileIORing.registeredBufferSize, let index = _acquireBuffer() {
+            defer { _releaseBuffer(index) }
+            let buffer = UnsafeMutableRawBufferPointer(start: _registeredBuffer(index), count: data.count)
+            data.copyBytes(to: buffer)
+            try await _write(to: fd, bytes: UnsafeRawBufferPointer(buffer), bufferIndex: index)
+        } else {
+            let bytes = UnsafeMutableRawBufferPointer.allocate(byteCount: data.count, alignment: 16)
+            defer { bytes.deallocate() }
+            data.copyBytes(to: bytes)
+            try await _write(to: fd, bytes: UnsafeRawBufferPointer(bytes), bufferIndex: -1)
+        }
+    }
+
+    private func _write(to fd: Int32, bytes: UnsafeRawBufferPointer, bufferIndex: Int32) async throws {
+        var offset = 0
+        while offset < bytes.count {
+            let length = min(bytes.count - offset, 1 << 30)
+            let result = await _perform(fd, .write(bytes.baseAddress! + offset, length, bufferIndex: bufferIndex))
+            if result == -EINTR {
+                continue
+            }
+            if result <= 0 {
+                throw _NSErrorWithErrno(result == 0 ? EIO : -result, reading: false)
+            }
+            offset += Int(result)
+        }
+    }
+
+    func synchronize(_ fd: Int32, dataOnly: Bool) async throws {
+        let result = await _perform(fd, .fsync(dataOnly: dataOnly))
+        // Match synchronize(), which ignores the errors for special and read-only files.
+        if result < 0 && result != -EINVAL && result != -EROFS {
+            throw _NSErrorWithErrno(-result, reading: false)
+        }
+    }
+
+    private func _registeredBuffer(_ index: Int32) -> UnsafeMutableRawPointer {
+        return registeredBuffers! + Int(index) * _FileIORing.registeredBufferSize
+    }
+
+    private func _acquireBuffer() -> Int32? {
+        guard registeredBuffers != nil else { return nil }
+        lock.lock()
+        defer { lock.unlock() }
+        return freeBufferIndices.popLast()
+    }
+
+    private func _releaseBuffer(_ index: Int32) {
+        lock.lock()
+        freeBufferIndices.append(index)
+        lock.unlock()
+    }
+
+    // Returns the operation's result: a byte count, or a negated errno value.
+    private func _perform(_ fd: Int32, _ kind: Kind) async -> Int32 {
+        let result = await withCheckedContinuation { continuation in
+            lock.lock()
+            guard !isBroken else {
+                lock.unlock()
+                continuation.resume(returning: _FileIORing.unavailable)
+                return
+            }
+            queued.append(Request(fd: fd, kind: kind, continuation: continuation))
+            let shouldSubmit = !isSubmitting
+            isSubmitting = true
+            lock.unlock()
+            if shouldSubmit {
+                _submitQueued()
+            }
+        }
+        guard result == _FileIORing.unavailable else {
+            return result
+        }
+        return await withCheckedContinuation { continuation in
+            DispatchQueue.global().async {
+                continuation.resume(returning: _performSynchronously(fd, kind))
+            }
+        }
+    }
+
+    // Must only be called by the thread that set `isSubmitting`.
+    private func _submitQueued() {
+        while true {
+            if unsubmitted.isEmpty {
+                lock.lock()
+                let count = min(queued.count, _FileIORing.submissionEntries, completionCapacity - inFlight.count)
+                guard count > 0 else {
+                    // Whatever is still queued is submitted by the completion thread once there is room.
+                    isSubmitting = false
+                    lock.unlock()
+                    return
+                }
+                var batch: [(identifier: UInt64, request: Request)] = []
+                batch.reserveCapacity(count)
+                for request in queued.prefix(count) {
+                    batch.append((nextIdentifier, request))
+                    inFlight[nextIdentifier] = request.continuation
+                    nextIdentifier &+= 1
+                }
+                queued.removeFirst(count)
+                lock.unlock()
+
+                for (identifier, request) in batch {
+                    let prepared: Bool
+                    switch request.kind {
+                    case .read(let buffer, let length, let bufferIndex):
+                        prepared = _CFFileIORingPrepareRead(ring, request.fd, buffer, UInt32(length), -1, bufferIndex, identifier)
+                    case .write(let buffer, let length, let bufferIndex):
+                        prepared = _CFFileIORingPrepareWrite(ring, request.fd, buffer, UInt32(length), -1, bufferIndex, identifier)
+                    case .fsync(let dataOnly):
+                        prepared = _CFFileIORingPrepareFsync(ring, request.fd, dataOnly, identifier)
+                    }
+                    precondition(prepared, "io_uring submission queue unexpectedly full")
+                }
+                unsubmitted = batch.map { $0.identifier }
+            }
+
+            let error = _CFFileIORingSubmit(ring)
+            unsubmitted.removeFirst(unsubmitted.count - Int(_CFFileIORingGetUnsubmittedCount(ring)))
+            if error == 0 {
+                refusedSubmissions = 0
+                continue
+            }
+            if error == EAGAIN || error == EBUSY {
+                // The kernel is short of resources or has completions to hand over. Either clears up as the requests
+                // it has accepted complete, so leave the entries in the ring and have the completion thread submit
+                // them again after collecting the next completion. Without such requests nothing would, so don't.
+                refusedSubmissions += 1
+                lock.lock()
+                if refusedSubmissions < _FileIORing.submissionAttempts && inFlight.count > unsubmitted.count {
+                    awaitsResubmission = true
+                    lock.unlock()
+                    return
+                }
+                lock.unlock()
+            }
+            _rejectUnsubmitted(ringIsBroken: error != EAGAIN && error != EBUSY)
+        }
+    }
+
+    // Takes back the entries the kernel has not accepted and sends them the synchronous way. When the ring can't be
+    // used any more, everything still queued goes that way as well. Must only be called by the submitting thread.
+    private func _rejectUnsubmitted(ringIsBroken: Bool) {
+        _CFFileIORingDiscardUnsubmitted(ring)
+        var rejected: [CheckedContinuation<Int32, Never>] = []
+        lock.lock()
+        for identifier in unsubmitted {
+            if let continuation = inFlight.removeValue(forKey: identifier) {
+                rejected.append(continuation)
+            }
+        }
+        if ringIsBroken {
+            isBroken = true
+            rejected += queued.map { $0.continuation }
+            queued.removeAll()
+        }
+        lock.unlock()
+        unsubmitted.removeAll()
+        refusedSubmissions = 0
+        for continuation in rejected {
+            continuation.resume(returning: _FileIORing.unavailable)
+        }
+    }
+
+    private func _reapCompletions() {
+        let maximumCount = 64
+        var identifiers = [UInt64](repeating: 0, count: maximumCount)
+        var results = [Int32](repeating: 0, count: maximumCount)
+        var isPolling = false
+        while true {
+            if isPolling {
+                // Requests the kernel has accepted still complete into the ring, and their buffers must stay in use
+                // until they do, so look for their completions until there are none left to wait for.
+                lock.lock()
+                let isIdle = inFlight.isEmpty
+                lock.unlock()
+                if isIdle {
+                    return
+                }
+                usleep(1000)
+            } else {
+                let error = _CFFileIORingWaitForCompletion(ring)
+                if error == EINTR {
+                    continue
+                } else if error != 0 {
+                    lock.lock()
+                    isBroken = true
+                    let rejected = queued.map { $0.continuation }
+                    queued.removeAll()
+                    // Entries left for this thread to submit again would never complete.
+                    let ownsSubmission = awaitsResubmission
+                    awaitsResubmission = false
+                    lock.unlock()
+                    for continuation in rejected {
+                        continuation.resume(returning: _FileIORing.unavailable)
+                    }
+                    if ownsSubmission {
+                        _rejectUnsubmitted(ringIsBroken: true)
+                        lock.lock()
+                        isSubmitting = false
+                        lock.unlock()
+                    }
+                    isPolling = true
+                    continue
+                }
+            }
+            let count = Int(_CFFileIORingCopyCompletions(ring, &identifiers, &results, UInt32(maximumCount)))
+
+            var completed: [(CheckedContinuation<Int32, Never>, Int32)] = []
+            completed.reserveCapacity(count)
+            lock.lock()
+            for index in 0..<count {
+                if let continuation = inFlight.removeValue(forKey: identifiers[index]) {
+                    completed.append((continuation, results[index]))
+                }
+            }
+            // A refused submission still holds `isSubmitting`, which passes to this thread along with it.
+            let shouldSubmit = awaitsResubmission || (!queued.isEmpty && !isSubmitting)
+            awaitsResubmission = false
+            isSubmitting = isSubmitting || shouldSubmit
+            lock.unlock()
+
+            for (continuation, result) in completed {
+                continuation.resume(returning: result)
+            }
+            if shouldSubmit {
+                _submitQueued()
+            }
+        }
+    }
+}
+
+// Carries out a request with the equivalent system call, returning a byte count or a negated errno value.
+private func _performSynchronously(_ fd: Int32, _ kind: _FileIORing.Kind) -> Int32 {
+    while true {
+        let result: Int
+        switch kind {
+        case .read(let buffer, let length, _):
+            result = read(fd, buffer, length)
+        case .write(let buffer, let length, _):
+            result = write(fd, buffer, length)
+        case .fsync(let dataOnly):
+            result = Int(dataOnly ? fdatasync(fd) : fsync(fd))
+        }
+        if result >= 0 {
+            return Int32(result)
+        } else if errno != EINTR {
+            return -errno
+        }
+    }
+}
+#endif
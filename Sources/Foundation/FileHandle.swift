@@ -321,18 +321,20 @@ open class FileHandle : NSObject, @unchecked Sendable {
         }
 
         let readBlockSize: Int
+        // For regular files, the number of bytes the read is expected to return, judging by the file's size.
+        var expectedLength = 0
         if statbuf.st_mode & S_IFMT == S_IFREG {
-            // TODO: Should files over a certain size always be mmap()'d?
-            if options.contains(.alwaysMapped) {
-                // Filesizes are often 64bit even on 32bit systems
-                let mapSize = min(length, Int(clamping: statbuf.st_size))
-                let data = mmap(nil, mapSize, PROT_READ, MAP_PRIVATE, _fd, 0)
-                // Swift does not currently expose MAP_FAILURE
-                if data != UnsafeMutableRawPointer(bitPattern: -1) {
-                    return NSData.NSDataReadResult(bytes: data, length: mapSize) { buffer, length in
-                        munmap(buffer, length)
-                    }
-                }
+            let offset = lseek(_fd, 0, SEEK_CUR)
+            if offset >= 0 {
+                expectedLength = min(length, max(0, Int(clamping: statbuf.st_size) - Int(clamping: offset)))
+            }
+
+            // Mapping only pays off once the page-table work is cheaper than copying the bytes, and
+            // .mappedIfSafe additionally requires a file system on which the file can't vanish under the mapping.
+            let shouldMap = expectedLength > 0 && offset >= 0 &&
+                (options.contains(.alwaysMapped) || (options.contains(.mappedIfSafe) && expectedLength >= FileHandle._mappingThreshold && _isOnLocalFileSystem()))
+            if shouldMap, let mapped = _mapBytes(at: Int(offset), length: expectedLength) {
+                return mapped
             }
 
             if statbuf.st_blksize > 0 {
@@ -340,24 +342,34 @@ open class FileHandle : NSObject, @unchecked Sendable {
             } else {
                 readBlockSize = 1024 * 8
             }
+#if os(Linux)
+            if expectedLength >= FileHandle._sequentialAdviceThreshold {
+                _ = posix_fadvise(_fd, offset, off_t(expectedLength), POSIX_FADV_SEQUENTIAL)
+            }
+#endif
         } else {
             /* We get here on sockets, character special files, FIFOs ... */
             readBlockSize = 1024 * 8
         }
-        var currentAllocationSize = readBlockSize
+        // When the size is known the whole read is normally a single read() into a buffer of exactly that size, plus
+        // the read that finds the end of the file; a file that has grown since fstat() is read on to its new end.
+        var currentAllocationSize = max(expectedLength, readBlockSize)
         var dynamicBuffer = malloc(currentAllocationSize)!
         var total = 0
 
         while total < length {
             let remaining = length - total
-            let amountToRead = min(readBlockSize, remaining)
+            let amountToRead = total < expectedLength ? expectedLength - total : min(readBlockSize, remaining)
             // Make sure there is always at least amountToRead bytes available in the buffer.
             if (currentAllocationSize - total) < amountToRead {
-                currentAllocationSize *= 2
+                currentAllocationSize = max(currentAllocationSize * 2, total + amountToRead)
                 dynamicBuffer = _CFReallocf(dynamicBuffer, currentAllocationSize)
             }
             let amtRead = _read(_fd, dynamicBuffer.advanced(by: total), amountToRead)
             if amtRead < 0 {
+                if errno == EINTR {
+                    continue
+                }
                 free(dynamicBuffer)
                 throw _NSErrorWithErrno(errno, reading: true)
             }
@@ -371,13 +383,71 @@ open class FileHandle : NSObject, @unchecked Sendable {
             free(dynamicBuffer)
             return NSData.NSDataReadResult(bytes: nil, length: 0, deallocator: nil)
         }
-        dynamicBuffer = _CFReallocf(dynamicBuffer, total)
+        if total != currentAllocationSize {
+            dynamicBuffer = _CFReallocf(dynamicBuffer, total)
+        }
         let bytePtr = dynamicBuffer.bindMemory(to: UInt8.self, capacity: total)
         return NSData.NSDataReadResult(bytes: bytePtr, length: total) { buffer, length in
             free(buffer)
         }
 #endif
     }
+
+#if !os(Windows)
+    // Reads at or above these sizes are mapped when .mappedIfSafe allows it, and are announced to the kernel as
+    // sequential so that it reads ahead more aggressively.
+    internal static let _mappingThreshold = 128 * 1024
+    internal static let _sequentialAdviceThreshold = 1024 * 1024
+
+    // Maps `length` bytes starting at `offset` and moves the file position past them, as a read would.
+    private func _mapBytes(at offset: Int, length: Int) -> NSData.NSDataReadResult? {
+        let mapOffset = NSRoundDownToMultipleOfPageSize(offset)
+        let mapLength = length + (offset - mapOffset)
+        guard let mapping = mmap(nil, mapLength, PROT_READ, MAP_PRIVATE, _fd, off_t(mapOffset)),
+              mapping != UnsafeMutableRawPointer(bitPattern: -1) else { // Swift does not currently expose MAP_FAILED
+            return nil
+        }
+#if os(Linux)
+        if length >= FileHandle._sequentialAdviceThreshold {
+            _ = madvise(mapping, mapLength, MADV_SEQUENTIAL)
+            _ = madvise(mapping, mapLength, MADV_WILLNEED)
+        }
+#endif
+        guard lseek(_fd, off_t(offset + length), SEEK_SET) >= 0 else {
+            munmap(mapping, mapLength)
+            return nil
+        }
+        let headroom = offset - mapOffset
+        return NSData.NSDataReadResult(bytes: mapping + headroom, length: length) { buffer, length in
+            munmap(buffer - headroom, length + headroom)
+        }
+    }
+
+    // A mapping turns a file truncated by someone else into SIGBUS on access. That is an accepted risk on local
+    // file systems, but network and FUSE file systems can also drop or change pages behind our back.
+    private func _isOnLocalFileSystem() -> Bool {
+#if os(Linux)
+        var fsInfo = statfs()
+        guard fstatfs(_fd, &fsInfo) == 0 else { return false }
+        switch UInt32(truncatingIfNeeded: fsInfo.f_type) {
+        case 0x6969,        // NFS
+             0x517B,        // SMB
+             0xFE534D42,    // SMB2
+             0xFF534D42,    // CIFS
+             0x65735546,    // FUSE
+             0x01021997,    // 9P
+             0x00C36400,    // Ceph
+             0x5346414F,    // AFS
+             0x6B414653:    // kAFS
+            return false
+        default:
+            return true
+        }
+#else
+        return true
+#endif
+    }
+#endif
     
     internal func _readBytes(into buffer: UnsafeMutablePointer<UInt8>, length: Int) throws -> Int {
 #if os(Windows)
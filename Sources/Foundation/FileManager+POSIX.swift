@@ -598,6 +598,330 @@ extension FileManager {
     }
 }
 
+#if !os(WASI)
+extension FileManager {
+    private struct _FileCopyJob {
+        let source: String
+        let destination: String
+        let info: stat
+    }
+
+    internal func _copyItem(atPath srcPath: String, toPath dstPath: String, maximumConcurrency: Int) throws -> CopyStatistics {
+        var statistics = CopyStatistics()
+        let info = try _lstatFile(atPath: srcPath)
+        guard info.st_mode & S_IFMT == S_IFDIR else {
+            try _copyNonDirectory(atPath: srcPath, toPath: dstPath, info: info, statistics: &statistics)
+            return statistics
+        }
+
+        // Walking a source that contains the destination would find every directory it creates and never finish.
+        if let source = _resolvedPath(srcPath), let parent = _resolvedPath((dstPath as NSString).deletingLastPathComponent) {
+            let destination = (parent as NSString).appendingPathComponent((dstPath as NSString).lastPathComponent)
+            if destination == source || destination.hasPrefix(source == "/" ? "/" : source + "/") {
+                throw _NSErrorWithErrno(EINVAL, reading: false, path: dstPath)
+            }
+        }
+
+        // Lay out the directory tree first so that files can then be copied in any order. Directories stay writable
+        // until their contents are in place and get their own permissions, owner and times back afterwards, deepest
+        // first, since adding entries changes a directory's modification time.
+        var jobs: [_FileCopyJob] = []
+        var directories: [(path: String, info: stat)] = []
+        var pending: [(source: String, destination: String, info: stat)] = [(srcPath, dstPath, info)]
+        while let directory = pending.popLast() {
+            try _fileSystemRepresentation(withPath: directory.destination) { fsRep in
+                guard mkdir(fsRep, S_IRWXU) == 0 else {
+                    throw _NSErrorWithErrno(errno, reading: false, path: directory.destination)
+                }
+            }
+            directories.append((directory.destination, directory.info))
+            statistics.directories += 1
+
+            for name in try contentsOfDirectory(atPath: directory.source) {
+                let source = directory.source + "/" + name
+                let destination = directory.destination + "/" + name
+                let childInfo = try _lstatFile(atPath: source)
+                switch childInfo.st_mode & S_IFMT {
+                case S_IFDIR:
+                    pending.append((source, destination, childInfo))
+                case S_IFREG:
+                    jobs.append(_FileCopyJob(source: source, destination: destination, info: childInfo))
+                default:
+                    try _copyNonDirectory(atPath: source, toPath: destination, info: childInfo, statistics: &statistics)
+                }
+            }
+        }
+
+        let workerCount = min(maximumConcurrency, jobs.count)
+        if workerCount <= 1 {
+            for job in jobs {
+                try _copyRegularFile(job, statistics: &statistics)
+            }
+        } else {
+            let nextJob = Mutex(0)
+            let shared = Mutex((statistics: CopyStatistics(), error: Error?.none))
+            DispatchQueue.concurrentPerform(iterations: workerCount) { _ in
+                var local = CopyStatistics()
+                while true {
+                    let index = nextJob.withLock { next in
+                        defer { next += 1 }
+                        return next
+                    }
+                    guard index < jobs.count, shared.withLock({ $0.error == nil }) else {
+                        break
+                    }
+                    do {
+                        try self._copyRegularFile(jobs[index], statistics: &local)
+                    } catch {
+                        shared.withLock { if $0.error == nil { $0.error = error } }
+                        break
+                    }
+                }
+                shared.withLock { $0.statistics._merge(local) }
+            }
+            let result = shared.withLock { $0 }
+            if let error = result.error {
+                throw error
+            }
+            statistics._merge(result.statistics)
+        }
+
+        for directory in directories.reversed() {
+            try _copyMetadata(directory.info, toPath: directory.path, setsMode: true)
+        }
+        return statistics
+    }
+
+    private func _resolvedPath(_ path: String) -> String? {
+        return try? _fileSystemRepresentation(withPath: path) { fsRep -> String? in
+            guard let resolved = realpath(fsRep, nil) else {
+                return nil
+            }
+            defer { free(resolved) }
+            return string(withFileSystemRepresentation: resolved, length: strlen(resolved))
+        }
+    }
+
+    private static func _times(of info: stat) -> [timespec] {
+#if canImport(Darwin)
+        return [info.st_atimespec, info.st_mtimespec]
+#else
+        return [info.st_atim, info.st_mtim]
+#endif
+    }
+
+    // Gives a copy the owner, group and times of its source, and its permissions if `setsMode` is true, through `fd`
+    // when it is open or else through the path without following a final symbolic link. Only a privileged caller can
+    // give away a file, so a refused change of owner leaves the copy with the caller's, as `cp -p` does.
+    private func _copyMetadata(_ info: stat, toPath path: String, fd: Int32? = nil, setsMode: Bool) throws {
+        // Change the owner before the permissions, since it clears the set-user-ID and set-group-ID bits.
+        let owned = try _fileSystemRepresentation(withPath: path) { fsRep in
+            fd.map { fchown($0, info.st_uid, info.st_gid) } ?? lchown(fsRep, info.st_uid, info.st_gid)
+        }
+        if owned != 0 && errno != EPERM {
+            throw _NSErrorWithErrno(errno, reading: false, path: path)
+        }
+        if setsMode {
+            let mode = mode_t(info.st_mode) & 0o7777
+            let changed = try _fileSystemRepresentation(withPath: path) { fsRep in
+                fd.map { fchmod($0, mode) } ?? chmod(fsRep, mode)
+            }
+            guard changed == 0 else {
+                throw _NSErrorWithErrno(errno, reading: false, path: path)
+            }
+        }
+        try FileManager._times(of: info).withUnsafeBufferPointer { times in
+            let updated = try _fileSystemRepresentation(withPath: path) { fsRep in
+                fd.map { futimens($0, times.baseAddress) } ?? utimensat(AT_FDCWD, fsRep, times.baseAddress, AT_SYMLINK_NOFOLLOW)
+            }
+            guard updated == 0 else {
+                throw _NSErrorWithErrno(errno, reading: false, path: path)
+            }
+        }
+    }
+
+    private func _copyNonDirectory(atPath srcPath: String, toPath dstPath: String, info: stat, statistics: inout CopyStatistics) throws {
+        switch info.st_mode & S_IFMT {
+        case S_IFREG:
+            try _copyRegularFile(_FileCopyJob(source: srcPath, destination: dstPath, info: info), statistics: &statistics)
+        case S_IFLNK:
+            try createSymbolicLink(atPath: dstPath, withDestinationPath: destinationOfSymbolicLink(atPath: srcPath))
+            try _copyMetadata(info, toPath: dstPath, setsMode: false)
+            statistics.symbolicLinks += 1
+        default:
+            try _fileSystemRepresentation(withPath: dstPath) { fsRep in
+                guard mknod(fsRep, mode_t(info.st_mode), info.st_rdev) == 0 else {
+                    throw _NSErrorWithErrno(errno, reading: false, path: dstPath)
+                }
+            }
+            try _copyMetadata(info, toPath: dstPath, setsMode: true)
+            statistics.otherItems += 1
+        }
+    }
+
+    private func _copyRegularFile(_ job: _FileCopyJob, statistics: inout CopyStatistics) throws {
+        let srcFD = try _fileSystemRepresentation(withPath: job.source) { open($0, O_RDONLY | O_CLOEXEC) }
+        guard srcFD >= 0 else {
+            throw _NSErrorWithErrno(errno, reading: true, path: job.source)
+        }
+        defer { close(srcFD) }
+        let dstFD = try _fileSystemRepresentation(withPath: job.destination) { open($0, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR) }
+        guard dstFD >= 0 else {
+            throw _NSErrorWithErrno(errno, reading: false, path: job.destination)
+        }
+        defer { close(dstFD) }
+
+        let (method, copied) = try _copyFileData(from: srcFD, to: dstFD, info: job.info, source: job.source, destination: job.destination)
+        try _copyMetadata(job.info, toPath: job.destination, fd: dstFD, setsMode: true)
+        statistics.regularFiles += 1
+        statistics.bytesCopied += copied
+        statistics.bytesSkippedInHoles += max(0, Int64(job.info.st_size) - copied)
+        statistics.filesByMethod[method, default: 0] += 1
+    }
+
+    // Returns the method that finished the copy and the number of data bytes copied; anything short of the file's size
+    // was left as holes.
+    private func _copyFileData(from srcFD: Int32, to dstFD: Int32, info: stat, source: String, destination: String) throws -> (CopyStatistics.Method, Int64) {
+        let size = Int64(info.st_size)
+        // Files in pseudo file systems such as /proc report a size of zero, so those are read until the end instead.
+        guard size > 0 else {
+            var method = CopyStatistics.Method.readWrite
+            let copied = try _copyFileRange(0, Int64.max, from: srcFD, to: dstFD, method: &method, source: source, destination: destination)
+            return (method, copied)
+        }
+
+#if os(Linux)
+        if _CF_ficlone(dstFD, srcFD) == 0 {
+            return (.clone, size)
+        }
+        var method = CopyStatistics.Method.copyFileRange
+        // Only files that occupy fewer blocks than their size calls for can have holes worth looking for.
+        var mayHaveHoles = Int64(info.st_blocks) * 512 < size
+#else
+        var method = CopyStatistics.Method.readWrite
+        var mayHaveHoles = false
+#endif
+
+        var copied: Int64 = 0
+        var offset: Int64 = 0
+        var skippedHoles = false
+        while offset < size {
+            var dataStart = offset
+            var dataEnd = size
+#if os(Linux)
+            if mayHaveHoles {
+                let nextData = lseek(srcFD, off_t(offset), _CF_SEEK_DATA)
+                if nextData >= 0 {
+                    dataStart = Int64(nextData)
+                    let nextHole = lseek(srcFD, nextData, _CF_SEEK_HOLE)
+                    dataEnd = nextHole >= 0 ? min(Int64(nextHole), size) : size
+                } else if errno == ENXIO {
+                    // Only a hole is left.
+                    skippedHoles = true
+                    break
+                } else {
+                    mayHaveHoles = false
+                }
+            }
+#endif
+            if dataStart > offset {
+                skippedHoles = true
+            }
+            guard dataStart < dataEnd else { break }
+            let count = try _copyFileRange(dataStart, dataEnd, from: srcFD, to: dstFD, method: &method, source: source, destination: destination)
+            copied += count
+            if count < dataEnd - dataStart {
+                // The source shrank while it was being copied.
+                return (method, copied)
+            }
+            offset = dataEnd
+        }
+        if skippedHoles {
+            guard ftruncate(dstFD, off_t(size)) == 0 else {
+                throw _NSErrorWithErrno(errno, reading: false, path: destination)
+            }
+        }
+        return (method, copied)
+    }
+
+    // Copies bytes `start..<end` to the same offsets in the destination, falling back to the next method in
+    // `CopyStatistics.Method` when the current one isn't supported for this pair of files. Stops early at the end of
+    // the source and returns the number of bytes copied.
+    private func _copyFileRange(_ start: Int64, _ end: Int64, from srcFD: Int32, to dstFD: Int32, method: inout CopyStatistics.Method, source: String, destination: String) throws -> Int64 {
+        var buffer: UnsafeMutableRawBufferPointer?
+        defer { buffer?.deallocate() }
+
+        var position = start
+        while position < end {
+            let chunk = Int(min(end - position, 1 << 30))
+            let count: Int
+            switch method {
+#if os(Linux)
+            case .copyFileRange:
+                var inOffset = off_t(position)
+                var outOffset = off_t(position)
+                count = _CF_copy_file_range(srcFD, &inOffset, dstFD, &outOffset, chunk)
+                if count < 0 {
+                    switch errno {
+                    case EINTR:
+                        continue
+                    case ENOSYS, EXDEV, EINVAL, EOPNOTSUPP, EPERM:
+                        method = .sendfile
+                        continue
+                    default:
+                        throw _NSErrorWithErrno(errno, reading: false, path: destination)
+                    }
+                }
+            case .sendfile:
+                // sendfile() writes at the destination's file position.
+                guard lseek(dstFD, off_t(position), SEEK_SET) >= 0 else {
+                    throw _NSErrorWithErrno(errno, reading: false, path: destination)
+                }
+                var inOffset = off_t(position)
+                count = _CF_sendfile(dstFD, srcFD, &inOffset, chunk)
+                if count < 0 {
+                    switch errno {
+                    case EINTR:
+                        continue
+                    case ENOSYS, EINVAL:
+                        method = .readWrite
+                        continue
+                    default:
+                        throw _NSErrorWithErrno(errno, reading: false, path: destination)
+                    }
+                }
+#endif
+            default:
+                method = .readWrite
+                if buffer == nil {
+                    buffer = .allocate(byteCount: 1 << 20, alignment: 16)
+                }
+                let readCount = pread(srcFD, buffer!.baseAddress!, min(chunk, buffer!.count), off_t(position))
+                if readCount < 0 {
+                    if errno == EINTR { continue }
+                    throw _NSErrorWithErrno(errno, reading: true, path: source)
+                }
+                var written = 0
+                while written < readCount {
+                    let result = pwrite(dstFD, buffer!.baseAddress! + written, readCount - written, off_t(position) + off_t(written))
+                    if result < 0 {
+                        if errno == EINTR { continue }
+                        throw _NSErrorWithErrno(errno, reading: false, path: destination)
+                    }
+                    written += result
+                }
+                count = readCount
+            }
+            if count == 0 {
+                break
+            }
+            position += Int64(count)
+        }
+        return position - start
+    }
+}
+#endif
+
 extension FileManager.NSPathDirectoryEnumerator {
     internal func _nextObject() -> Any? {
         let o = innerEnumerator.nextObject()
@@ -611,5 +935,435 @@ extension FileManager.NSPathDirectoryEnumerator {
     }
 }
 
+#if os(Linux)
+extension FileManager {
+    /// Walks a directory tree on behalf of `enumerateDirectory(at:includingPropertiesForKeys:options:batchSize:maximumConcurrency:errorHandler:using:)`.
+    ///
+    /// Every worker owns a deque of directories still to be read. It takes work from the back of its own deque, which keeps
+    /// it depth-first, and steals from the front of the other deques when it runs dry. Directories are read with getdents64()
+    /// into a per-worker buffer and entries are described with one statx() relative to the open directory, so no absolute
+    /// path is resolved more than once. Batches are handed to the calling thread through a bounded queue.
+    internal final class _ConcurrentDirectoryWalker : @unchecked Sendable {
+        private enum Delivery {
+            case entries([DirectoryEntry])
+            case error(URL, Error)
+        }
+
+        private final class WorkDeque {
+            let lock = NSLock()
+            var paths: [String] = []
+            var head = 0
+        }
+
+        // Keys that are answered from the statx() result.
+        private static let statKeys: Set<URLResourceKey> = [
+            .isRegularFileKey, .isDirectoryKey, .isSymbolicLinkKey, .fileResourceTypeKey,
+            .fileSizeKey, .totalFileSizeKey, .fileAllocatedSizeKey, .totalFileAllocatedSizeKey,
+            .linkCountKey, .creationDateKey, .contentAccessDateKey, .contentModificationDateKey,
+            .fileResourceIdentifierKey,
+        ]
+        // Keys that are answered from the entry's name alone.
+        private static let nameKeys: Set<URLResourceKey> = [.nameKey, .pathKey, .parentDirectoryURLKey, .isHiddenKey]
+
+        private static let readBufferSize = 64 * 1024
+        // Workers wait once this many deliveries are queued for the caller.
+        private static let maximumQueuedDeliveries = 64
+
+        private let rootURL: URL
+        private let rootPath: String
+        private let keys: Set<URLResourceKey>
+        private let needsStat: Bool
+        private let remainingKeys: [URLResourceKey]
+        private let options: DirectoryEnumerationOptions
+        private let batchSize: Int
+        private let deques: [WorkDeque]
+        private var rootDevice: dev_t = 0
+
+        // Protected by `workCondition`, which idle workers wait on. `pendingDirectories` counts the directories that are
+        // queued or being read, and the walk is over when it drops to zero; `queuedDirectories` counts those still queued.
+        private let workCondition = NSCondition()
+        private var pendingDirectories = 0
+        private var queuedDirectories = 0
+        private var workStopped = false
+
+        // Protected by `condition`.
+        private let condition = NSCondition()
+        private var deliveries: [Delivery] = []
+        private var runningWorkers = 0
+        private var stopped = false
+
+        init(root: URL, keys: Set<URLResourceKey>, options: DirectoryEnumerationOptions, batchSize: Int, workerCount: Int) {
+            var path = root.path
+            while path.count > 1 && path.hasSuffix("/") {
+                path.removeLast()
+            }
+            self.rootURL = root
+            self.rootPath = path
+            self.keys = keys
+            self.needsStat = !keys.isDisjoint(with: _ConcurrentDirectoryWalker.statKeys)
+            self.remainingKeys = Array(keys.subtracting(_ConcurrentDirectoryWalker.statKeys).subtracting(_ConcurrentDirectoryWalker.nameKeys))
+            self.options = options
+            self.batchSize = batchSize
+            self.deques = (0..<workerCount).map { _ in WorkDeque() }
+        }
+
+        func run(errorHandler: ((URL, Error) -> Bool)?, body: ([DirectoryEntry]) -> Bool) {
+            var rootInfo = stat()
+            let status = try? FileManager.default._fileSystemRepresentation(withPath: rootPath) { stat($0, &rootInfo) }
+            guard status == 0 else {
+                _ = errorHandler?(rootURL, _NSErrorWithErrno(status == nil ? ENOENT : errno, reading: true, url: rootURL))
+                return
+            }
+            rootDevice = rootInfo.st_dev
+
+            deques[0].paths.append(rootPath)
+            pendingDirectories = 1
+            queuedDirectories = 1
+            runningWorkers = deques.count
+            for index in deques.indices {
+                DispatchQueue.global().async {
+                    self.work(index)
+                }
+            }
+
+            condition.lock()
+            while true {
+                while deliveries.isEmpty && runningWorkers > 0 {
+                    condition.wait()
+                }
+                if deliveries.isEmpty {
+                    break
+                }
+                let pending = deliveries
+                deliveries.removeAll(keepingCapacity: true)
+                condition.broadcast()
+                condition.unlock()
+
+                var shouldContinue = true
+                for delivery in pending where shouldContinue {
+                    switch delivery {
+                    case .entries(let entries):
+                        shouldContinue = body(entries)
+                    case .error(let url, let error):
+                        shouldContinue = errorHandler?(url, error) ?? true
+                    }
+                }
+
+                condition.lock()
+                if !shouldContinue {
+                    // Workers notice this between directories and exit; they keep the walker alive until they do.
+                    stopped = true
+                    condition.broadcast()
+                    break
+                }
+            }
+            condition.unlock()
+
+            workCondition.lock()
+            workStopped = true
+            workCondition.broadcast()
+            workCondition.unlock()
+        }
+
+        private var isStopped: Bool {
+            condition.lock()
+            defer { condition.unlock() }
+            return stopped
+        }
+
+        private func deliver(_ delivery: Delivery) -> Bool {
+            condition.lock()
+            defer { condition.unlock() }
+            while deliveries.count >= _ConcurrentDirectoryWalker.maximumQueuedDeliveries && !stopped {
+                condition.wait()
+            }
+            guard !stopped else { return false }
+            deliveries.append(delivery)
+            condition.broadcast()
+            return true
+        }
+
+        private func push(_ path: String, worker index: Int) {
+            let deque = deques[index]
+            deque.lock.lock()
+            deque.paths.append(path)
+            deque.lock.unlock()
+
+            workCondition.lock()
+            pendingDirectories += 1
+            queuedDirectories += 1
+            workCondition.signal()
+            workCondition.unlock()
+        }
+
+        private func takeDirectory(worker index: Int) -> String? {
+            let own = deques[index]
+            own.lock.lock()
+            if own.paths.count > own.head {
+                let path = own.paths.removeLast()
+                if own.paths.count == own.head {
+                    own.paths.removeAll(keepingCapacity: true)
+                    own.head = 0
+                }
+                own.lock.unlock()
+                return path
+            }
+            own.lock.unlock()
+
+            for offset in 1..<deques.count {
+                let victim = deques[(index + offset) % deques.count]
+                victim.lock.lock()
+                if victim.paths.count > victim.head {
+                    let path = victim.paths[victim.head]
+                    victim.head += 1
+                    if victim.head == victim.paths.count {
+                        victim.paths.removeAll(keepingCapacity: true)
+                        victim.head = 0
+                    } else if victim.head > 1024 && victim.head * 2 > victim.paths.count {
+                        victim.paths.removeFirst(victim.head)
+                        victim.head = 0
+                    }
+                    victim.lock.unlock()
+                    return path
+                }
+                victim.lock.unlock()
+            }
+            return nil
+        }
+
+        private func work(_ index: Int) {
+            let buffer = UnsafeMutableRawPointer.allocate(byteCount: _ConcurrentDirectoryWalker.readBufferSize, alignment: 8)
+            var batch: [DirectoryEntry] = []
+            batch.reserveCapacity(batchSize)
+            defer {
+                buffer.deallocate()
+                condition.lock()
+                runningWorkers -= 1
+                condition.broadcast()
+                condition.unlock()
+            }
+
+            while !isStopped {
+                if let path = takeDirectory(worker: index) {
+                    workCondition.lock()
+                    queuedDirectories -= 1
+                    workCondition.unlock()
+
+                    let completed = read(directoryAtPath: path, buffer: buffer, worker: index, batch: &batch)
+
+                    workCondition.lock()
+                    pendingDirectories -= 1
+                    if pendingDirectories == 0 {
+                        workCondition.broadcast()
+                    }
+                    workCondition.unlock()
+                    guard completed else { return }
+                    continue
+                }
+                // Other workers may still publish subdirectories. Hand over what has been found so far rather than
+                // keeping the caller waiting, then sleep until there is more to read or the walk is over.
+                if !batch.isEmpty {
+                    guard deliver(.entries(batch)) else { return }
+                    batch.removeAll(keepingCapacity: true)
+                }
+                workCondition.lock()
+                // A directory is appended to a deque before it is counted as queued, so no worker sleeps through one. The
+                // count can briefly run ahead of the deques, which only costs another look.
+                while queuedDirectories <= 0 && pendingDirectories > 0 && !workStopped {
+                    workCondition.wait()
+                }
+                let finished = pendingDirectories == 0 || workStopped
+                workCondition.unlock()
+                if finished {
+                    break
+                }
+            }
+            if !batch.isEmpty {
+                _ = deliver(.entries(batch))
+            }
+        }
+
+        // Returns false once the walk has been stopped.
+        private func read(directoryAtPath path: String, buffer: UnsafeMutableRawPointer, worker index: Int, batch: inout [DirectoryEntry]) -> Bool {
+            let isRoot = path == rootPath
+            var flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC
+            if !isRoot {
+                flags |= O_NOFOLLOW
+            }
+            let fd = (try? FileManager.default._fileSystemRepresentation(withPath: path) { open($0, flags) }) ?? -1
+            guard fd >= 0 else {
+                return deliver(.error(URL(fileURLWithPath: path, isDirectory: true), _NSErrorWithErrno(errno, reading: true, path: path)))
+            }
+            defer { close(fd) }
+
+            // Like the fts()-based enumerator, stay on the root's file system.
+            if !isRoot {
+                var info = stat()
+                if fstat(fd, &info) == 0 && info.st_dev != rootDevice {
+                    return true
+                }
+            }
+
+            let prefix = path == "/" ? "/" : path + "/"
+            let directoryURL = URL(fileURLWithPath: path, isDirectory: true)
+
+            var usesReaddir = false
+            readLoop: while true {
+                let count = _CF_getdents64(fd, buffer, _ConcurrentDirectoryWalker.readBufferSize)
+                if count == 0 {
+                    return true
+                }
+                if count < 0 {
+                    switch errno {
+                    case EINTR:
+                        continue readLoop
+                    case ENOSYS, EPERM:
+                        // getdents64() may be blocked by a seccomp profile; fall back to readdir().
+                        usesReaddir = true
+                        break readLoop
+                    default:
+                        return deliver(.error(directoryURL, _NSErrorWithErrno(errno, reading: true, path: path)))
+                    }
+                }
+                var offset = 0
+                while offset < count {
+                    let record = UnsafeRawPointer(buffer + offset)
+                    offset += Int(_CFDirent64GetRecordLength(record))
+                    guard visit(_CFDirent64GetName(record), type: _CFDirent64GetType(record), in: fd, prefix: prefix, directoryURL: directoryURL, worker: index, batch: &batch) else {
+                        return false
+                    }
+                }
+            }
+
+            if usesReaddir {
+                let readdirFD = dup(fd)
+                guard readdirFD >= 0, let dir = fdopendir(readdirFD) else {
+                    if readdirFD >= 0 { close(readdirFD) }
+                    return deliver(.error(directoryURL, _NSErrorWithErrno(errno, reading: true, path: path)))
+                }
+                defer { closedir(dir) }
+                while let entry = readdir(dir) {
+                    guard visit(_direntName(entry), type: entry.pointee.d_type, in: fd, prefix: prefix, directoryURL: directoryURL, worker: index, batch: &batch) else {
+                        return false
+                    }
+                }
+            }
+            return true
+        }
+
+        private func visit(_ rawName: UnsafePointer<CChar>, type: UInt8, in fd: Int32, prefix: String, directoryURL: URL, worker index: Int, batch: inout [DirectoryEntry]) -> Bool {
+            if rawName[0] == 0x2E /* . */ && (rawName[1] == 0 || (rawName[1] == 0x2E && rawName[2] == 0)) {
+                return true
+            }
+            let isHidden = rawName[0] == 0x2E
+            if isHidden && options.contains(.skipsHiddenFiles) {
+                return true
+            }
+
+            let name = FileManager.default.string(withFileSystemRepresentation: rawName, length: strlen(rawName))
+            let childPath = prefix + name
+
+            var info = stat()
+            var hasInfo = false
+            var creationDate: Date?
+            if needsStat || type == UInt8(DT_UNKNOWN) {
+                var btime = timespec()
+                var statErrno: Int32
+                if supportsStatx && !previousStatxFailed.withLock({ $0 }) {
+                    statErrno = _stat_with_btime_at(fd, rawName, &info, &btime)
+                } else {
+                    statErrno = fstatat(fd, rawName, &info, AT_SYMLINK_NOFOLLOW) == 0 ? 0 : errno
+                }
+                switch statErrno {
+                case 0:
+                    hasInfo = true
+                    if btime.tv_sec != 0 || btime.tv_nsec != 0 {
+                        creationDate = Date(timespec: btime)
+                    }
+                case EPERM, ENOSYS:
+                    previousStatxFailed.withLock { $0 = true }
+                    hasInfo = fstatat(fd, rawName, &info, AT_SYMLINK_NOFOLLOW) == 0
+                    if !hasInfo {
+                        statErrno = errno
+                    }
+                default:
+                    break
+                }
+                if !hasInfo {
+                    let url = URL(fileURLWithPath: childPath)
+                    return deliver(.error(url, _NSErrorWithErrno(statErrno, reading: true, url: url)))
+                }
+            }
+
+            let fileType: FileAttributeType
+            if hasInfo {
+                switch info.st_mode & S_IFMT {
+                case S_IFDIR: fileType = .typeDirectory
+                case S_IFREG: fileType = .typeRegular
+                case S_IFLNK: fileType = .typeSymbolicLink
+                case S_IFCHR: fileType = .typeCharacterSpecial
+                case S_IFBLK: fileType = .typeBlockSpecial
+                case S_IFSOCK: fileType = .typeSocket
+                default: fileType = .typeUnknown
+                }
+            } else {
+                switch Int32(type) {
+                case Int32(DT_DIR): fileType = .typeDirectory
+                case Int32(DT_REG): fileType = .typeRegular
+                case Int32(DT_LNK): fileType = .typeSymbolicLink
+                case Int32(DT_CHR): fileType = .typeCharacterSpecial
+                case Int32(DT_BLK): fileType = .typeBlockSpecial
+                case Int32(DT_SOCK): fileType = .typeSocket
+                default: fileType = .typeUnknown
+                }
+            }
+            let isDirectory = fileType == .typeDirectory
+            let url = URL(fileURLWithPath: childPath, isDirectory: isDirectory)
+
+            var values: [URLResourceKey: Any] = [:]
+            for key in keys {
+                switch key {
+                case .nameKey: values[key] = name
+                case .pathKey: values[key] = childPath
+                case .parentDirectoryURLKey: values[key] = directoryURL
+                case .isHiddenKey: values[key] = isHidden
+                case .isRegularFileKey: values[key] = fileType == .typeRegular
+                case .isDirectoryKey: values[key] = isDirectory
+                case .isSymbolicLinkKey: values[key] = fileType == .typeSymbolicLink
+                case .fileResourceTypeKey: values[key] = fileType
+                case .fileSizeKey, .totalFileSizeKey: values[key] = Int(info.st_size)
+                case .fileAllocatedSizeKey, .totalFileAllocatedSizeKey: values[key] = Int(info.st_blocks) * Int(info.st_blksize)
+                case .linkCountKey: values[key] = Int(info.st_nlink)
+                case .creationDateKey: values[key] = creationDate
+                case .contentAccessDateKey: values[key] = info.lastAccessDate
+                case .contentModificationDateKey: values[key] = info.lastModificationDate
+                case .fileResourceIdentifierKey: values[key] = _URLFileResourceIdentifier(path: childPath, inode: Int(info.st_ino), volumeIdentifier: Int(info.st_dev))
+                default: break
+                }
+            }
+            if !remainingKeys.isEmpty {
+                do {
+                    for (key, value) in try NSURL(fileURLWithPath: childPath, isDirectory: isDirectory).resourceValues(forKeys: remainingKeys) {
+                        values[key] = value
+                    }
+                } catch {
+                    return deliver(.error(url, error))
+                }
+            }
+
+            batch.append(DirectoryEntry(url: url, resourceValues: URLResourceValues(keys: keys, values: values)))
+            if batch.count >= batchSize {
+                guard deliver(.entries(batch)) else { return false }
+                batch.removeAll(keepingCapacity: true)
+            }
+
+            if isDirectory && !options.contains(.skipsSubdirectoryDescendants) {
+                push(childPath, worker: index)
+            }
+            return true
+        }
+    }
+}
+#endif
 
 #endif
@@ -461,6 +461,106 @@ extension FileManager {
         return NSURLDirectoryEnumerator(url: url, options: mask, errorHandler: handler)
     }
     
+    /// An item found by `enumerateDirectory(at:includingPropertiesForKeys:options:batchSize:maximumConcurrency:errorHandler:using:)`, together with the resource values that were requested for it.
+    public struct DirectoryEntry {
+        public let url: URL
+        public let resourceValues: URLResourceValues
+    }
+    
+    /// Enumerates the directory tree rooted at `url` and passes the items found to `body` in batches.
+    ///
+    /// Unlike `enumerator(at:includingPropertiesForKeys:options:errorHandler:)`, subdirectories are read concurrently by up to `maximumConcurrency` workers, so items are delivered in no particular order. The values for `keys` are fetched while walking and returned with each entry; on Linux the common ones come from a single `statx()` per item. Pass `nil` or an empty array for `keys` to avoid fetching anything beyond the item's type.
+    ///
+    /// `body` and `handler` are always invoked on the calling thread, one call at a time, and this method returns once the walk has finished. Returning `false` from either of them stops the enumeration. The root directory itself is not reported. `.skipsHiddenFiles` and `.skipsSubdirectoryDescendants` are honored as they are by `enumerator(at:includingPropertiesForKeys:options:errorHandler:)`.
+    public func enumerateDirectory(at url: URL, includingPropertiesForKeys keys: [URLResourceKey]?, options mask: DirectoryEnumerationOptions = [], batchSize: Int = 512, maximumConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount, errorHandler handler: ((URL, Error) -> Bool)? = nil, using body: ([DirectoryEntry]) -> Bool) {
+        precondition(batchSize > 0, "batchSize must be positive")
+        let keys = Set(keys ?? [])
+#if os(Linux)
+        let walker = _ConcurrentDirectoryWalker(root: url, keys: keys, options: mask, batchSize: batchSize, workerCount: max(1, maximumConcurrency))
+        walker.run(errorHandler: handler, body: body)
+#else
+        let enumerator = NSURLDirectoryEnumerator(url: url, options: mask, errorHandler: handler)
+        var batch: [DirectoryEntry] = []
+        batch.reserveCapacity(batchSize)
+        while let item = enumerator.nextObject() as? URL {
+            do {
+                batch.append(DirectoryEntry(url: item, resourceValues: keys.isEmpty ? URLResourceValues() : try item.resourceValues(forKeys: keys)))
+            } catch {
+                if let handler = handler, !handler(item, error) { return }
+                continue
+            }
+            if batch.count == batchSize {
+                guard body(batch) else { return }
+                batch.removeAll(keepingCapacity: true)
+            }
+        }
+        if !batch.isEmpty {
+            _ = body(batch)
+        }
+#endif
+    }
+    
+#if !os(Windows) && !os(WASI)
+    /// Reports what `copyItem(at:to:maximumConcurrency:)` did.
+    public struct CopyStatistics : Sendable, Equatable {
+        /// How the data of a regular file was copied.
+        public enum Method : Sendable, Hashable, CaseIterable {
+            /// The copy shares the source's extents through a reflink (`FICLONE`), so no data was duplicated.
+            case clone
+            /// The kernel copied the data with `copy_file_range()`.
+            case copyFileRange
+            /// The kernel copied the data with `sendfile()`.
+            case sendfile
+            /// The data was copied through a buffer with `pread()` and `pwrite()`.
+            case readWrite
+        }
+        
+        /// The number of regular files copied.
+        public internal(set) var regularFiles = 0
+        /// The number of directories created, including the destination when a directory is copied.
+        public internal(set) var directories = 0
+        /// The number of symbolic links recreated.
+        public internal(set) var symbolicLinks = 0
+        /// The number of other items, such as FIFOs, recreated.
+        public internal(set) var otherItems = 0
+        /// The number of bytes of file data copied or cloned.
+        public internal(set) var bytesCopied: Int64 = 0
+        /// The number of bytes in holes of sparse source files that were left as holes in the copies.
+        public internal(set) var bytesSkippedInHoles: Int64 = 0
+        /// The number of regular files copied with each method. A file that needed a fallback part way through is counted under the method that finished it.
+        public internal(set) var filesByMethod: [Method : Int] = [:]
+        
+        public init() { }
+        
+        internal mutating func _merge(_ other: CopyStatistics) {
+            regularFiles += other.regularFiles
+            directories += other.directories
+            symbolicLinks += other.symbolicLinks
+            otherItems += other.otherItems
+            bytesCopied += other.bytesCopied
+            bytesSkippedInHoles += other.bytesSkippedInHoles
+            filesByMethod.merge(other.filesByMethod, uniquingKeysWith: +)
+        }
+    }
+    
+    /// Copies the item at `srcURL` to `dstURL` like `copyItem(at:to:)`, with the cheapest mechanism the file systems involved allow, and reports how it was done.
+    ///
+    /// On Linux a regular file is first cloned with `FICLONE`, which duplicates no data on file systems with reflinks. Failing that its data is copied with `copy_file_range()`, then `sendfile()`, then `pread()` and `pwrite()`, whichever works first, and holes in sparse files are found with `SEEK_DATA`/`SEEK_HOLE` and kept. When a directory is copied, its tree of directories is created first and the regular files in it are then copied by up to `maximumConcurrency` workers at once.
+    ///
+    /// Every copied item keeps the source's permissions and access and modification times, and its owner and group when the caller is allowed to change them; otherwise the copy belongs to the caller. A directory cannot be copied into itself or its own subtree.
+    ///
+    /// The file manager's delegate is not consulted. If an error occurs, whatever was copied so far is left at `dstURL`.
+    @discardableResult
+    public func copyItem(at srcURL: URL, to dstURL: URL, maximumConcurrency: Int) throws -> CopyStatistics {
+        return try _copyItem(atPath: srcURL.path, toPath: dstURL.path, maximumConcurrency: max(1, maximumConcurrency))
+    }
+    
+    @discardableResult
+    public func copyItem(atPath srcPath: String, toPath dstPath: String, maximumConcurrency: Int) throws -> CopyStatistics {
+        return try _copyItem(atPath: srcPath, toPath: dstPath, maximumConcurrency: max(1, maximumConcurrency))
+    }
+#endif
+    
     /* subpathsAtPath: returns an NSArray of all contents and subpaths recursively from the provided path. This may be very expensive to compute for deep filesystem hierarchies, and should probably be avoided.
      */
     public func subpaths(atPath path: String) -> [String]? {
@@ -619,6 +719,9 @@ extension FileAttributeKey {
 @available(*, unavailable)
 extension FileManager.DirectoryEnumerator : Sendable { }
 
+@available(*, unavailable)
+extension FileManager.DirectoryEntry : Sendable { }
+
 extension FileManager {
     open class DirectoryEnumerator : NSEnumerator {
         
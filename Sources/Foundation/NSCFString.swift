@@ -153,6 +153,25 @@ internal func _CFSwiftStringGetBytes(_ str: AnyObject, encoding: CFStringEncodin
     switch encoding {
         // TODO: Don't treat many encodings like they are UTF8
     case CFStringEncoding(kCFStringEncodingUTF8), CFStringEncoding(kCFStringEncodingISOLatin1), CFStringEncoding(kCFStringEncodingMacRoman), CFStringEncoding(kCFStringEncodingASCII), CFStringEncoding(kCFStringEncodingNonLossyASCII):
+        let string = str as! NSString
+        if range.location == 0 && (type(of: string) == NSString.self || type(of: string) == NSMutableString.self) && string._storage._guts._isContiguousASCII {
+            // ASCII is encoded the same way in all of these encodings, so the bytes can be copied straight out of the
+            // string's own UTF-8 storage. This is how CFURL parses strings created in Swift.
+            var storage = string._storage
+            let converted = storage.withUTF8 { utf8 in
+                let count = Swift.min(range.length, utf8.count)
+                guard let buffer, maxBufLen > 0 else {
+                    return count
+                }
+                let copied = Swift.min(count, maxBufLen)
+                if copied > 0 {
+                    buffer.update(from: utf8.baseAddress!, count: copied)
+                }
+                return copied
+            }
+            usedBufLen?.pointee = converted
+            return converted
+        }
         let encodingView = (str as! NSString).substring(with: NSRange(range)).utf8
         var converted = 0
         for (idx, character) in encodingView.enumerated() {
@@ -412,7 +412,12 @@ open class NSData : NSObject, NSCopying, NSMutableCopying, NSSecureCoding {
         guard let handle = FileHandle(path: path, flags: O_RDONLY, createMode: 0) else {
             throw NSError(domain: NSPOSIXErrorDomain, code: Int(errno), userInfo: nil)
         }
+#if os(Windows)
+        // Mapping empty files fails on Windows, so only explicit FileHandle reads map there.
         let result = try handle._readDataOfLength(Int.max, untilEOF: true)
+#else
+        let result = try handle._readDataOfLength(Int.max, untilEOF: true, options: options)
+#endif
         return result
     }
 
@@ -106,6 +106,14 @@ open class NSRegularExpression: NSObject, NSCopying, NSSecureCoding, @unchecked
         return _CFRegularExpressionGetCaptureGroupNumberWithName(_internal, name._cfObject)
     }
 
+    /// How many matches so far had to clone the compiled expression because it was in use on another thread, and how many could reuse it or an earlier clone.
+    internal var _matcherStatistics: (clones: Int, reuses: Int) {
+        var clones: CFIndex = 0
+        var reuses: CFIndex = 0
+        _CFRegularExpressionGetMatcherStatistics(_internal, &clones, &reuses)
+        return (clones, reuses)
+    }
+
     /* This class method will produce a string by adding backslash escapes as necessary to the given string, to escape any characters that would otherwise be treated as pattern metacharacters.
     */
     public class func escapedPattern(for string: String) -> String { 
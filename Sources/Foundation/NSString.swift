@@ -135,6 +135,41 @@ public struct StringTransform: Equatable, Hashable, RawRepresentable, Sendable {
     public static let toXMLHex = StringTransform(rawValue: kCFStringTransformToXMLHex!._swiftObject)
 }
 
+extension StringTransform {
+    /// A sequence of transforms applied one after another.
+    ///
+    /// The transforms are looked up once, when the pipeline is created, and the pipeline keeps the transliterators and buffers it runs them with between calls. Applying a pipeline to many strings is therefore much cheaper than calling `applyingTransform(_:reverse:)` for each transform and string. A pipeline can be used from several threads at once.
+    public final class Pipeline : @unchecked Sendable {
+        private let transformer: _CFStringTransformerRef
+
+        /// Creates a pipeline that applies `transforms` in order or, if `reverse` is `true`, the reverse of each of them in the opposite order. Returns `nil` if any of the transforms is invalid.
+        public init?(_ transforms: [StringTransform], reverse: Bool = false) {
+            guard let transformer = _CFStringTransformerCreate(transforms.map { $0.rawValue }._cfObject, reverse) else {
+                return nil
+            }
+            self.transformer = transformer
+        }
+
+        deinit {
+            _CFStringTransformerDestroy(transformer)
+        }
+
+        /// Returns the result of applying the pipeline to `string`, or `nil` if a transform fails.
+        public func apply(to string: String) -> String? {
+            let result = CFStringCreateMutableCopy(kCFAllocatorSystemDefault, 0, string._cfObject)!
+            return _CFStringTransformerApply(transformer, result, nil) ? result._swiftObject : nil
+        }
+
+        /// Returns the results of applying the pipeline to each of `strings`, or `nil` if a transform fails for any of them.
+        public func apply(to strings: [String]) -> [String]? {
+            guard let results = _CFStringTransformerCreateArrayByApplying(transformer, strings._cfObject) else {
+                return nil
+            }
+            return results._swiftObject.map { ($0 as! NSString)._swiftObject }
+        }
+    }
+}
+
 
 // NSCache is marked as non-Sendable, but it actually does have locking in our implementation
 fileprivate nonisolated(unsafe) let regularExpressionCache: NSCache<NSString, NSRegularExpression> = {
@@ -436,6 +471,32 @@ extension NSString {
         return compare(string, options: [.caseInsensitive, .numeric, .widthInsensitive, .forcedOrdering], range: NSRange(location: 0, length: length), locale: Locale.current._bridgeToObjectiveC())
     }
     
+    /// Returns a key that orders the receiver among other strings in `locale` by comparing bytes, so that a large collection can be sorted without collating the strings again for every comparison.
+    ///
+    /// Compare keys with `lexicographicallyPrecedes(_:)` or `memcmp`. Only the `caseInsensitive`, `diacriticInsensitive` and `numeric` options change the key. Keys do not break ties by code point the way `forcedOrdering` does, so strings with equal keys may still compare unequal with `compare(_:options:range:locale:)`. Returns `nil` if no collator is available for `locale`.
+    public func collationKey(options mask: CompareOptions = [], locale: Locale? = nil) -> Data? {
+        let cfLocale = (locale ?? Locale.current)._bridgeToObjectiveC()._cfObject
+        let range = CFRange(location: 0, length: length)
+        // Most keys take two or three bytes per character; measure and retry only when that is not enough.
+        var key = Data(count: 2 * length + 16)
+        var keyLength = key.withUnsafeMutableBytes {
+            _CFStringGetCollationSortKey(_cfObject, range, mask._cfValue().rawValue, cfLocale, $0.baseAddress!.assumingMemoryBound(to: UInt8.self), $0.count)
+        }
+        // Every key, even that of the empty string, holds at least the separators between the collation levels.
+        guard keyLength > 0 else {
+            return nil
+        }
+        if keyLength > key.count {
+            key.count = keyLength
+            keyLength = key.withUnsafeMutableBytes {
+                _CFStringGetCollationSortKey(_cfObject, range, mask._cfValue().rawValue, cfLocale, $0.baseAddress!.assumingMemoryBound(to: UInt8.self), $0.count)
+            }
+        }
+        // Drop the terminating zero byte.
+        key.count = keyLength - 1
+        return key
+    }
+    
     public func isEqual(to aString: String) -> Bool {
         if type(of: self) == NSString.self || type(of: self) == NSMutableString.self {
             return _storage == aString
@@ -554,13 +615,22 @@ extension NSString {
     }
     
     public func rangeOfCharacter(from searchSet: CharacterSet, options mask: CompareOptions = [], range searchRange: NSRange) -> NSRange {
+        return _rangeOfCharacter(from: searchSet, findingNonMembers: false, options: mask, range: searchRange)
+    }
+
+    /// Finds the first (or, with `.backwards`, the last) character in `searchRange` that is not in `set`, without building `set.inverted`.
+    internal func _rangeOfCharacter(notIn set: CharacterSet, options mask: CompareOptions = [], range searchRange: NSRange) -> NSRange {
+        return _rangeOfCharacter(from: set, findingNonMembers: true, options: mask, range: searchRange)
+    }
+
+    private func _rangeOfCharacter(from searchSet: CharacterSet, findingNonMembers: Bool, options mask: CompareOptions, range searchRange: NSRange) -> NSRange {
         let len = length
         
         precondition(searchRange.length <= len && searchRange.location <= len - searchRange.length, "Bounds Range {\(searchRange.location), \(searchRange.length)} out of bounds; string length \(len)")
         
         var result = CFRange()
         let res = withUnsafeMutablePointer(to: &result) { (rangep: UnsafeMutablePointer<CFRange>) -> Bool in
-            return CFStringFindCharacterFromSet(_cfObject, searchSet._cfObject, CFRange(searchRange), mask._cfValue(), rangep)
+            return _CFStringFindCharacterFromSet(_cfObject, searchSet._cfObject, CFRange(searchRange), mask._cfValue(), findingNonMembers, rangep)
         }
         if res {
             return NSRange(location: result.location, length: result.length)
@@ -842,7 +912,50 @@ extension NSString {
             
             return index
         }
-        
+
+        if !reverse && enumerateBy != .composedCharacterSequences {
+            // Find the lines a batch at a time in one forward pass, rather than searching back and forth for the bounds of each.
+            let batchSize = 128
+            var stopped = false
+            withUnsafeTemporaryAllocation(of: CFRange.self, capacity: batchSize) { lineRanges in
+                withUnsafeTemporaryAllocation(of: CFIndex.self, capacity: batchSize) { contentsEnds in
+                    while !stopped && shouldContinue() {
+                        let found = _CFStringGetLineBoundsInRange(_cfObject, CFRange(location: currentIndex, length: length - currentIndex), enumerateBy == .paragraphs, lineRanges.baseAddress!, contentsEnds.baseAddress!, batchSize)
+                        for i in 0 ..< found {
+                            let fullRange = NSRange(location: lineRanges[i].location, length: lineRanges[i].length)
+                            let range = NSRange(location: fullRange.location, length: contentsEnds[i] - fullRange.location)
+
+                            var substring: String?
+                            if !opts.contains(.substringNotRequired) {
+                                substring = self.substring(with: range)
+                            }
+
+                            let oldLength = length
+
+                            var stop: ObjCBool = false
+                            block(substring, range, fullRange, &stop)
+                            if stop.boolValue {
+                                stopped = true
+                                return
+                            }
+
+                            currentIndex = nextIndex(after: fullRange, compensatingForLengthDifferenceFrom: oldLength)
+                            if length != oldLength {
+                                // The block changed the string, so the rest of the batch is out of date, and the next line need not start where this one now ends.
+                                if shouldContinue() {
+                                    var start = 0
+                                    _getBlockStart(&start, end: nil, contentsEnd: nil, forRange: NSRange(location: currentIndex, length: 0), stopAtLineSeparators: enumerateBy == .lines)
+                                    currentIndex = start
+                                }
+                                break
+                            }
+                        }
+                    }
+                }
+            }
+            return
+        }
+
         while shouldContinue() {
             var range = NSRange(location: currentIndex, length: 0)
             var fullRange = range
@@ -1078,6 +1191,9 @@ extension NSString {
     }
     
     public var decomposedStringWithCanonicalMapping: String {
+        if _CFStringIsNormalized(_cfObject, kCFStringNormalizationFormD) {
+            return _swiftObject
+        }
         let string = CFStringCreateMutable(kCFAllocatorSystemDefault, 0)!
         CFStringReplaceAll(string, self._cfObject)
         CFStringNormalize(string, kCFStringNormalizationFormD)
@@ -1085,13 +1201,25 @@ extension NSString {
     }
     
     public var precomposedStringWithCanonicalMapping: String {
+        if _passesPrecomposedQuickCheck {
+            return _swiftObject
+        }
         let string = CFStringCreateMutable(kCFAllocatorSystemDefault, 0)!
         CFStringReplaceAll(string, self._cfObject)
         CFStringNormalize(string, kCFStringNormalizationFormC)
         return string._swiftObject
     }
+
+    // Whether the normalization quick check finds the receiver in NFC already, so that
+    // precomposedStringWithCanonicalMapping returns it without normalizing.
+    internal var _passesPrecomposedQuickCheck: Bool {
+        return _CFStringIsNormalized(_cfObject, kCFStringNormalizationFormC)
+    }
     
     public var decomposedStringWithCompatibilityMapping: String {
+        if _CFStringIsNormalized(_cfObject, kCFStringNormalizationFormKD) {
+            return _swiftObject
+        }
         let string = CFStringCreateMutable(kCFAllocatorSystemDefault, 0)!
         CFStringReplaceAll(string, self._cfObject)
         CFStringNormalize(string, kCFStringNormalizationFormKD)
@@ -1099,6 +1227,9 @@ extension NSString {
     }
     
     public var precomposedStringWithCompatibilityMapping: String {
+        if _CFStringIsNormalized(_cfObject, kCFStringNormalizationFormKC) {
+            return _swiftObject
+        }
         let string = CFStringCreateMutable(kCFAllocatorSystemDefault, 0)!
         CFStringReplaceAll(string, self._cfObject)
         CFStringNormalize(string, kCFStringNormalizationFormKC)
@@ -1107,25 +1238,26 @@ extension NSString {
     
     public func components(separatedBy separator: String) -> [String] {
         let len = length
-        var lrange = range(of: separator, options: [], range: NSRange(location: 0, length: len))
-        if lrange.length == 0 {
-            return [_swiftObject]
-        } else {
-            var array = [String]()
-            var srange = NSRange(location: 0, length: len)
-            while true {
-                let trange = NSRange(location: srange.location, length: lrange.location - srange.location)
-                array.append(substring(with: trange))
-                srange.location = lrange.location + lrange.length
-                srange.length = len - srange.location
-                lrange = range(of: separator, options: [], range: srange)
-                if lrange.length == 0 {
-                    break
-                }
+        // Collect the separators in one pass rather than restarting the search after each one.
+        var separatorRanges = [NSRange]()
+        withUnsafeMutablePointer(to: &separatorRanges) { rangesPtr in
+            _ = _CFStringFindAllWithOptionsAndLocale(_cfObject, separator._cfObject, CFRange(location: 0, length: len), CompareOptions()._cfValue(true), nil, rangesPtr) { context, foundRange in
+                context!.assumingMemoryBound(to: [NSRange].self).pointee.append(NSRange(location: foundRange.location, length: foundRange.length))
+                return true
             }
-            array.append(substring(with: srange))
-            return array
         }
+        if separatorRanges.isEmpty {
+            return [_swiftObject]
+        }
+        var array = [String]()
+        array.reserveCapacity(separatorRanges.count + 1)
+        var location = 0
+        for separatorRange in separatorRanges {
+            array.append(substring(with: NSRange(location: location, length: separatorRange.location - location)))
+            location = separatorRange.location + separatorRange.length
+        }
+        array.append(substring(with: NSRange(location: location, length: len - location)))
+        return array
     }
     
     public func components(separatedBy separator: CharacterSet) -> [String] {
@@ -1153,29 +1285,16 @@ extension NSString {
     
     public func trimmingCharacters(in set: CharacterSet) -> String {
         let len = length
-        var buf = _NSStringBuffer(string: self, start: 0, end: len)
-        while !buf.isAtEnd,
-            let character = UnicodeScalar(buf.currentCharacter),
-            set.contains(character) {
-                buf.advance()
-        }
-        
-        let startOfNonTrimmedRange = buf.location // This points at the first char not in the set
-        
-        if startOfNonTrimmedRange == len { // Note that this also covers the len == 0 case, which is important to do here before the len-1 in the next line.
+        let start = _rangeOfCharacter(notIn: set, range: NSRange(location: 0, length: len)).location
+        if start == NSNotFound { // Note that this also covers the len == 0 case
             return ""
-        } else if startOfNonTrimmedRange < len - 1 {
-            buf.location = len - 1
-            while let character = UnicodeScalar(buf.currentCharacter),
-                set.contains(character),
-                buf.location >= startOfNonTrimmedRange {
-                    buf.rewind()
-            }
-            let endOfNonTrimmedRange = buf.location
-            return substring(with: NSRange(location: startOfNonTrimmedRange, length: endOfNonTrimmedRange + 1 - startOfNonTrimmedRange))
-        } else {
-            return substring(with: NSRange(location: startOfNonTrimmedRange, length: 1))
         }
+        let last = _rangeOfCharacter(notIn: set, options: .backwards, range: NSRange(location: start, length: len - start))
+        let end = last.location + last.length
+        if start == 0 && end == len {
+            return _swiftObject
+        }
+        return substring(with: NSRange(location: start, length: end - start))
     }
     
     public func padding(toLength newLength: Int, withPad padString: String, startingAt padIndex: Int) -> String {
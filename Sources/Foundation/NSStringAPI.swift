@@ -668,17 +668,98 @@ extension StringProtocol {
     public func enumerateLines(
         invoking body: @escaping (_ line: String, _ stop: inout Bool) -> Void
         ) {
-        _ns.enumerateLines {
-            (line: String, stop: UnsafeMutablePointer<ObjCBool>)
-            in
-            var stop_ = false
-            body(line, &stop_)
-            if stop_ {
-                stop.pointee = true
+        enumerateLineViews { line, _, stop in
+            body(String(line), &stop)
+        }
+    }
+
+    /// Enumerates all the lines in a string as views into it.
+    ///
+    /// Unlike `enumerateLines(invoking:)`, this does not create a string
+    /// for each line: the lines are found in one pass over the string's
+    /// UTF-8 and passed to `body` as slices that share its storage, which
+    /// are substrings when the string is a `String` or a `Substring`.
+    ///
+    /// - Parameter body: The closure to call for each line, with:
+    ///     - The line, without its terminator.
+    ///     - The range of the line including its terminator, if any.
+    ///     - An `inout` Boolean value that the closure can use to stop the
+    ///       enumeration by setting `stop = true`.
+    public func enumerateLineViews(
+        invoking body: (_ line: SubSequence, _ enclosingRange: Range<Index>, _ stop: inout Bool) -> Void
+        ) {
+        let enumerated: Void? = utf8.withContiguousStorageIfAvailable { bytes in
+            var stop = false
+            var lineStart = startIndex
+            var lineStartOffset = 0
+            var offset = 0
+            while lineStartOffset < bytes.count && !stop {
+                offset = _lineBreakOffset(in: bytes, from: offset)
+                var lineEndOffset = offset
+                if offset < bytes.count {
+                    let byte = bytes[offset]
+                    if byte == 0x0A {
+                        lineEndOffset += 1
+                    } else if byte == 0x0D {
+                        lineEndOffset += (offset + 1 < bytes.count && bytes[offset + 1] == 0x0A) ? 2 : 1
+                    } else {
+                        // U+0085 is two bytes long; U+2028 and U+2029 are three.
+                        lineEndOffset += byte == 0xC2 ? 2 : 3
+                    }
+                }
+                let contentsEnd = utf8.index(lineStart, offsetBy: offset - lineStartOffset)
+                let lineEnd = utf8.index(contentsEnd, offsetBy: lineEndOffset - offset)
+                body(self[lineStart ..< contentsEnd], lineStart ..< lineEnd, &stop)
+                lineStart = lineEnd
+                lineStartOffset = lineEndOffset
+                offset = lineEndOffset
+            }
+        }
+        if enumerated == nil {
+            _ns.enumerateSubstrings(in: NSRange(location: 0, length: _ns.length), options: [.byLines, .substringNotRequired]) { _, range, enclosingRange, stop in
+                var stop_ = false
+                body(self[self._toRange(range)], self._toRange(enclosingRange), &stop_)
+                if stop_ {
+                    stop.pointee = true
+                }
             }
         }
     }
 
+    /// Returns the offset of the first line or paragraph separator in
+    /// `bytes` at or after `offset`, or `bytes.count` if there is none.
+    /// Words of eight ASCII bytes with no control character from `"\n"`
+    /// to `"\r"` are skipped without looking at each byte.
+    private func _lineBreakOffset(in bytes: UnsafeBufferPointer<UInt8>, from offset: Int) -> Int {
+        var index = offset
+        while index < bytes.count {
+            let wordEnd = Swift.min(index + 8, bytes.count)
+            if wordEnd - index == 8 {
+                let word = UnsafeRawPointer(bytes.baseAddress!).loadUnaligned(fromByteOffset: index, as: UInt64.self)
+                let low = word & 0x7F7F7F7F7F7F7F7F
+                let controls = ((low &+ 0x0101010101010101 &* (0x80 - 0x0A)) ^ (low &+ 0x0101010101010101 &* (0x7F - 0x0D))) & ~word & 0x8080808080808080
+                if controls | (word & 0x8080808080808080) == 0 {
+                    index = wordEnd
+                    continue
+                }
+            }
+            // A separator that starts in this word may end past it.
+            while index < wordEnd {
+                switch bytes[index] {
+                case 0x0A, 0x0D:
+                    return index
+                case 0xC2 where index + 1 < bytes.count && bytes[index + 1] == 0x85:
+                    return index
+                case 0xE2 where index + 2 < bytes.count && bytes[index + 1] == 0x80 && (bytes[index + 2] == 0xA8 || bytes[index + 2] == 0xA9):
+                    return index
+                default:
+                    index += 1
+                }
+            }
+        }
+        return bytes.count
+    }
+
     // @property NSStringEncoding fastestEncoding;
 
     /// The fastest encoding to which the string can be converted without loss
@@ -745,6 +826,15 @@ extension StringProtocol {
         return _ns.localizedStandardCompare(string._ephemeralString)
     }
 
+    /// Returns a key that orders the string among other strings in `locale`
+    /// by comparing bytes, or `nil` if no collator is available for `locale`.
+    public func collationKey(
+        options mask: String.CompareOptions = [],
+        locale: Locale? = nil
+        ) -> Data? {
+        return _ns.collationKey(options: mask, locale: locale)
+    }
+
     //===--- Omitted for consistency with API review results 5/20/2014 ------===//
     // @property long long longLongValue
 
@@ -9,6 +9,9 @@
 
 
 @_implementationOnly import CoreFoundation
+#if !os(WASI)
+import Dispatch
+#endif
 #if os(Windows)
 import WinSDK
 #endif
@@ -90,6 +93,7 @@ open class NSURL : NSObject, NSSecureCoding, NSCopying, @unchecked Sendable {
     internal var _baseURL : UnsafeMutablePointer<AnyObject>? = nil // CFURL
     internal var _extra : OpaquePointer? = nil
     internal var _resourceInfo : OpaquePointer? = nil
+    internal var _componentCache : OpaquePointer? = nil
     internal var _range1 = NSRange(location: 0, length: 0)
     internal var _range2 = NSRange(location: 0, length: 0)
     internal var _range3 = NSRange(location: 0, length: 0)
@@ -606,6 +610,38 @@ open class NSURL : NSObject, NSSecureCoding, NSCopying, @unchecked Sendable {
         guard let storage = _resourceStorage else { return [:] }
         return try storage.resourceValues(forKeys: keys, url: self)
     }
+    /// Removes the cached values for `keys` and fetches them again from the file system. Temporary resource values are returned as they are.
+    ///
+    /// Values that come from the same `stat` of the item, such as its size, type and dates, are cached as a set, so refreshing one of them refreshes all of them.
+    open func refreshResourceValues(forKeys keys: [URLResourceKey]) throws -> [URLResourceKey : Any] {
+        guard let storage = _resourceStorage else { return [:] }
+        return try storage.refreshResourceValues(forKeys: keys, url: self)
+    }
+    /// Fetches the values for `keys` of each of `urls` and caches them on those URLs, as `resourceValues(forKeys:)` would. Each item is only `stat`ed once for all of the values derived from that.
+    ///
+    /// - Parameters:
+    ///   - maximumConcurrency: The number of threads that fetch values at the same time. By default the URLs are handled one after the other on the calling thread.
+    /// - Returns: The values for each URL, or the error that fetching them threw, in the same order as `urls`.
+    open class func resourceValues(forKeys keys: [URLResourceKey], of urls: [NSURL], maximumConcurrency: Int = 1) -> [Result<[URLResourceKey : Any], Error>] {
+        var results = [Result<[URLResourceKey : Any], Error>](repeating: .success([:]), count: urls.count)
+        let workerCount = Swift.max(1, Swift.min(maximumConcurrency, urls.count))
+        results.withUnsafeMutableBufferPointer { buffer in
+            let results = buffer
+            let fetch = { (worker: Int) in
+                for index in stride(from: worker, to: urls.count, by: workerCount) {
+                    results[index] = Result { try urls[index].resourceValues(forKeys: keys) }
+                }
+            }
+#if !os(WASI)
+            if workerCount > 1 {
+                DispatchQueue.concurrentPerform(iterations: workerCount, execute: fetch)
+                return
+            }
+#endif
+            fetch(0)
+        }
+        return results
+    }
     open func setResourceValue(_ value: Any?, forKey key: URLResourceKey) throws {
         guard let storage = _resourceStorage else { return }
         try storage.setResourceValue(value, forKey: key, url: self)
@@ -623,29 +659,61 @@ open class NSURL : NSObject, NSSecureCoding, NSCopying, @unchecked Sendable {
 internal class URLResourceValuesStorage: NSObject {
     let valuesCacheLock = NSLock()
     var valuesCache: [URLResourceKey: Any] = [:]
+    // The keys in valuesCache that were filled in from one stat of the item. They are removed together, so that
+    // the next access stats the item again instead of mixing values from before and after a change.
+    var statCachedKeys: Set<URLResourceKey> = []
+    // The keys in valuesCache that were set with setTemporaryResourceValue(_:forKey:).
+    var temporaryKeys: Set<URLResourceKey> = []
     
     func removeAllCachedResourceValues() {
         valuesCacheLock.lock()
         defer { valuesCacheLock.unlock() }
         
         valuesCache = [:]
+        statCachedKeys = []
+        temporaryKeys = []
     }
     
     func removeCachedResourceValue(forKey key: URLResourceKey) {
         valuesCacheLock.lock()
         defer { valuesCacheLock.unlock() }
         
+        _removeCachedResourceValue(forKey: key)
+    }
+    
+    // Must be called with valuesCacheLock held.
+    private func _removeCachedResourceValue(forKey key: URLResourceKey) {
         valuesCache.removeValue(forKey: key)
+        temporaryKeys.remove(key)
+        if statCachedKeys.contains(key) {
+            for statKey in statCachedKeys {
+                valuesCache.removeValue(forKey: statKey)
+            }
+            statCachedKeys = []
+        }
+    }
+    
+    // Must be called with valuesCacheLock held. Values fetched for the requested keys replace what was cached; the
+    // other values from the same stat only fill in keys that had no value yet.
+    private func _cacheFetchedValues(_ fetched: [URLResourceKey: Any], statValues: [URLResourceKey: Any]) {
+        valuesCache.merge(fetched, uniquingKeysWith: { $1 })
+        for (key, value) in statValues where fetched[key] != nil || valuesCache[key] == nil {
+            valuesCache[key] = value
+            statCachedKeys.insert(key)
+        }
     }
     
     func setTemporaryResourceValue(_ value: Any?, forKey key: URLResourceKey) {
         valuesCacheLock.lock()
         defer { valuesCacheLock.unlock() }
         
+        statCachedKeys.remove(key)
         if let value = value {
             valuesCache[key] = value
+            temporaryKeys.insert(key)
         } else {
             valuesCache.removeValue(forKey: key)
+            temporaryKeys.remove(key)
         }
     }
     
@@ -660,11 +728,13 @@ internal class URLResourceValuesStorage: NSObject {
             return
         }
         
-        let fetchedValues = try read([key], for: url)
-        if let fetched = fetchedValues[key] {
-            valuesCacheLock.synchronized {
-                valuesCache[key] = fetched
-            }
+        var statValues: [URLResourceKey: Any] = [:]
+        let fetchedValues = try read([key], for: url, statValues: &statValues)
+        let fetched = fetchedValues[key] ?? nil
+        valuesCacheLock.synchronized {
+            _cacheFetchedValues(fetched.map { [key: $0] } ?? [:], statValues: statValues)
+        }
+        if let fetched {
             value = __SwiftValue.store(fetched)
         } else {
             value = nil
@@ -687,10 +757,11 @@ internal class URLResourceValuesStorage: NSObject {
         }
         
         if keysToFetch.count > 0 {
-            let found = try read(keysToFetch, for: url).compactMapValues { $0 }
+            var statValues: [URLResourceKey: Any] = [:]
+            let found = try read(keysToFetch, for: url, statValues: &statValues).compactMapValues { $0 }
             
             valuesCacheLock.synchronized {
-                valuesCache.merge(found, uniquingKeysWith: { $1 })
+                _cacheFetchedValues(found, statValues: statValues)
             }
             
             result.merge(found, uniquingKeysWith: { $1 })
@@ -699,6 +770,15 @@ internal class URLResourceValuesStorage: NSObject {
         return result
     }
     
+    func refreshResourceValues(forKeys keys: [URLResourceKey], url: NSURL) throws -> [URLResourceKey : Any] {
+        valuesCacheLock.synchronized {
+            for key in keys where !temporaryKeys.contains(key) {
+                _removeCachedResourceValue(forKey: key)
+            }
+        }
+        return try resourceValues(forKeys: keys, url: url)
+    }
+    
     func setResourceValue(_ value: Any?, forKey key: URLResourceKey, url: NSURL) throws {
         try write([key: value], to: url)
         
@@ -706,6 +786,7 @@ internal class URLResourceValuesStorage: NSObject {
         defer { valuesCacheLock.unlock() }
         
         valuesCache[key] = value
+        statCachedKeys.remove(key)
     }
     
     func setResourceValues(_ keyedValues: [URLResourceKey : Any], url: NSURL) throws {
@@ -715,6 +796,7 @@ internal class URLResourceValuesStorage: NSObject {
         defer { valuesCacheLock.unlock() }
         
         valuesCache.merge(keyedValues, uniquingKeysWith: { $1 })
+        statCachedKeys.subtract(keyedValues.keys)
     }
     
     internal override init() {
@@ -726,6 +808,8 @@ internal class URLResourceValuesStorage: NSObject {
         defer { storage.valuesCacheLock.unlock() }
         
         valuesCache = storage.valuesCache
+        statCachedKeys = storage.statCachedKeys
+        temporaryKeys = storage.temporaryKeys
         super.init()
     }
 }
@@ -1199,13 +1283,101 @@ internal class _URLFileResourceIdentifier: NSObject {
     }
 }
 
+#if !os(Windows)
+/// The resource values that can be answered from one `stat` of an item: its type, size, link count, identity and dates. On Linux the item is examined with `statx(2)`, which also reports its creation date.
+internal struct _URLStatResourceValues {
+    static let keys: Set<URLResourceKey> = {
+        var keys: Set<URLResourceKey> = [.isRegularFileKey, .isDirectoryKey, .isSymbolicLinkKey, .isPackageKey, .fileResourceTypeKey, .fileSizeKey, .totalFileSizeKey, .fileAllocatedSizeKey, .totalFileAllocatedSizeKey, .linkCountKey, .fileResourceIdentifierKey, .contentAccessDateKey, .contentModificationDateKey]
+#if os(Linux) || canImport(Darwin)
+        keys.insert(.creationDateKey)
+#endif
+        return keys
+    }()
+    
+    let info: stat
+    let creationDate: Date?
+    
+    init(path: String) throws {
+#if os(Linux)
+        (info, creationDate) = try FileManager.default._statxFile(atPath: path)
+#else
+        info = try FileManager.default._lstatFile(atPath: path)
+#if canImport(Darwin)
+        creationDate = info.creationDate
+#else
+        creationDate = nil
+#endif
+#endif
+    }
+    
+    var fileType: FileAttributeType {
+        switch info.st_mode & S_IFMT {
+        case S_IFDIR: return .typeDirectory
+        case S_IFREG: return .typeRegular
+        case S_IFLNK: return .typeSymbolicLink
+        case S_IFCHR: return .typeCharacterSpecial
+        case S_IFBLK: return .typeBlockSpecial
+        case S_IFSOCK: return .typeSocket
+        default: return .typeUnknown
+        }
+    }
+    
+    func value(forKey key: URLResourceKey, path: String, url: NSURL) -> Any? {
+        switch key {
+        case .isRegularFileKey: return fileType == .typeRegular
+        case .isDirectoryKey: return fileType == .typeDirectory
+        case .isSymbolicLinkKey: return fileType == .typeSymbolicLink
+        case .isPackageKey: return fileType == .typeDirectory && url.pathExtension != nil && url.pathExtension != ""
+        case .fileResourceTypeKey: return fileType
+        case .fileSizeKey, .totalFileSizeKey: return Int(info.st_size)
+        case .fileAllocatedSizeKey, .totalFileAllocatedSizeKey: return Int(info.st_blocks) * Int(info.st_blksize)
+        case .linkCountKey: return Int(info.st_nlink)
+        case .fileResourceIdentifierKey: return _URLFileResourceIdentifier(path: path, inode: Int(info.st_ino), volumeIdentifier: Int(info.st_dev))
+        case .creationDateKey: return creationDate
+        case .contentAccessDateKey: return info.lastAccessDate
+        case .contentModificationDateKey: return info.lastModificationDate
+        default: return nil
+        }
+    }
+    
+    func allValues(path: String, url: NSURL) -> [URLResourceKey: Any] {
+        var values: [URLResourceKey: Any] = [:]
+        for key in _URLStatResourceValues.keys {
+            values[key] = value(forKey: key, path: path, url: url)
+        }
+        return values
+    }
+}
+#endif
+
 fileprivate extension URLResourceValuesStorage {
-    func read(_ keys: [URLResourceKey], for url: NSURL) throws -> [URLResourceKey: Any?] {
+    /// Reads `keys` from the file system. If any of them is answered by a `stat` of the item, `statValues` is set to all of the values that stat answers, so that they can be cached together.
+    func read(_ keys: [URLResourceKey], for url: NSURL, statValues: inout [URLResourceKey: Any]) throws -> [URLResourceKey: Any?] {
         var result: [URLResourceKey: Any?] = [:]
         
         let fm = FileManager.default
         let path = url.path ?? ""
         
+#if !os(Windows)
+        // Memoized access to the stat-derived values:
+        
+        var statStorage: _URLStatResourceValues?
+        func itemStat() throws -> _URLStatResourceValues {
+            if let storage = statStorage {
+                return storage
+            } else {
+                let storage = try _URLStatResourceValues(path: path)
+                statStorage = storage
+                return storage
+            }
+        }
+        defer {
+            if let statStorage {
+                statValues = statStorage.allValues(path: path, url: url)
+            }
+        }
+#endif
+        
         // Memoized access to attributes:
         
         var fileAttributesStorage: [FileAttributeKey: Any]? = nil
@@ -1292,6 +1464,12 @@ fileprivate extension URLResourceValuesStorage {
         }
         
         for key in keys {
+#if !os(Windows)
+            if _URLStatResourceValues.keys.contains(key) {
+                result[key] = try itemStat().value(forKey: key, path: path, url: url)
+                continue
+            }
+#endif
             switch key {
             case .nameKey:
                 result[key] = url.lastPathComponent
@@ -9,6 +9,7 @@
 
 #if canImport(Dispatch)
 @preconcurrency import Dispatch
+internal import Synchronization
 
 internal let _NSOperationIsFinished = "isFinished"
 internal let _NSOperationIsFinishedAlternate = "finished"
@@ -63,7 +64,7 @@ open class Operation : NSObject, @unchecked Sendable {
             return lhs.contents.toOpaque() == rhs.contents.toOpaque()
         }
     }
-    enum __NSOperationState : UInt8, Sendable {
+    enum __NSOperationState : UInt8, Sendable, AtomicRepresentable {
         case initialized = 0x00
         case enqueuing = 0x48
         case enqueued = 0x50
@@ -80,15 +81,17 @@ open class Operation : NSObject, @unchecked Sendable {
     internal var __queue: Unmanaged<OperationQueue>?
     internal var __dependencies = [Operation]()
     internal var __downDependencies = Set<PointerHashedUnmanagedBox<Operation>>()
-    internal var __unfinishedDependencyCount: Int = 0
+    internal let __unfinishedDependencyCount = Atomic<Int>(0)
     internal var __completion: (@Sendable () -> Void)?
     internal var __name: String?
     internal var __schedule: DispatchWorkItem?
-    internal var __state: __NSOperationState = .initialized
+    internal let __state = Atomic<__NSOperationState>(.initialized)
     internal var __priorityValue: Operation.QueuePriority.RawValue?
-    internal var __cachedIsReady: Bool = true
-    internal var __isCancelled: Bool = false
+    internal let __cachedIsReady = Atomic<Bool>(true)
+    internal let __isCancelled = Atomic<Bool>(false)
     internal var __propertyQoS: QualityOfService?
+    // Whether the operation waits for dependencies outside its queue's priority lists. Guarded by the queue's lock.
+    internal var __parked = false
     
     var __waitCondition = NSCondition()
     var __lock = NSLock()
@@ -96,23 +99,15 @@ open class Operation : NSObject, @unchecked Sendable {
     
     internal var _state: __NSOperationState {
         get {
-            __atomicLoad.lock()
-            defer { __atomicLoad.unlock() }
-            return __state
+            return __state.load(ordering: .acquiring)
         }
         set(newValue) {
-            __atomicLoad.lock()
-            defer { __atomicLoad.unlock() }
-            __state = newValue
+            __state.store(newValue, ordering: .releasing)
         }
     }
     
     internal func _compareAndSwapState(_ old: __NSOperationState, _ new: __NSOperationState) -> Bool {
-        __atomicLoad.lock()
-        defer { __atomicLoad.unlock() }
-        if __state != old { return false }
-        __state = new
-        return true
+        return __state.compareExchange(expected: old, desired: new, ordering: .acquiringAndReleasing).exchanged
     }
     
     internal func _lock() {
@@ -129,7 +124,7 @@ open class Operation : NSObject, @unchecked Sendable {
         return __queue?.takeUnretainedValue()
     }
     
-    internal func _adopt(queue: OperationQueue, schedule: DispatchWorkItem) {
+    internal func _adopt(queue: OperationQueue, schedule: DispatchWorkItem?) {
         _lock()
         defer { _unlock() }
         __queue = Unmanaged.passRetained(queue)
@@ -137,29 +132,48 @@ open class Operation : NSObject, @unchecked Sendable {
     }
     
     internal var _isCancelled: Bool {
-        __atomicLoad.lock()
-        defer { __atomicLoad.unlock() }
-        return __isCancelled
+        return __isCancelled.load(ordering: .acquiring)
     }
     
     internal var _unfinishedDependencyCount: Int {
         get {
-            __atomicLoad.lock()
-            defer { __atomicLoad.unlock() }
-            return __unfinishedDependencyCount
+            return __unfinishedDependencyCount.load(ordering: .acquiring)
         }
     }
     
     internal func _incrementUnfinishedDependencyCount(by amount: Int = 1) {
-        __atomicLoad.lock()
-        defer { __atomicLoad.unlock() }
-        __unfinishedDependencyCount += amount
+        __unfinishedDependencyCount.wrappingAdd(amount, ordering: .acquiringAndReleasing)
     }
     
     internal func _decrementUnfinishedDependencyCount(by amount: Int = 1) {
-        __atomicLoad.lock()
-        defer { __atomicLoad.unlock() }
-        __unfinishedDependencyCount -= amount
+        __unfinishedDependencyCount.wrappingSubtract(amount, ordering: .acquiringAndReleasing)
+    }
+    
+    /// Counts down one finished dependency and returns whether that was the last one. The count is already zero
+    /// when the operation was cancelled, and stays there.
+    internal func _dependencyFinished() -> Bool {
+        var count = __unfinishedDependencyCount.load(ordering: .relaxed)
+        while count > 0 {
+            let (exchanged, original) = __unfinishedDependencyCount.compareExchange(expected: count, desired: count - 1, ordering: .acquiringAndReleasing)
+            if exchanged {
+                return count == 1
+            }
+            count = original
+        }
+        return false
+    }
+    
+    /// Reschedules operations whose last dependency just finished, with one pass over each queue involved.
+    internal static func _dependenciesFinished(_ ops: [Operation]) {
+        var byQueue = [ObjectIdentifier: (queue: OperationQueue, ops: [Operation])]()
+        for op in ops {
+            op._cachedIsReady = op.isReady
+            guard let queue = op._queue else { continue }
+            byQueue[ObjectIdentifier(queue), default: (queue, [])].ops.append(op)
+        }
+        for (queue, readyOps) in byQueue.values {
+            queue._schedule(unparking: readyOps)
+        }
     }
     
     internal func _addParent(_ parent: Operation) {
@@ -172,23 +186,17 @@ open class Operation : NSObject, @unchecked Sendable {
     
     internal var _cachedIsReady: Bool {
         get {
-            __atomicLoad.lock()
-            defer { __atomicLoad.unlock() }
-            return __cachedIsReady
+            return __cachedIsReady.load(ordering: .acquiring)
         }
         set(newValue) {
-            __atomicLoad.lock()
-            defer { __atomicLoad.unlock() }
-            __cachedIsReady = newValue
+            __cachedIsReady.store(newValue, ordering: .releasing)
         }
     }
     
     internal func _fetchCachedIsReady(_ retest: inout Bool) -> Bool {
         let setting = _cachedIsReady
         if !setting {
-            _lock()
-            retest = __unfinishedDependencyCount == 0
-            _unlock()
+            retest = _unfinishedDependencyCount == 0
         }
         return setting
     }
@@ -245,7 +253,6 @@ open class Operation : NSObject, @unchecked Sendable {
                     return
                 }
                 
-                var ready_deps = [Operation]()
                 op._lock()
                 let state = op._state
                 if op.__queue != nil && state.rawValue < __NSOperationState.starting.rawValue {
@@ -257,39 +264,25 @@ open class Operation : NSObject, @unchecked Sendable {
                     op._unlock()
                     return
                 }
+                // Dependents registered from here on see the operation finished and do not wait for it.
                 let down_deps = op.__downDependencies
                 op.__downDependencies.removeAll()
-                if 0 < down_deps.count {
-                    for down in down_deps {
-                        let idown = down.contents.takeUnretainedValue()
-                        idown._lock()
-                        if idown._unfinishedDependencyCount == 1 {
-                            ready_deps.append(idown)
-                        } else if idown._unfinishedDependencyCount > 1 {
-                            idown._decrementUnfinishedDependencyCount()
-                        } else {
-                            assert(idown._unfinishedDependencyCount  == 0)
-                            assert(idown._isCancelled == true)
-                        }
-                        idown._unlock()
-                    }
-                }
-                
                 op._state = .finished
                 let oq = op.__queue
                 op.__queue = nil
                 op._unlock()
                 
-                if 0 < ready_deps.count {
-                    for down in ready_deps {
-                        down._lock()
-                        if down._unfinishedDependencyCount >= 1 {
-                            down._decrementUnfinishedDependencyCount()
-                        }
-                        down._unlock()
-                        Operation.observeValue(forKeyPath: _NSOperationIsReady, ofObject: down)
+                // Each dependent counts down atomically; only those that reach zero are rescheduled.
+                var ready_deps = [Operation]()
+                for down in down_deps {
+                    let idown = down.contents.takeUnretainedValue()
+                    if idown._dependencyFinished() {
+                        ready_deps.append(idown)
                     }
                 }
+                if 0 < ready_deps.count {
+                    Operation._dependenciesFinished(ready_deps)
+                }
                 
                 op.__waitCondition.lock()
                 op.__waitCondition.broadcast()
@@ -317,7 +310,7 @@ open class Operation : NSObject, @unchecked Sendable {
                 op._cachedIsReady = r
                 let q = op._queue
                 if r {
-                    q?._schedule()
+                    q?._schedule(unparking: [op])
                 }
             }
         }
@@ -369,16 +362,14 @@ open class Operation : NSObject, @unchecked Sendable {
     open func cancel() {
         if isFinished { return }
         
-        __atomicLoad.lock()
-        __isCancelled = true
-        __atomicLoad.unlock()
+        __isCancelled.store(true, ordering: .releasing)
         
         if __NSOperationState.executing.rawValue <= _state.rawValue {
             return
         }
         
         _lock()
-        __unfinishedDependencyCount = 0
+        __unfinishedDependencyCount.store(0, ordering: .releasing)
         _unlock()
         Operation.observeValue(forKeyPath: _NSOperationIsReady, ofObject: self)
     }
@@ -397,9 +388,7 @@ open class Operation : NSObject, @unchecked Sendable {
     }
     
     open var isReady: Bool {
-        _lock()
-        defer { _unlock() }
-        return __unfinishedDependencyCount == 0
+        return _unfinishedDependencyCount == 0
     }
     
     internal func _addDependency(_ op: Operation) {
@@ -434,6 +423,34 @@ open class Operation : NSObject, @unchecked Sendable {
         _addDependency(op)
     }
     
+    /// Makes the receiver dependent on each of `ops`, like calling `addDependency(_:)` for each of them, but checks
+    /// for duplicates with a set rather than by scanning the existing dependencies, and updates readiness once.
+    public func addDependencies(_ ops: [Operation]) {
+        withExtendedLifetime(self) {
+            var added = [Operation]()
+            _lock()
+            var existing = Set(__dependencies.map(ObjectIdentifier.init))
+            for op in ops where op !== self && existing.insert(ObjectIdentifier(op)).inserted {
+                __dependencies.append(op)
+                added.append(op)
+            }
+            _unlock()
+            
+            for upwards in added {
+                upwards._lock()
+                _lock()
+                let upIsFinished = upwards._state == __NSOperationState.finished
+                if !upIsFinished && !_isCancelled {
+                    _incrementUnfinishedDependencyCount()
+                    upwards._addParent(self)
+                }
+                _unlock()
+                upwards._unlock()
+            }
+            Operation.observeValue(forKeyPath: _NSOperationIsReady, ofObject: self)
+        }
+    }
+    
     open func removeDependency(_ op: Operation) {
         withExtendedLifetime(self) {
             withExtendedLifetime(op) {
@@ -753,8 +770,194 @@ internal final class _OperationQueueProgress : Progress, @unchecked Sendable {
     }
 }
 
+/// Runs the operations an `OperationQueue` in `.workStealing` mode has released for execution.
+///
+/// Each worker owns a deque with one band per queue priority. Operations released while a worker runs (typically the
+/// dependents of the operation it just finished) go to that worker's own deque; operations released from any other
+/// thread are spread across the deques. A worker takes the newest operation of the highest non-empty band of its own
+/// deque and, when that is empty, steals the oldest operation of the highest non-empty band of another. Workers are
+/// dispatch blocks that keep running while there is work and retire when there is none, so an idle queue holds no threads.
+///
+/// An operation holds its worker until it finishes, even while it waits for another operation of the queue, so a
+/// worker that starts an operation makes sure another is ready for the rest. The dispatch queue only runs the spare
+/// workers when it has a thread for them, like the work items of a `.dispatch` queue. There are at most as many idle
+/// workers as deques; the ones without a deque only steal.
+internal final class _OperationWorkStealingScheduler : @unchecked Sendable {
+    internal final class WorkDeque : NSObject {
+        unowned let scheduler: _OperationWorkStealingScheduler
+        let index: Int
+        let lock = NSLock()
+        // Indexed like `Operation.QueuePriority.priorities`, highest first. Guarded by `lock`.
+        var bands: [[Operation]] = Array(repeating: [], count: Operation.QueuePriority.priorities.count)
+        var heads: [Int] = Array(repeating: 0, count: Operation.QueuePriority.priorities.count)
+
+        init(scheduler: _OperationWorkStealingScheduler, index: Int) {
+            self.scheduler = scheduler
+            self.index = index
+        }
+
+        func push(_ op: Operation, band: Int) {
+            lock.lock()
+            bands[band].append(op)
+            lock.unlock()
+        }
+
+        func take(stealing: Bool) -> Operation? {
+            lock.lock()
+            defer { lock.unlock() }
+            for band in bands.indices where bands[band].count > heads[band] {
+                let op: Operation
+                if stealing {
+                    op = bands[band][heads[band]]
+                    heads[band] += 1
+                } else {
+                    op = bands[band].removeLast()
+                }
+                if heads[band] == bands[band].count {
+                    bands[band].removeAll(keepingCapacity: true)
+                    heads[band] = 0
+                } else if heads[band] > 1024 && heads[band] * 2 > bands[band].count {
+                    bands[band].removeFirst(heads[band])
+                    heads[band] = 0
+                }
+                return op
+            }
+            return nil
+        }
+    }
+
+    static internal nonisolated(unsafe) var _currentDeque = NSThreadSpecific<WorkDeque>()
+
+    private unowned let queue: OperationQueue
+    private let target: DispatchQueue
+    private var deques: [WorkDeque] = []
+    // Operations pushed but not yet taken, workers running, and those of them running or about to run an operation.
+    private let queued = Atomic<Int>(0)
+    private let activeWorkers = Atomic<Int>(0)
+    private let busyWorkers = Atomic<Int>(0)
+    private let nextDeque = Atomic<Int>(0)
+    private let claimedDeques: Mutex<[Bool]>
+
+    init(queue: OperationQueue, dequeCount: Int, target: DispatchQueue) {
+        self.queue = queue
+        self.target = target
+        self.claimedDeques = Mutex(Array(repeating: false, count: dequeCount))
+        self.deques = (0..<dequeCount).map { WorkDeque(scheduler: self, index: $0) }
+    }
+
+    private static func band(of op: Operation) -> Int {
+        let priority = op is _BarrierOperation ? Operation.QueuePriority.barrier : op.queuePriority.rawValue
+        return Operation.QueuePriority.priorities.firstIndex(of: priority) ?? Operation.QueuePriority.priorities.count - 1
+    }
+
+    /// Hands operations that have been moved to the dispatching state to the workers.
+    func submit(_ ops: [Operation]) {
+        if let own = _OperationWorkStealingScheduler._currentDeque.current, own.scheduler === self {
+            for op in ops {
+                own.push(op, band: _OperationWorkStealingScheduler.band(of: op))
+            }
+        } else {
+            for op in ops {
+                let index = nextDeque.wrappingAdd(1, ordering: .relaxed).oldValue
+                deques[index % deques.count].push(op, band: _OperationWorkStealingScheduler.band(of: op))
+            }
+        }
+        queued.wrappingAdd(ops.count, ordering: .sequentiallyConsistent)
+        _startWorkers()
+    }
+
+    // Whether fewer of the `active` workers are idle than there are queued operations, counting up to one per deque.
+    private func _needsWorker(active: Int) -> Bool {
+        let idle = active - busyWorkers.load(ordering: .sequentiallyConsistent)
+        return idle < Swift.min(queued.load(ordering: .sequentiallyConsistent), deques.count)
+    }
+
+    private func _startWorkers() {
+        while true {
+            let active = activeWorkers.load(ordering: .sequentiallyConsistent)
+            guard _needsWorker(active: active) else {
+                return
+            }
+            if activeWorkers.compareExchange(expected: active, desired: active + 1, ordering: .acquiringAndReleasing).exchanged {
+                target.async {
+                    self._work()
+                }
+            }
+        }
+    }
+
+    private func _take(from index: Int?) -> Operation? {
+        if let index, let op = deques[index].take(stealing: false) {
+            return op
+        }
+        let start = index.map { $0 + 1 } ?? 0
+        for offset in 0..<deques.count where (start + offset) % deques.count != index {
+            if let op = deques[(start + offset) % deques.count].take(stealing: true) {
+                return op
+            }
+        }
+        return nil
+    }
+
+    private func _work() {
+        while true {
+            let index = claimedDeques.withLock { claimed -> Int? in
+                guard let index = claimed.firstIndex(of: false) else {
+                    return nil
+                }
+                claimed[index] = true
+                return index
+            }
+            if let index {
+                _OperationWorkStealingScheduler._currentDeque.set(deques[index])
+            }
+            while true {
+                // Count as busy before taking, so that a worker started meanwhile is never missing.
+                busyWorkers.wrappingAdd(1, ordering: .sequentiallyConsistent)
+                guard let op = _take(from: index) else {
+                    busyWorkers.wrappingSubtract(1, ordering: .sequentiallyConsistent)
+                    break
+                }
+                queued.wrappingSubtract(1, ordering: .sequentiallyConsistent)
+                // The operation may wait for one of those still queued.
+                _startWorkers()
+                queue._schedule(op)
+                busyWorkers.wrappingSubtract(1, ordering: .sequentiallyConsistent)
+            }
+            if let index {
+                _OperationWorkStealingScheduler._currentDeque.clear()
+                // NSThreadSpecific doesn't release the stored value on clear; balance the retain from `set`.
+                Unmanaged.passUnretained(deques[index]).release()
+                claimedDeques.withLock { $0[index] = false }
+            }
+
+            // Retire, unless work was pushed after the deques were found empty and no other worker will pick it up.
+            let active = activeWorkers.wrappingSubtract(1, ordering: .sequentiallyConsistent).newValue
+            guard _needsWorker(active: active) else {
+                return
+            }
+            guard activeWorkers.compareExchange(expected: active, desired: active + 1, ordering: .acquiringAndReleasing).exchanged else {
+                return
+            }
+        }
+    }
+}
+
 extension OperationQueue {
     public static let defaultMaxConcurrentOperationCount: Int = -1
+
+    /// How an operation queue runs the operations that are ready to execute.
+    public enum SchedulingMode : Sendable {
+        /// Each operation is submitted to the underlying dispatch queue as its own work item. This is the default.
+        case dispatch
+        /// Ready operations are placed on per-worker deques, at most as many as the active processors and the queue's
+        /// `maxConcurrentOperationCount`, and run by workers that steal from each other when they run out of work. Like
+        /// in `.dispatch` mode, up to `maxConcurrentOperationCount` operations run at once, even when some of them wait
+        /// for others of the queue. The dependents an operation makes ready are run by the worker that finished it. This avoids a dispatch
+        /// work item per operation and suits large numbers of small operations. Operations run at the quality of service
+        /// of the queue; their own quality of service only affects their priority.
+        case workStealing
+    }
 }
 
 @available(macOS 10.5, *)
@@ -767,18 +970,21 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
     var __lastPriorityOperation: (barrier: Unmanaged<Operation>?, veryHigh: Unmanaged<Operation>?, high: Unmanaged<Operation>?, normal: Unmanaged<Operation>?, low: Unmanaged<Operation>?, veryLow: Unmanaged<Operation>?)
     var _barriers = [_BarrierOperation]()
     var _progress: _OperationQueueProgress?
-    var __operationCount: Int = 0
-    var __maxNumOps: Int = OperationQueue.defaultMaxConcurrentOperationCount
+    let __operationCount = Atomic<Int>(0)
+    let __maxNumOps = Atomic<Int>(OperationQueue.defaultMaxConcurrentOperationCount)
     var __actualMaxNumOps: Int32 = .max
-    var __numExecOps: Int32 = 0
+    let __numExecOps = Atomic<Int32>(0)
     var __dispatch_queue: DispatchQueue?
     var __backingQueue: DispatchQueue?
     var __name: String?
-    var __suspended: Bool = false
+    let __suspended = Atomic<Bool>(false)
     var __overcommit: Bool = false
     var __propertyQoS: QualityOfService?
     var __mainQ: Bool = false
     var __progressReporting: Bool = false
+    var __schedulingMode: SchedulingMode = .dispatch
+    var __workStealingScheduler: _OperationWorkStealingScheduler?
+    var __barrierExecuting: Bool = false // Guarded by __queueLock; only maintained in work-stealing mode
     
     internal func _lock() {
         __queueLock.lock()
@@ -789,35 +995,30 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
     }
     
     internal var _suspended: Bool {
-        __atomicLoad.lock()
-        defer { __atomicLoad.unlock() }
-        return __suspended
+        return __suspended.load(ordering: .acquiring)
     }
     
     internal func _incrementExecutingOperations() {
-        __atomicLoad.lock()
-        defer { __atomicLoad.unlock() }
-        __numExecOps += 1
+        __numExecOps.wrappingAdd(1, ordering: .acquiringAndReleasing)
     }
     
     internal func _decrementExecutingOperations() {
-        __atomicLoad.lock()
-        defer { __atomicLoad.unlock() }
-        if __numExecOps > 0 {
-           __numExecOps -= 1
+        var current = __numExecOps.load(ordering: .relaxed)
+        while current > 0 {
+            let (exchanged, original) = __numExecOps.compareExchange(expected: current, desired: current - 1, ordering: .acquiringAndReleasing)
+            if exchanged {
+                break
+            }
+            current = original
         }
     }
     
     internal func _incrementOperationCount(by amount: Int = 1) {
-        __atomicLoad.lock()
-        defer { __atomicLoad.unlock() }
-        __operationCount += amount
+        __operationCount.wrappingAdd(amount, ordering: .relaxed)
     }
     
     internal func _decrementOperationCount(by amount: Int = 1) {
-        __atomicLoad.lock()
-        defer { __atomicLoad.unlock() }
-        __operationCount -= amount
+        __operationCount.wrappingSubtract(amount, ordering: .relaxed)
     }
     
     internal func _firstPriorityOperation(_ prio: Operation.QueuePriority.RawValue?) -> Unmanaged<Operation>? {
@@ -902,6 +1103,9 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
             op.__previousOperation = nil
             op.__nextOperation = nil
             op._invalidateQueue()
+            if isBarrier {
+                __barrierExecuting = false
+            }
         }
         if !isBarrier {
             _decrementOperationCount()
@@ -969,18 +1173,59 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
         }
     }
     
-    internal func _schedule() {
+    // The priority list an operation is queued on when it has no explicit queue priority. Called with the queue lock held.
+    internal func _priority(for op: Operation) -> Operation.QueuePriority.RawValue {
+        if let pri = op.__priorityValue {
+            return pri
+        }
+        if let qos = __actualMaxNumOps == 1 ? nil : op.__propertyQoS {
+            switch qos {
+            case .default: return Operation.QueuePriority.normal.rawValue
+            case .userInteractive: return Operation.QueuePriority.veryHigh.rawValue
+            case .userInitiated: return Operation.QueuePriority.high.rawValue
+            case .utility: return Operation.QueuePriority.low.rawValue
+            case .background: return Operation.QueuePriority.veryLow.rawValue
+            }
+        }
+        return Operation.QueuePriority.normal.rawValue
+    }
+    
+    // Called with the queue lock held.
+    internal func _appendToPriorityList(_ op: Operation) {
+        let pri = _priority(for: op)
+        let unmanaged = Unmanaged.passUnretained(op)
+        op.__nextPriorityOperation = nil
+        if let old_last = _lastPriorityOperation(pri)?.takeUnretainedValue() {
+            old_last.__nextPriorityOperation = unmanaged
+        } else {
+            _setFirstPriorityOperation(pri, unmanaged)
+        }
+        _setlastPriorityOperation(pri, unmanaged)
+    }
+    
+    /// Dispatches as many ready operations as the concurrency limit allows.
+    ///
+    /// Operations that wait for dependencies are kept off the priority lists ("parked") so that this never walks
+    /// them; `unparking` returns operations whose dependencies have finished to the end of their list first.
+    internal func _schedule(unparking: [Operation] = []) {
         var retestOps = [Operation]()
+        var releasedOps = [Operation]()
         _lock()
-        var slotsAvail = __actualMaxNumOps - __numExecOps
+        for op in unparking where op.__parked {
+            op.__parked = false
+            _appendToPriorityList(op)
+        }
+        let scheduler = __workStealingScheduler
+        var slotsAvail = __actualMaxNumOps - __numExecOps.load(ordering: .acquiring)
         for prio in Operation.QueuePriority.priorities {
-            if 0 >= slotsAvail || _suspended {
+            // Without dispatch barriers, a running barrier operation holds back everything added after it.
+            if 0 >= slotsAvail || _suspended || __barrierExecuting {
                 break
             }
             var op = _firstPriorityOperation(prio)
             var prev: Unmanaged<Operation>?
             while let operation = op?.takeUnretainedValue() {
-                if 0 >= slotsAvail || _suspended {
+                if 0 >= slotsAvail || _suspended || __barrierExecuting {
                     break
                 }
                 let next = operation.__nextPriorityOperation
@@ -1001,6 +1246,15 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
                     _incrementExecutingOperations()
                     slotsAvail -= 1
                     
+                    if scheduler != nil {
+                        if operation is _BarrierOperation {
+                            __barrierExecuting = true
+                        }
+                        releasedOps.append(operation)
+                        op = next
+                        continue
+                    }
+                    
                     let queue: DispatchQueue
                     if __mainQ {
                         queue = DispatchQueue.main
@@ -1018,6 +1272,19 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
                         }
                     }
                     
+                    op = next
+                } else if Operation.__NSOperationState.enqueued == operation._state && !(operation is _BarrierOperation) && operation._unfinishedDependencyCount > 0 {
+                    // Barriers stay listed: operations added after a barrier find it there and depend on it.
+                    if let previous = prev?.takeUnretainedValue() {
+                        previous.__nextPriorityOperation = next
+                    } else {
+                        _setFirstPriorityOperation(prio, next)
+                    }
+                    if next == nil {
+                        _setlastPriorityOperation(prio, prev)
+                    }
+                    operation.__nextPriorityOperation = nil
+                    operation.__parked = true
                     op = next
                 } else {
                     if retest {
@@ -1030,6 +1297,10 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
         }
         _unlock()
         
+        if let scheduler = scheduler, !releasedOps.isEmpty {
+            scheduler.submit(releasedOps)
+        }
+        
         for op in retestOps {
             if op.isReady {
                 op._cachedIsReady = true
@@ -1057,27 +1328,19 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
     
     internal var _maxNumOps: Int {
         get {
-            __atomicLoad.lock()
-            defer { __atomicLoad.unlock() }
-            return __maxNumOps
+            return __maxNumOps.load(ordering: .relaxed)
         }
         set(newValue) {
-            __atomicLoad.lock()
-            defer { __atomicLoad.unlock() }
-            __maxNumOps = newValue
+            __maxNumOps.store(newValue, ordering: .relaxed)
         }
     }
     
     internal var _isSuspended: Bool {
         get {
-            __atomicLoad.lock()
-            defer { __atomicLoad.unlock() }
-            return __suspended
+            return __suspended.load(ordering: .acquiring)
         }
         set(newValue) {
-            __atomicLoad.lock()
-            defer { __atomicLoad.unlock() }
-            __suspended = newValue
+            __suspended.store(newValue, ordering: .releasing)
         }
     }
     
@@ -1117,7 +1380,7 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
     internal init(asMainQueue: ()) {
         super.init()
         __mainQ = true
-        __maxNumOps = 1
+        __maxNumOps.store(1, ordering: .relaxed)
         __actualMaxNumOps = 1
         __name = "NSOperationQueue Main Queue"
 #if canImport(Darwin)
@@ -1148,15 +1411,19 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
         var successes = 0
         var firstNewOp: Unmanaged<Operation>?
         var lastNewOp: Unmanaged<Operation>?
+        // Work-stealing workers call _schedule(_:) directly, so they need no work item per operation.
+        let needsWorkItems = __schedulingMode == .dispatch || __mainQ
         for op in ops {
             if op._compareAndSwapState(.initialized, .enqueuing) {
                 successes += 1
                 if 0 == failures {
                     let retained = Unmanaged.passRetained(op)
                     op._cachedIsReady = op.isReady
-                    let schedule: DispatchWorkItem
+                    let schedule: DispatchWorkItem?
                     
-                    if let qos = op.__propertyQoS?.qosClass {
+                    if !needsWorkItems {
+                        schedule = nil
+                    } else if let qos = op.__propertyQoS?.qosClass {
                         schedule = DispatchWorkItem.init(qos: qos, flags: .enforceQoS, block: {
                             self._schedule(op)
                         })
@@ -1223,28 +1490,13 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
             }
             
             _ = pendingOperation._compareAndSwapState(.enqueuing, .enqueued)
-            var pri = pendingOperation.__priorityValue
-            if pri == nil {
-                let v = __actualMaxNumOps == 1 ? nil : pendingOperation.__propertyQoS
-                if let qos = v {
-                    switch qos {
-                    case .default: pri = Operation.QueuePriority.normal.rawValue
-                    case .userInteractive: pri = Operation.QueuePriority.veryHigh.rawValue
-                    case .userInitiated: pri = Operation.QueuePriority.high.rawValue
-                    case .utility: pri = Operation.QueuePriority.low.rawValue
-                    case .background: pri = Operation.QueuePriority.veryLow.rawValue
-                    }
-                } else {
-                    pri = Operation.QueuePriority.normal.rawValue
-                }
-            }
-            pendingOperation.__nextPriorityOperation = nil
-            if let old_last = _lastPriorityOperation(pri)?.takeUnretainedValue() {
-                old_last.__nextPriorityOperation = pending
+            // An operation still waiting for dependencies is parked right away; finishing its last dependency lists it.
+            if !barrier && pendingOperation._unfinishedDependencyCount > 0 {
+                pendingOperation.__nextPriorityOperation = nil
+                pendingOperation.__parked = true
             } else {
-                _setFirstPriorityOperation(pri!, pending)
+                _appendToPriorityList(pendingOperation)
             }
-            _setlastPriorityOperation(pri!, pending)
             pending = pendingOperation.__nextOperation
         }
         
@@ -1271,6 +1523,15 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
         }
     }
     
+    /// Adds a batch of operations, typically a graph whose dependencies were set up beforehand, without waiting for them.
+    ///
+    /// The whole batch is linked into the queue under one acquisition of its lock. Operations that still wait for
+    /// dependencies are set aside instead of being listed for dispatch, and are listed when their last dependency
+    /// finishes, so neither adding nor finishing an operation revisits the rest of the graph.
+    open func addOperations(_ ops: [Operation]) {
+        _addOperations(ops, barrier: false)
+    }
+    
     open func addOperation(_ block: @Sendable @escaping () -> Void) {
         let op = BlockOperation(block: block)
         if let qos = __propertyQoS {
@@ -1282,10 +1543,12 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
     open func addBarrierBlock(_ barrier: @Sendable @escaping () -> Void) {
         var queue: DispatchQueue?
         _lock()
-        if let op = __firstOperation {
+        // Operations in work-stealing mode never reach the backing queue, so a dispatch barrier on it would not hold
+        // them back; the barrier has to be an operation even when the queue is empty.
+        if __firstOperation != nil || __workStealingScheduler != nil {
             let barrierOperation = _BarrierOperation(barrier)
             barrierOperation.__priorityValue = Operation.QueuePriority.barrier
-            var iterOp: Unmanaged<Operation>? = op
+            var iterOp: Unmanaged<Operation>? = __firstOperation
             while let operation = iterOp?.takeUnretainedValue() {
                 barrierOperation.addDependency(operation)
                 iterOp = operation.__nextOperation
@@ -1316,6 +1579,9 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
                 _maxNumOps = newValue
                 let acnt = OperationQueue.defaultMaxConcurrentOperationCount == newValue || Int32.max < newValue ? Int32.max : Int32(newValue)
                 __actualMaxNumOps = acnt
+                if __workStealingScheduler != nil {
+                    _updateWorkStealingScheduler()
+                }
                 _unlock()
                 _schedule()
             }
@@ -1360,6 +1626,9 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
             if !__mainQ {
                 _lock()
                 _propertyQoS = newValue
+                if __workStealingScheduler != nil {
+                    _updateWorkStealingScheduler()
+                }
                 _unlock()
             }
         }
@@ -1380,11 +1649,58 @@ open class OperationQueue : NSObject, ProgressReporting, @unchecked Sendable {
                 if 0 < _operationCount {
                     fatalError("operation queue must be empty in order to change underlying dispatch queue")
                 }
+                _lock()
                 __dispatch_queue = newValue
+                if __workStealingScheduler != nil {
+                    _updateWorkStealingScheduler()
+                }
+                _unlock()
             }
         }
     }
     
+    /// How the queue runs its operations. The main queue always uses `.dispatch`.
+    ///
+    /// Like `underlyingQueue`, this can only be changed while the queue has no operations. In `.workStealing` mode the
+    /// workers run on `underlyingQueue` when one is set.
+    open var schedulingMode: SchedulingMode {
+        get {
+            _lock()
+            defer { _unlock() }
+            return __schedulingMode
+        }
+        set(newValue) {
+            if __mainQ {
+                return
+            }
+            if 0 < _operationCount {
+                fatalError("operation queue must be empty in order to change its scheduling mode")
+            }
+            _lock()
+            __schedulingMode = newValue
+            _updateWorkStealingScheduler()
+            _unlock()
+        }
+    }
+    
+    // Called with the queue lock held whenever the mode or the concurrency limit changes.
+    internal func _updateWorkStealingScheduler() {
+        guard __schedulingMode == .workStealing && !__mainQ else {
+            __workStealingScheduler = nil
+            return
+        }
+        let dequeCount = Int(Swift.min(__actualMaxNumOps, Int32(clamping: ProcessInfo.processInfo.activeProcessorCount)))
+        let target: DispatchQueue
+        if let queue = __dispatch_queue {
+            target = queue
+        } else if let qos = _propertyQoS {
+            target = DispatchQueue.global(qos: qos.qosClass.qosClass)
+        } else {
+            target = DispatchQueue.global()
+        }
+        __workStealingScheduler = _OperationWorkStealingScheduler(queue: self, dequeCount: Swift.max(dequeCount, 1), target: target)
+    }
+    
     open func cancelAllOperations() {
         if !__mainQ {
             for op in _operations(includingBarriers: true) {
@@ -0,0 +1,287 @@
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2024 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+
+#if canImport(Dispatch) && !os(Windows)
+@_implementationOnly import CoreFoundation
+import Dispatch
+
+#if canImport(Darwin)
+import Darwin
+#elseif canImport(Android)
+@preconcurrency import Android
+#endif
+
+extension Process {
+    /// A pipe that collects what a child process writes to its standard output or standard error.
+    ///
+    /// Assign a capture to `standardOutput`, `standardError` or both before calling `run()`. Once the process has been launched, the capture drains the pipe on a private queue until every writer has closed it:
+    ///
+    /// - Output is read straight into one growing buffer instead of into a new `Data` per read. If the output is retained, `capturedData` takes over that buffer without copying it.
+    /// - A `lineHandler` is called once per read with all the complete lines that read produced, as views into the buffer. If the output is not retained, the buffer only keeps the trailing unterminated line, so its size is bounded by the longest line rather than by the length of the output.
+    /// - Output that is only forwarded to a file handle is moved with `splice(2)` on Linux and never copied into this process.
+    ///
+    /// Do not read from `fileHandleForReading` of a capture yourself.
+    public final class OutputCapture : Pipe {
+        /// The complete lines produced by one read, without their `"\n"` terminators.
+        ///
+        /// The buffers are views into the capture's storage and are only valid for the duration of the call to the line handler.
+        public struct Lines : Sequence {
+            fileprivate let bytes: UnsafeRawBufferPointer
+
+            public struct Iterator : IteratorProtocol {
+                fileprivate var remaining: UnsafeRawBufferPointer
+
+                public mutating func next() -> UnsafeRawBufferPointer? {
+                    guard let base = remaining.baseAddress, remaining.count > 0 else {
+                        return nil
+                    }
+                    guard let newline = memchr(base, 0x0A, remaining.count) else {
+                        // Only the last line of the output can be unterminated.
+                        let line = remaining
+                        remaining = UnsafeRawBufferPointer(start: nil, count: 0)
+                        return line
+                    }
+                    let length = UnsafeRawPointer(newline) - base
+                    remaining = UnsafeRawBufferPointer(rebasing: remaining[(length + 1)...])
+                    return UnsafeRawBufferPointer(start: base, count: length)
+                }
+            }
+
+            public func makeIterator() -> Iterator {
+                return Iterator(remaining: bytes)
+            }
+        }
+
+        private static let _minimumReadSize = 64 * 1024
+        private static let _spliceSize = 1024 * 1024
+
+        private let retainsOutput: Bool
+        private let destination: FileHandle?
+        private let lineHandler: (@Sendable (Lines) -> Void)?
+        private let queue = DispatchQueue(label: "org.swift.Foundation.Process.OutputCapture")
+        private let finished = DispatchGroup()
+
+        private let stateLock = NSLock()
+        private var started = false // Guarded by stateLock
+        private var _capturedData = Data() // Guarded by stateLock
+        private var _error: Error? // Guarded by stateLock
+        private var _byteCount = 0 // Guarded by stateLock
+
+        // Only accessed on `queue` once the capture has started.
+        private var storage: UnsafeMutableRawPointer?
+        private var capacity = 0
+        private var count = 0
+        private var lineStart = 0
+        private var splices: Bool
+
+        /// Creates a capture.
+        ///
+        /// - Parameters:
+        ///   - retainingOutput: Whether to keep everything the child writes, for `capturedData`.
+        ///   - destination: A file handle to which all output is also written, such as a log file.
+        ///   - lineHandler: Called on a private serial queue with the complete lines from each read, and with the final unterminated line, if any, at the end of the output.
+        public init(retainingOutput: Bool = true, forwardingTo destination: FileHandle? = nil, lineHandler: (@Sendable (Lines) -> Void)? = nil) {
+            self.retainsOutput = retainingOutput
+            self.destination = destination
+            self.lineHandler = lineHandler
+#if os(Linux)
+            self.splices = destination != nil && !retainingOutput && lineHandler == nil
+#else
+            self.splices = false
+#endif
+            super.init()
+        }
+
+        deinit {
+            free(storage)
+        }
+
+        /// Waits until all output has been drained, and throws the error that stopped forwarding it to the destination, if any.
+        ///
+        /// Returns immediately if the process this capture is attached to has not been launched.
+        public func waitUntilFinished() throws {
+            finished.wait()
+            stateLock.lock()
+            let error = _error
+            stateLock.unlock()
+            if let error {
+                throw error
+            }
+        }
+
+        /// Everything the child wrote, available once all output has been drained; reading it waits until then. Empty if output is not retained.
+        public var capturedData: Data {
+            finished.wait()
+            stateLock.lock()
+            defer { stateLock.unlock() }
+            return _capturedData
+        }
+
+        /// The number of bytes drained from the pipe so far, including those that were only forwarded.
+        public var byteCount: Int {
+            stateLock.lock()
+            defer { stateLock.unlock() }
+            return _byteCount
+        }
+
+        /// Starts draining the pipe. Called by `Process.run()` once the parent's copy of the write end has been closed.
+        internal func _start() {
+            stateLock.lock()
+            guard !started else {
+                stateLock.unlock()
+                return
+            }
+            started = true
+            finished.enter()
+            stateLock.unlock()
+
+            let fd = fileHandleForReading.fileDescriptor
+            guard fd >= 0 else {
+                queue.async { self._finish() }
+                return
+            }
+            let source = DispatchSource.makeReadSource(fileDescriptor: fd, queue: queue)
+            source.setEventHandler { [unowned source] in
+                if !self._drain(estimatedCount: Int(source.data)) {
+                    source.cancel()
+                }
+            }
+            // The handlers keep the capture alive until the pipe has been drained; cancelling the source releases them.
+            source.setCancelHandler {
+                self._finish()
+            }
+            source.resume()
+        }
+
+        /// Moves the available output out of the pipe. Returns `false` at the end of the output or after an error.
+        private func _drain(estimatedCount: Int) -> Bool {
+            let fd = fileHandleForReading.fileDescriptor
+#if os(Linux)
+            if splices, let destination {
+                let moved = _CF_splice_from_pipe(fd, destination.fileDescriptor, Swift.max(estimatedCount, OutputCapture._spliceSize))
+                if moved > 0 {
+                    _record(moved)
+                    return true
+                } else if moved == 0 {
+                    return false
+                }
+                switch errno {
+                case EINTR, EAGAIN:
+                    return true
+                case EINVAL, ENOSYS:
+                    // The destination cannot be spliced to (older kernels refuse files opened for appending, for
+                    // instance), so copy through the buffer from now on.
+                    splices = false
+                default:
+                    _fail(_NSErrorWithErrno(errno, reading: false))
+                    return false
+                }
+            }
+#endif
+            _reserve(Swift.max(estimatedCount, OutputCapture._minimumReadSize))
+            let buffer = storage! + count
+            let length = read(fd, buffer, capacity - count)
+            if length == 0 {
+                return false
+            } else if length < 0 {
+                if errno == EINTR || errno == EAGAIN {
+                    return true
+                }
+                _fail(_NSErrorWithErrno(errno, reading: true))
+                return false
+            }
+
+            if let destination {
+                var written = 0
+                while written < length {
+                    let result = write(destination.fileDescriptor, buffer + written, length - written)
+                    if result < 0 {
+                        if errno == EINTR {
+                            continue
+                        }
+                        _fail(_NSErrorWithErrno(errno, reading: false))
+                        return false
+                    }
+                    written += result
+                }
+            }
+            count += length
+            _record(length)
+
+            if let lineHandler {
+                // Deliver everything up to the last newline in one call; the rest waits for the next read.
+                let bytes = UnsafeRawBufferPointer(start: buffer, count: length)
+                if let lastNewline = bytes.lastIndex(of: 0x0A) {
+                    let end = count - length + lastNewline + 1
+                    lineHandler(Lines(bytes: UnsafeRawBufferPointer(start: storage! + lineStart, count: end - lineStart)))
+                    lineStart = end
+                }
+            }
+            if !retainsOutput {
+                // Only the unterminated line needs to be kept, at the front of the buffer.
+                let pending = lineHandler == nil ? 0 : count - lineStart
+                if pending > 0 && lineStart > 0 {
+                    memmove(storage!, storage! + lineStart, pending)
+                }
+                count = pending
+                lineStart = 0
+            }
+            return true
+        }
+
+        private func _reserve(_ minimumFree: Int) {
+            guard capacity - count < minimumFree else {
+                return
+            }
+            let newCapacity = Swift.max(capacity * 2, count + minimumFree)
+            guard let grown = realloc(storage, newCapacity) else {
+                fatalError("Unable to allocate \(newCapacity) bytes for process output")
+            }
+            storage = grown
+            capacity = newCapacity
+        }
+
+        private func _record(_ length: Int) {
+            stateLock.lock()
+            _byteCount += length
+            stateLock.unlock()
+        }
+
+        private func _fail(_ error: Error) {
+            stateLock.lock()
+            if _error == nil {
+                _error = error
+            }
+            stateLock.unlock()
+        }
+
+        private func _finish() {
+            if let lineHandler, let storage, lineStart < count {
+                lineHandler(Lines(bytes: UnsafeRawBufferPointer(start: storage + lineStart, count: count - lineStart)))
+                lineStart = count
+            }
+            var data = Data()
+            if retainsOutput, let storage, count > 0 {
+                data = Data(bytesNoCopy: storage, count: count, deallocator: .free)
+                self.storage = nil
+            }
+            free(storage)
+            storage = nil
+            capacity = 0
+            count = 0
+            lineStart = 0
+
+            stateLock.lock()
+            _capturedData = data
+            stateLock.unlock()
+            finished.leave()
+        }
+    }
+}
+#endif
@@ -112,6 +112,76 @@ func findMaximumOpenFD() -> CInt {
 }
 #endif
 
+#if !os(Windows)
+/// An explicit `Process.environment` encoded into the `NULL`-terminated `"KEY=value"` array that
+/// `posix_spawn` takes. All the strings live in one allocation, and processes launched with an equal
+/// environment (typically many processes configured from the same template) share one block instead of
+/// re-encoding the dictionary on every launch.
+private final class _SpawnEnvironment: @unchecked Sendable {
+    let environment: [String: String]
+    let envp: UnsafeMutablePointer<UnsafeMutablePointer<CChar>?>
+    private let storage: UnsafeMutablePointer<CChar>
+
+    private init(_ environment: [String: String]) {
+        self.environment = environment
+        var length = 0
+        for (key, value) in environment {
+            length += key.utf8.count + value.utf8.count + 2
+        }
+        storage = .allocate(capacity: Swift.max(length, 1))
+        envp = .allocate(capacity: environment.count + 1)
+
+        var cursor = storage
+        func append(_ bytes: String.UTF8View) {
+            for byte in bytes {
+                cursor.pointee = CChar(bitPattern: byte)
+                cursor += 1
+            }
+        }
+        for (index, (key, value)) in environment.enumerated() {
+            envp[index] = cursor
+            append(key.utf8)
+            cursor.pointee = 0x3D // '='
+            cursor += 1
+            append(value.utf8)
+            cursor.pointee = 0
+            cursor += 1
+        }
+        envp[environment.count] = nil
+    }
+
+    deinit {
+        envp.deallocate()
+        storage.deallocate()
+    }
+
+    // Most recently used last. Comparing against a handful of dictionaries is far cheaper than the
+    // per-variable string formatting and allocations it replaces.
+    private static let cache = Mutex<[_SpawnEnvironment]>([])
+    private static let cacheLimit = 8
+
+    static func encoding(_ environment: [String: String]) -> _SpawnEnvironment {
+        return cache.withLock { blocks in
+            if let index = blocks.firstIndex(where: { $0.environment == environment }) {
+                let block = blocks.remove(at: index)
+                blocks.append(block)
+                return block
+            }
+            let block = _SpawnEnvironment(environment)
+            if blocks.count == cacheLimit {
+                blocks.removeFirst()
+            }
+            blocks.append(block)
+            return block
+        }
+    }
+}
+
+/// A descriptor on /dev/null shared by every launch that redirects a standard stream to the null device.
+/// It is close-on-exec, so children only ever see the copies duplicated onto their standard streams.
+private let _sharedNullDeviceDescriptor: Int32 = open("/dev/null", O_RDWR | O_CLOEXEC)
+#endif
+
 
 private func emptyRunLoopCallback(_ context : UnsafeMutableRawPointer?) -> Void {}
 
@@ -372,6 +442,12 @@ open class Process: NSObject, @unchecked Sendable {
     fileprivate weak var runLoop : RunLoop? = nil
     
     private var processLaunchedCondition = NSCondition()
+
+#if !os(Windows) && !canImport(Darwin)
+    // Set by tests to close the descriptors a child must not inherit one at a time, as where the C library can't
+    // close a range of them in the child.
+    internal static nonisolated(unsafe) var _closesInheritedDescriptorsIndividually = false
+#endif
     
     // Actions
     
@@ -766,24 +842,11 @@ open class Process: NSObject, @unchecked Sendable {
             argv.deallocate()
         }
 
-        var env: [String: String]
-        if let e = environment {
-            env = e
-        } else {
-            env = ProcessInfo.processInfo.environment
-        }
-
-        let nenv = env.count
-        let envp = UnsafeMutablePointer<UnsafeMutablePointer<Int8>?>.allocate(capacity: 1 + nenv)
-        envp.initialize(from: env.map { strdup("\($0)=\($1)") }, count: nenv)
-        envp[env.count] = nil
-
-        defer {
-            for pair in envp ..< envp + env.count {
-                free(UnsafeMutableRawPointer(pair.pointee))
-            }
-            envp.deallocate()
-        }
+        // Without an explicit environment the child inherits ours as-is, so hand posix_spawn the live
+        // environment rather than round-tripping it through a dictionary.
+        let spawnEnvironment = environment.map(_SpawnEnvironment.encoding)
+        let envp = spawnEnvironment?.envp ?? _CFEnviron()
+        defer { withExtendedLifetime(spawnEnvironment) {} }
 
         var taskSocketPair : [Int32] = [0, 0]
 #if os(macOS) || os(iOS) || os(Android) || os(OpenBSD) || os(FreeBSD) || canImport(Musl)
@@ -865,6 +928,9 @@ open class Process: NSObject, @unchecked Sendable {
 
         var _devNull: FileHandle?
         func devNullFd() throws -> Int32 {
+            if _sharedNullDeviceDescriptor >= 0 {
+                return _sharedNullDeviceDescriptor
+            }
             _devNull = try _devNull ?? FileHandle(forUpdating: URL(fileURLWithPath: "/dev/null", isDirectory: false))
             return _devNull!.fileDescriptor
         }
@@ -966,14 +1032,34 @@ open class Process: NSObject, @unchecked Sendable {
 #if canImport(Darwin)
         flags |= Int16(POSIX_SPAWN_CLOEXEC_DEFAULT)
 #else
-        // POSIX_SPAWN_CLOEXEC_DEFAULT is an Apple extension so emulate it.
-        for fd in 3 ... findMaximumOpenFD() {
-            guard adddup2[fd] == nil &&
-                  !addclose.contains(fd) &&
-                  fd != taskSocketPair[1] else {
-                    continue // Do not double-close descriptors, or close those pertaining to Pipes or FileHandles we want inherited.
+        // POSIX_SPAWN_CLOEXEC_DEFAULT is an Apple extension so emulate it. Where the C library can close
+        // a whole range in the child (close_range(2) on Linux), move the one descriptor the child keeps
+        // beyond its standard streams, the end of the socket pair, to the bottom of that range and close
+        // everything above it. That avoids listing /proc/self/fd and queuing one action per descriptor.
+        // Otherwise each descriptor is closed on its own, apart from the socket's copy at the bottom of
+        // the range.
+        var closesInheritedDescriptors = false
+        var inheritedSocket = taskSocketPair[1]
+        if taskSocketPair[1] > STDERR_FILENO {
+            inheritedSocket = STDERR_FILENO + 1
+            try _throwIfPosixError(_CFPosixSpawnFileActionsAddDup2(fileActions, taskSocketPair[1], inheritedSocket))
+            if !Process._closesInheritedDescriptorsIndividually {
+                let closeFromResult = _CFPosixSpawnFileActionsAddCloseFrom(fileActions, inheritedSocket + 1)
+                if closeFromResult != ENOSYS {
+                    try _throwIfPosixError(closeFromResult)
+                    closesInheritedDescriptors = true
+                }
+            }
+        }
+        if !closesInheritedDescriptors {
+            for fd in 3 ... findMaximumOpenFD() {
+                guard adddup2[fd] == nil &&
+                      !addclose.contains(fd) &&
+                      fd != inheritedSocket else {
+                        continue // Do not double-close descriptors, or close those pertaining to Pipes or FileHandles we want inherited.
+                }
+                try _throwIfPosixError(_CFPosixSpawnFileActionsAddClose(fileActions, fd))
             }
-            try _throwIfPosixError(_CFPosixSpawnFileActionsAddClose(fileActions, fd))
         }
 #endif
 
@@ -1030,6 +1116,8 @@ open class Process: NSObject, @unchecked Sendable {
         if let pipe = standardError as? Pipe {
             pipe.fileHandleForWriting.closeFile()
         }
+        (standardOutput as? OutputCapture)?._start()
+        (standardError as? OutputCapture)?._start()
 
         close(taskSocketPair[1])
 
@@ -0,0 +1,560 @@
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2024 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+
+@available(*, unavailable)
+extension Scanner.UTF8Stream : Sendable { }
+
+extension Scanner {
+    /// A scanner over UTF-8 text that is read a chunk at a time, from an input stream or from data such as a memory-mapped file.
+    ///
+    /// `Scanner` needs the whole text as a string and copies out every result. A stream scanner instead works on the bytes:
+    ///
+    /// - Only the unscanned part of the current chunk is kept, so memory use is bounded by the chunk size and the longest result rather than by the length of the input. Data is scanned in place and never copied.
+    /// - Results are `Token`s, views into the scanner's buffer that are only copied into a `String` on request.
+    /// - Numbers are parsed straight from the bytes.
+    ///
+    /// Scanning methods skip `charactersToBeSkipped` first, like those of `Scanner`, and return `nil` without moving the scan position when nothing matches. Unlike `Scanner`, string matching is always case-sensitive, and the decimal separator is always `"."`. Invalid UTF-8 is treated as U+FFFD, one byte at a time.
+    public final class UTF8Stream {
+        /// A run of scanned bytes.
+        ///
+        /// A token from a stream scanner is a view into the scanner's buffer, and is valid until the scanner next reads from its stream, which can happen in any call that scans; use `string` to keep it. A token from data stays valid as long as the scanner.
+        public struct Token : CustomStringConvertible {
+            fileprivate let scanner: UTF8Stream
+            fileprivate let offset: Int
+            fileprivate let generation: Int
+
+            /// The number of bytes in the token.
+            public let count: Int
+
+            /// Calls `body` with the UTF-8 bytes of the token.
+            public func withUnsafeBytes<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+                precondition(generation == scanner.generation, "Token used after the scanner read more input")
+                return try scanner._withBuffer { buffer in
+                    try body(UnsafeRawBufferPointer(rebasing: buffer[offset ..< offset + count]))
+                }
+            }
+
+            /// A copy of the token as a string.
+            public var string: String {
+                return withUnsafeBytes { String(decoding: $0, as: UTF8.self) }
+            }
+
+            public var description: String {
+                return string
+            }
+
+            public static func == (lhs: Token, rhs: String) -> Bool {
+                var rhs = rhs
+                return rhs.withUTF8 { other in
+                    lhs.withUnsafeBytes { bytes in
+                        bytes.count == other.count && (bytes.count == 0 || memcmp(bytes.baseAddress!, other.baseAddress!, bytes.count) == 0)
+                    }
+                }
+            }
+        }
+
+        /// Which ASCII characters are in a character set, so that most bytes are tested without going through the set.
+        private struct _ASCIITable {
+            private var low: UInt64 = 0
+            private var high: UInt64 = 0
+
+            init(_ set: CharacterSet) {
+                for value in 0 ..< 128 where set.contains(Unicode.Scalar(UInt8(value))) {
+                    if value < 64 {
+                        low |= 1 << UInt64(value)
+                    } else {
+                        high |= 1 << UInt64(value - 64)
+                    }
+                }
+            }
+
+            func contains(_ byte: UInt8) -> Bool {
+                return byte < 64 ? (low >> UInt64(byte)) & 1 != 0 : (high >> UInt64(byte - 64)) & 1 != 0
+            }
+        }
+
+        private static let _defaultChunkSize = 64 * 1024
+
+        private let stream: InputStream?
+        private let data: Data?
+        private let chunkSize: Int
+
+        // For a stream, `storage` holds bytes `discarded ..< discarded + end` of the input; for data, the buffer is the data itself.
+        private var storage: UnsafeMutableRawPointer?
+        private var capacity = 0
+        private var end = 0
+        private var position = 0
+        private var discarded = 0
+        private var reachedEnd = false
+        // Changes whenever the bytes in the buffer move, which invalidates the tokens handed out so far.
+        fileprivate var generation = 0
+
+        private var skipTable: _ASCIITable
+        private var lastSet: CharacterSet?
+        private var lastTable = _ASCIITable(CharacterSet())
+
+        /// The characters skipped before each scan; whitespace and newlines by default.
+        public var charactersToBeSkipped: CharacterSet? = Scanner.defaultSkipSet {
+            didSet {
+                skipTable = _ASCIITable(charactersToBeSkipped ?? CharacterSet())
+            }
+        }
+
+        /// Creates a scanner that reads from `stream`, opening it if necessary, `chunkSize` bytes at a time.
+        public init(stream: InputStream, chunkSize: Int = 64 * 1024) {
+            precondition(chunkSize > 0, "The chunk size must be positive")
+            self.stream = stream
+            self.data = nil
+            self.chunkSize = chunkSize
+            self.skipTable = _ASCIITable(Scanner.defaultSkipSet)
+            if stream.streamStatus == .notOpen {
+                stream.open()
+            }
+        }
+
+        /// Creates a scanner over `data`, which is scanned in place.
+        public init(data: Data) {
+            self.stream = nil
+            self.data = data
+            self.chunkSize = UTF8Stream._defaultChunkSize
+            self.skipTable = _ASCIITable(Scanner.defaultSkipSet)
+            self.end = data.count
+            self.reachedEnd = true
+        }
+
+        deinit {
+            free(storage)
+        }
+
+        /// The number of bytes of the input before the scan position.
+        public var byteOffset: Int {
+            return discarded + position
+        }
+
+        /// The error that stopped reading from the stream, if any.
+        public var streamError: Error? {
+            return stream?.streamError
+        }
+
+        /// Whether only characters to be skipped remain.
+        public var isAtEnd: Bool {
+            _skip()
+            return !_ensure(1)
+        }
+
+        /// Scans `string` exactly.
+        public func scanString(_ string: String) -> Token? {
+            _skip()
+            var string = string
+            return string.withUTF8 { needle in
+                guard needle.count > 0, _ensure(needle.count) else {
+                    return nil
+                }
+                let matches = _withBuffer { buffer in
+                    memcmp(buffer.baseAddress! + position, needle.baseAddress!, needle.count) == 0
+                }
+                return matches ? _take(needle.count) : nil
+            }
+        }
+
+        /// Scans the characters that are in `set`.
+        public func scanCharacters(from set: CharacterSet) -> Token? {
+            _skip()
+            return _take(_run(of: set, table: _table(for: set), members: true))
+        }
+
+        /// Scans up to the first character in `set`, or to the end of the input.
+        public func scanUpToCharacters(from set: CharacterSet) -> Token? {
+            _skip()
+            return _take(_run(of: set, table: _table(for: set), members: false))
+        }
+
+        /// Scans up to the next occurrence of `string`, or to the end of the input.
+        public func scanUpToString(_ string: String) -> Token? {
+            _skip()
+            var string = string
+            let length = string.withUTF8 { needle -> Int in
+                guard needle.count > 0 else {
+                    return 0
+                }
+                // No match can start before `searched` bytes past the scan position.
+                var searched = 0
+                while true {
+                    let found = _withBuffer { buffer -> Int? in
+                        let available = end - position
+                        guard available - searched >= needle.count, let base = buffer.baseAddress else {
+                            return nil
+                        }
+                        let start = base + position
+                        var from = searched
+                        while available - from >= needle.count {
+                            guard let hit = memchr(start + from, Int32(needle[0]), available - from - needle.count + 1) else {
+                                break
+                            }
+                            let offset = UnsafeRawPointer(hit) - start
+                            if memcmp(hit, needle.baseAddress!, needle.count) == 0 {
+                                return offset
+                            }
+                            from = offset + 1
+                        }
+                        searched = available - needle.count + 1
+                        return nil
+                    }
+                    if let found {
+                        return found
+                    }
+                    if !_readMore() {
+                        return end - position
+                    }
+                }
+            }
+            return _take(length)
+        }
+
+        /// Scans a decimal integer, clamping it to the range of `Int64` on overflow.
+        public func scanInt64() -> Int64? {
+            guard let (negative, magnitude, overflow) = _scanDecimalInteger(allowingMinus: true) else {
+                return nil
+            }
+            if negative {
+                return (overflow || magnitude > UInt64(Int64.max) + 1) ? Int64.min : Int64(bitPattern: 0 &- magnitude)
+            }
+            return (overflow || magnitude > UInt64(Int64.max)) ? Int64.max : Int64(magnitude)
+        }
+
+        /// Scans a decimal integer, clamping it to the range of `Int` on overflow.
+        public func scanInt() -> Int? {
+            guard let value = scanInt64() else {
+                return nil
+            }
+            return Int(clamping: value)
+        }
+
+        /// Scans an unsigned decimal integer, clamping it to `UInt64.max` on overflow.
+        public func scanUInt64() -> UInt64? {
+            guard let (_, magnitude, overflow) = _scanDecimalInteger(allowingMinus: false) else {
+                return nil
+            }
+            return overflow ? UInt64.max : magnitude
+        }
+
+        /// Scans a decimal floating-point number, with an optional sign, fraction and exponent.
+        public func scanDouble() -> Double? {
+            _skip()
+            var length = 0
+            var digits = 0
+            if let sign = _byte(at: 0), sign == UInt8(ascii: "-") || sign == UInt8(ascii: "+") {
+                length = 1
+            }
+            while let byte = _byte(at: length), _isDigit(byte) {
+                length += 1
+                digits += 1
+            }
+            if _byte(at: length) == UInt8(ascii: ".") {
+                length += 1
+                while let byte = _byte(at: length), _isDigit(byte) {
+                    length += 1
+                    digits += 1
+                }
+            }
+            guard digits > 0 else {
+                return nil
+            }
+            if let byte = _byte(at: length), byte == UInt8(ascii: "e") || byte == UInt8(ascii: "E") {
+                // Like Scanner, an exponent marker without digits makes the whole number invalid.
+                var exponentLength = 1
+                if let sign = _byte(at: length + 1), sign == UInt8(ascii: "-") || sign == UInt8(ascii: "+") {
+                    exponentLength = 2
+                }
+                var exponentDigits = 0
+                while let byte = _byte(at: length + exponentLength), _isDigit(byte) {
+                    exponentLength += 1
+                    exponentDigits += 1
+                }
+                guard exponentDigits > 0 else {
+                    return nil
+                }
+                length += exponentLength
+            }
+
+            let value = _withBuffer { buffer in
+                _parseDouble(UnsafeRawBufferPointer(rebasing: buffer[position ..< position + length]))
+            }
+            guard let value else {
+                return nil
+            }
+            position += length
+            return value
+        }
+
+        // MARK: - Buffer
+
+        fileprivate func _withBuffer<R>(_ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+            if let data {
+                return try data.withUnsafeBytes(body)
+            }
+            return try body(UnsafeRawBufferPointer(start: storage, count: end))
+        }
+
+        /// Reads the next chunk of the stream, after dropping the scanned bytes from the buffer. Returns `false` at the end of the input.
+        private func _readMore() -> Bool {
+            guard let stream, !reachedEnd else {
+                return false
+            }
+            if position > 0 {
+                let remaining = end - position
+                if remaining > 0 {
+                    memmove(storage!, storage! + position, remaining)
+                }
+                discarded += position
+                end = remaining
+                position = 0
+                generation &+= 1
+            }
+            if capacity - end < chunkSize {
+                // Only a result longer than a chunk makes the buffer grow past two chunks.
+                let newCapacity = Swift.max(capacity * 2, end + chunkSize)
+                guard let grown = realloc(storage, newCapacity) else {
+                    fatalError("Unable to allocate \(newCapacity) bytes for scanning")
+                }
+                storage = grown
+                capacity = newCapacity
+            }
+            while true {
+                let count = stream.read(storage!.assumingMemoryBound(to: UInt8.self) + end, maxLength: capacity - end)
+                if count > 0 {
+                    end += count
+                    return true
+                } else if count == 0 && stream.hasBytesAvailable && stream.streamStatus == .open {
+                    // Nothing yet from a stream that has not ended; try again.
+                    continue
+                }
+                reachedEnd = true
+                return false
+            }
+        }
+
+        /// Makes sure that at least `count` bytes past the scan position are in the buffer, unless the input ends first.
+        private func _ensure(_ count: Int) -> Bool {
+            while end - position < count {
+                if !_readMore() {
+                    return false
+                }
+            }
+            return true
+        }
+
+        private func _byte(at offset: Int) -> UInt8? {
+            guard _ensure(offset + 1) else {
+                return nil
+            }
+            return _withBuffer { $0[position + offset] }
+        }
+
+        private func _take(_ length: Int) -> Token? {
+            guard length > 0 else {
+                return nil
+            }
+            let token = Token(scanner: self, offset: position, generation: generation, count: length)
+            position += length
+            return token
+        }
+
+        // MARK: - Characters
+
+        private func _skip() {
+            guard let set = charactersToBeSkipped else {
+                return
+            }
+            position += _run(of: set, table: skipTable, members: true)
+        }
+
+        private func _table(for set: CharacterSet) -> _ASCIITable {
+            if set != lastSet {
+                lastTable = _ASCIITable(set)
+                lastSet = set
+            }
+            return lastTable
+        }
+
+        /// Returns the length in bytes of the run of characters at the scan position that are in `set`, or, if `members` is `false`, that are not.
+        private func _run(of set: CharacterSet, table: _ASCIITable, members: Bool) -> Int {
+            var length = 0
+            while true {
+                let needsMore = _withBuffer { buffer -> Bool in
+                    var index = position + length
+                    defer { length = index - position }
+                    while index < end {
+                        let byte = buffer[index]
+                        if byte < 0x80 {
+                            if table.contains(byte) != members {
+                                return false
+                            }
+                            index += 1
+                        } else {
+                            guard let (scalar, width) = _decodeScalar(buffer, at: index) else {
+                                return true
+                            }
+                            if set.contains(scalar) != members {
+                                return false
+                            }
+                            index += width
+                        }
+                    }
+                    return true
+                }
+                // If the input ends in the middle of a sequence, go around once more to take its bytes as invalid ones.
+                if !needsMore || (!_readMore() && position + length == end) {
+                    break
+                }
+            }
+            return length
+        }
+
+        /// Decodes the scalar starting with a non-ASCII byte. Returns `nil` if the sequence continues past the bytes read so far.
+        private func _decodeScalar(_ buffer: UnsafeRawBufferPointer, at index: Int) -> (Unicode.Scalar, Int)? {
+            let lead = buffer[index]
+            let width: Int
+            let minimum: UInt32
+            var value: UInt32
+            switch lead {
+            case 0xC2 ... 0xDF:
+                width = 2
+                minimum = 0x80
+                value = UInt32(lead & 0x1F)
+            case 0xE0 ... 0xEF:
+                width = 3
+                minimum = 0x800
+                value = UInt32(lead & 0x0F)
+            case 0xF0 ... 0xF4:
+                width = 4
+                minimum = 0x10000
+                value = UInt32(lead & 0x07)
+            default:
+                return ("\u{FFFD}", 1)
+            }
+            if index + width > end {
+                return reachedEnd ? ("\u{FFFD}", 1) : nil
+            }
+            for offset in 1 ..< width {
+                let byte = buffer[index + offset]
+                guard byte & 0xC0 == 0x80 else {
+                    return ("\u{FFFD}", 1)
+                }
+                value = (value << 6) | UInt32(byte & 0x3F)
+            }
+            guard value >= minimum, let scalar = Unicode.Scalar(value) else {
+                return ("\u{FFFD}", 1)
+            }
+            return (scalar, width)
+        }
+
+        // MARK: - Numbers
+
+        private func _isDigit(_ byte: UInt8) -> Bool {
+            return byte &- UInt8(ascii: "0") < 10
+        }
+
+        private func _scanDecimalInteger(allowingMinus: Bool) -> (negative: Bool, magnitude: UInt64, overflow: Bool)? {
+            _skip()
+            var length = 0
+            var negative = false
+            if let sign = _byte(at: 0), (allowingMinus && sign == UInt8(ascii: "-")) || sign == UInt8(ascii: "+") {
+                negative = (sign == UInt8(ascii: "-"))
+                length = 1
+            }
+            let digitsStart = length
+            var magnitude: UInt64 = 0
+            var overflow = false
+            while let byte = _byte(at: length), _isDigit(byte) {
+                let (multiplied, multiplyOverflow) = magnitude.multipliedReportingOverflow(by: 10)
+                let (added, addOverflow) = multiplied.addingReportingOverflow(UInt64(byte - UInt8(ascii: "0")))
+                overflow = overflow || multiplyOverflow || addOverflow
+                magnitude = added
+                length += 1
+            }
+            guard length > digitsStart else {
+                return nil
+            }
+            position += length
+            return (negative, magnitude, overflow)
+        }
+
+        private static let _exactPowersOfTen: [Double] = [1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22]
+
+        /// Converts bytes that have the form of a decimal number. Numbers with at most 15 significant digits and a small exponent are exact as one multiplication or division of doubles; the rest go through the standard library.
+        private func _parseDouble(_ bytes: UnsafeRawBufferPointer) -> Double? {
+            var index = 0
+            var negative = false
+            if bytes[0] == UInt8(ascii: "-") || bytes[0] == UInt8(ascii: "+") {
+                negative = (bytes[0] == UInt8(ascii: "-"))
+                index = 1
+            }
+            var mantissa: UInt64 = 0
+            var significantDigits = 0
+            var exponent = 0
+            var sawPoint = false
+            while index < bytes.count {
+                let byte = bytes[index]
+                if byte == UInt8(ascii: ".") {
+                    sawPoint = true
+                } else if _isDigit(byte) {
+                    if mantissa == 0 && byte == UInt8(ascii: "0") {
+                        // Leading zeros are not significant.
+                        if sawPoint {
+                            exponent -= 1
+                        }
+                    } else {
+                        significantDigits += 1
+                        if significantDigits <= 19 {
+                            mantissa = mantissa * 10 + UInt64(byte - UInt8(ascii: "0"))
+                            if sawPoint {
+                                exponent -= 1
+                            }
+                        } else if !sawPoint {
+                            exponent += 1
+                        }
+                    }
+                } else {
+                    break
+                }
+                index += 1
+            }
+            var exponentValue = 0
+            if index < bytes.count {
+                // An exponent; its digits were checked by the caller.
+                index += 1
+                var exponentNegative = false
+                if bytes[index] == UInt8(ascii: "-") || bytes[index] == UInt8(ascii: "+") {
+                    exponentNegative = (bytes[index] == UInt8(ascii: "-"))
+                    index += 1
+                }
+                while index < bytes.count {
+                    exponentValue = Swift.min(exponentValue * 10 + Int(bytes[index] - UInt8(ascii: "0")), 100_000)
+                    index += 1
+                }
+                if exponentNegative {
+                    exponentValue = -exponentValue
+                }
+            }
+            exponent += exponentValue
+
+            if significantDigits <= 15 && abs(exponent) <= 22 {
+                var value = Double(mantissa)
+                if exponent < 0 {
+                    value /= UTF8Stream._exactPowersOfTen[-exponent]
+                } else {
+                    value *= UTF8Stream._exactPowersOfTen[exponent]
+                }
+                return negative ? -value : value
+            }
+            return Double(String(decoding: bytes, as: UTF8.self))
+        }
+    }
+}
@@ -13,7 +13,6 @@ extension Scanner : @unchecked Sendable { }
 open class Scanner: NSObject, NSCopying {
     internal var _scanString: String
     internal var _skipSet: CharacterSet?
-    internal var _invertedSkipSet: CharacterSet?
     internal var _scanLocation: Int
     
     open override func copy() -> Any {
@@ -45,19 +44,6 @@ open class Scanner: NSObject, NSCopying {
         }
         set {
             _skipSet = newValue
-            _invertedSkipSet = nil
-        }
-    }
-    
-    internal var invertedSkipSet: CharacterSet? {
-        if let inverted = _invertedSkipSet {
-            return inverted
-        } else {
-            if let set = charactersToBeSkipped {
-                _invertedSkipSet = set.inverted
-                return _invertedSkipSet
-            }
-            return nil
         }
     }
     
@@ -146,8 +132,8 @@ open class Scanner: NSObject, NSCopying {
     open var isAtEnd: Bool {
         var stringLoc = scanLocation
         let stringLen = string.length
-        if let invSet = invertedSkipSet {
-            let range = string._nsObject.rangeOfCharacter(from: invSet, options: [], range: NSRange(location: stringLoc, length: stringLen - stringLoc))
+        if let skipSet = charactersToBeSkipped {
+            let range = string._nsObject._rangeOfCharacter(notIn: skipSet, range: NSRange(location: stringLoc, length: stringLen - stringLoc))
             stringLoc = range.length > 0 ? range.location : stringLen
         }
         return stringLoc == stringLen
@@ -262,9 +248,14 @@ internal struct _NSStringBuffer {
     }
     
     mutating func skip(_ skipSet: CharacterSet?) {
-        if let set = skipSet {
-            while set.contains(UnicodeScalar(currentCharacter)!) && !isAtEnd {
+        if let set = skipSet, !isAtEnd {
+            let from = location
+            let range = string._rangeOfCharacter(notIn: set, range: NSRange(location: from, length: stringLen - from))
+            if range.location == NSNotFound {
+                location = stringLen - 1
                 advance()
+            } else if range.location != from {
+                location = range.location
             }
         }
     }
@@ -538,16 +529,15 @@ extension Scanner {
         return false
     }
     
-    // These methods avoid calling the private API for _invertedSkipSet and manually re-construct them so that it is only usage of public API usage
-    // Future implementations on Darwin of these methods will likely be more optimized to take advantage of the cached values.
+    // These methods skip charactersToBeSkipped, and scan runs of a character set, by searching for the first character not in the set rather than by building an inverted set on every call.
     private func _scanStringSplittingGraphemes(_ searchString: String) -> String? {
         let str = self.string._bridgeToObjectiveC()
         var stringLoc = scanLocation
         let stringLen = str.length
         let options: NSString.CompareOptions = [caseSensitive ? [] : .caseInsensitive, .anchored]
         
-        if let invSkipSet = charactersToBeSkipped?.inverted {
-            let range = str.rangeOfCharacter(from: invSkipSet, options: [], range: NSRange(location: stringLoc, length: stringLen - stringLoc))
+        if let skipSet = charactersToBeSkipped {
+            let range = str._rangeOfCharacter(notIn: skipSet, range: NSRange(location: stringLoc, length: stringLen - stringLoc))
             stringLoc = range.length > 0 ? range.location : stringLen
         }
         
@@ -580,11 +570,11 @@ extension Scanner {
         var stringLoc = scanLocation
         let stringLen = str.length
         let options: NSString.CompareOptions = caseSensitive ? [] : .caseInsensitive
-        if let invSkipSet = charactersToBeSkipped?.inverted {
-            let range = str.rangeOfCharacter(from: invSkipSet, options: [], range: NSRange(location: stringLoc, length: stringLen - stringLoc))
+        if let skipSet = charactersToBeSkipped {
+            let range = str._rangeOfCharacter(notIn: skipSet, range: NSRange(location: stringLoc, length: stringLen - stringLoc))
             stringLoc = range.length > 0 ? range.location : stringLen
         }
-        var range = str.rangeOfCharacter(from: set.inverted, options: options, range: NSRange(location: stringLoc, length: stringLen - stringLoc))
+        var range = str._rangeOfCharacter(notIn: set, options: options, range: NSRange(location: stringLoc, length: stringLen - stringLoc))
         if range.length == 0 {
             range.location = stringLen
         }
@@ -611,8 +601,8 @@ extension Scanner {
         var stringLoc = scanLocation
         let stringLen = str.length
         let options: NSString.CompareOptions = caseSensitive ? [] : .caseInsensitive
-        if let invSkipSet = charactersToBeSkipped?.inverted {
-            let range = str.rangeOfCharacter(from: invSkipSet, options: [], range: NSRange(location: stringLoc, length: stringLen - stringLoc))
+        if let skipSet = charactersToBeSkipped {
+            let range = str._rangeOfCharacter(notIn: skipSet, range: NSRange(location: stringLoc, length: stringLen - stringLoc))
             stringLoc = range.length > 0 ? range.location : stringLen
         }
         var range = str.range(of: string, options: options, range: NSRange(location: stringLoc, length: stringLen - stringLoc))
@@ -647,8 +637,8 @@ extension Scanner {
         var stringLoc = scanLocation
         let stringLen = str.length
         let options: NSString.CompareOptions = caseSensitive ? [] : .caseInsensitive
-        if let invSkipSet = charactersToBeSkipped?.inverted {
-            let range = str.rangeOfCharacter(from: invSkipSet, options: [], range: NSRange(location: stringLoc, length: stringLen - stringLoc))
+        if let skipSet = charactersToBeSkipped {
+            let range = str._rangeOfCharacter(notIn: skipSet, range: NSRange(location: stringLoc, length: stringLen - stringLoc))
             stringLoc = range.length > 0 ? range.location : stringLen
         }
         var range = str.rangeOfCharacter(from: set, options: options, range: NSRange(location: stringLoc, length: stringLen - stringLoc))
@@ -29,7 +29,7 @@ public struct URLResourceValues {
         _keys = []
     }
     
-    fileprivate init(keys: Set<URLResourceKey>, values: [URLResourceKey: Any]) {
+    internal init(keys: Set<URLResourceKey>, values: [URLResourceKey: Any]) {
         _values = values
         _keys = keys
     }
@@ -458,6 +458,18 @@ extension URL {
         return URLResourceValues(keys: keys, values: try (self as NSURL).resourceValues(forKeys: Array(keys)))
     }
 
+    /// Returns the resource values identified by the given resource keys for each of the given URLs.
+    ///
+    /// Each item is examined with a single `stat` for all of the keys that can be answered that way, such as its type, size and dates. With a `maximumConcurrency` above 1, that many items are examined at the same time.
+    ///
+    /// The result for each URL is either its resource values or the error that fetching them threw, in the same order as `urls`.
+    public static func resourceValues(forKeys keys: Set<URLResourceKey>, of urls: [URL], maximumConcurrency: Int = 1) -> [Result<URLResourceValues, Error>] {
+        let results = NSURL.resourceValues(forKeys: Array(keys), of: urls.map { $0 as NSURL }, maximumConcurrency: maximumConcurrency)
+        return results.map { result in
+            result.map { URLResourceValues(keys: keys, values: $0) }
+        }
+    }
+
     /// Sets a temporary resource value on the URL object.
     ///
     /// Temporary resource values are for client use. Temporary resource values exist only in memory and are never written to the resource's backing store. Once set, a temporary resource value can be copied from the URL object with `func resourceValues(forKeys:)`. The values are stored in the loosely-typed `allValues` dictionary property.
@@ -79,6 +79,9 @@ internal extension URLSession {
         let shouldUseExtendedBackgroundIdleMode: Bool
         
         let protocolClasses: [AnyClass]?
+        
+        /// The number of event loops (multi handles) transfers are spread across
+        let eventLoopCount: Int
     }
 }
 internal extension URLSession._Configuration {
@@ -101,6 +104,7 @@ internal extension URLSession._Configuration {
         urlCache = config.urlCache
         shouldUseExtendedBackgroundIdleMode = config.shouldUseExtendedBackgroundIdleMode
         protocolClasses = config.protocolClasses
+        eventLoopCount = max(1, config.eventLoopCount)
     }
 }
 
@@ -402,8 +402,10 @@ internal class _HTTPURLProtocol: _NativeProtocol {
 
         easyHandle.set(customHeaders: customHeaders)
 
-        //TODO: The CURLOPT_PIPEDWAIT option is unavailable on Ubuntu 14.04 (libcurl 7.36)
-        //TODO: Introduce something like an #if, if we want to set them here
+        // Prefer multiplexing onto an existing connection over opening a new
+        // one, and let the task priority steer the HTTP/2 stream weight.
+        easyHandle.set(waitForPipelining: true)
+        easyHandle.set(streamWeight: streamPriority(for: request))
 
         //set the request timeout
         //TODO: the timeout value needs to be reset on every data transfer
@@ -681,6 +683,18 @@ internal class _HTTPURLProtocol: _NativeProtocol {
         
         return ["Expect"]
     }
+    /// The priority to use for the HTTP/2 stream of this transfer.
+    ///
+    /// This is the task's priority. Requests with the `.background` network
+    /// service type never exceed `URLSessionTask.lowPriority`, so that they
+    /// yield bandwidth to interactive streams sharing the same connection.
+    func streamPriority(for request: URLRequest) -> Float {
+        let priority = task?.priorityOnWorkQueue ?? URLSessionTask.defaultPriority
+        if request.networkServiceType == .background {
+            return min(priority, URLSessionTask.lowPriority)
+        }
+        return priority
+    }
 }
 
 fileprivate let userAgentString: String = {
@@ -80,12 +80,16 @@ internal class _NativeProtocol: URLProtocol, _EasyHandleDelegate {
                 fatalError("Need to solve pausing receive.")
             }
             if internalState.isEasyHandleAddedToMultiHandle && !newValue.isEasyHandleAddedToMultiHandle {
-                task?.session.remove(handle: easyHandle)
+                if let task = task {
+                    task.session.remove(handle: easyHandle, for: task)
+                }
             }
         }
         didSet {
             if !oldValue.isEasyHandleAddedToMultiHandle && internalState.isEasyHandleAddedToMultiHandle {
-                task?.session.add(handle: easyHandle)
+                if let task = task {
+                    task.session.add(handle: easyHandle, for: task)
+                }
             }
             if oldValue.isEasyHandlePaused && !internalState.isEasyHandlePaused {
                 fatalError("Need to solve pausing receive.")
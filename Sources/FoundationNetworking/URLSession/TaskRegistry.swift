@@ -32,7 +32,9 @@ extension URLSession {
     /// The behaviour stores the completion handler for tasks that are
     /// completion handler based.
     ///
-    /// - Note: This must **only** be accessed on the owning session's work queue.
+    /// - Note: Tasks are added and removed on the owning session's work queue.
+    ///   Their behaviours are also looked up from the queues of the session's
+    ///   event loops, so all access goes through `lock`.
     class _TaskRegistry {
         /// Completion handler for `URLSessionDataTask`, and `URLSessionUploadTask`.
         typealias DataTaskCompletion = @Sendable (Data?, URLResponse?, Error?) -> Void
@@ -52,6 +54,7 @@ extension URLSession {
             case downloadCompletionHandlerWithTaskDelegate(DownloadTaskCompletion, URLSessionTaskDelegate?)
         }
         
+        fileprivate let lock = NSLock()
         fileprivate var tasks: [Int: URLSessionTask] = [:]
         fileprivate var behaviours: [Int: _Behaviour] = [:]
         fileprivate var tasksFinishedCallback: (() -> Void)?
@@ -61,8 +64,10 @@ extension URLSession {
 extension URLSession._TaskRegistry {
     /// Add a task
     ///
-    /// - Note: This must **only** be accessed on the owning session's work queue.
+    /// - Note: This must **only** be called on the owning session's work queue.
     func add(_ task: URLSessionTask, behaviour: _Behaviour) {
+        lock.lock()
+        defer { lock.unlock() }
         let identifier = task.taskIdentifier
         guard identifier != 0 else { fatalError("Invalid task identifier") }
         guard tasks.index(forKey: identifier) == nil else {
@@ -77,10 +82,11 @@ extension URLSession._TaskRegistry {
     }
     /// Remove a task
     ///
-    /// - Note: This must **only** be accessed on the owning session's work queue.
+    /// - Note: This must **only** be called on the owning session's work queue.
     func remove(_ task: URLSessionTask) {
         let identifier = task.taskIdentifier
         guard identifier != 0 else { fatalError("Invalid task identifier") }
+        lock.lock()
         guard let tasksIdx = tasks.index(forKey: identifier) else {
             fatalError("Trying to remove task, but it's not in the registry.")
         }
@@ -89,22 +95,27 @@ extension URLSession._TaskRegistry {
             fatalError("Trying to remove task's behaviour, but it's not in the registry.")
         }
         behaviours.remove(at: behaviourIdx)
+        let allTasksFinished = tasks.isEmpty ? tasksFinishedCallback : nil
+        lock.unlock()
 
-        guard let allTasksFinished = tasksFinishedCallback else { return }
-        if self.isEmpty {
-            allTasksFinished()
-        }
+        allTasksFinished?()
     }
 
     func notify(on tasksCompletion: @escaping () -> Void) {
+        lock.lock()
         tasksFinishedCallback = tasksCompletion
+        lock.unlock()
     }
 
     var isEmpty: Bool {
+        lock.lock()
+        defer { lock.unlock() }
         return tasks.isEmpty
     }
     
     var allTasks: [URLSessionTask] {
+        lock.lock()
+        defer { lock.unlock() }
         return tasks.map { $0.value }
     }
 }
@@ -112,8 +123,10 @@ extension URLSession._TaskRegistry {
     /// The behaviour that's registered for the given task.
     ///
     /// - Note: It is a programming error to pass a task that isn't registered.
-    /// - Note: This must **only** be accessed on the owning session's work queue.
+    /// - Note: This can be called from any queue.
     func behaviour(for task: URLSessionTask) -> _Behaviour {
+        lock.lock()
+        defer { lock.unlock() }
         guard let b = behaviours[task.taskIdentifier] else {
             fatalError("Trying to access a behaviour for a task that in not in the registry.")
         }
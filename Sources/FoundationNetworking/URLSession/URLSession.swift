@@ -137,6 +137,18 @@
 /// - SeeAlso: https://curl.haxx.se/libcurl/c/threadsafe.html
 /// - SeeAlso: URLSession+libcurl.swift
 ///
+/// ## Event Loops
+///
+/// By default all transfers of a session are driven by a single
+/// `_MultiHandle` whose socket and timer sources run on `workQueue`. When
+/// `URLSessionConfiguration.eventLoopCount` is larger than 1, the session
+/// creates that many `_EventLoop`s, each with its own serial queue and multi
+/// handle. A task is bound to one event loop for its whole lifetime -- its
+/// `workQueue` targets the event loop's queue -- so callbacks for a single
+/// task stay serialized while different tasks make progress in parallel.
+/// Tasks are assigned by scheme, host and port such that connection reuse
+/// is unaffected.
+///
 /// ## HTTP and RFC 2616
 ///
 /// Most of HTTP is defined in [RFC 2616](https://tools.ietf.org/html/rfc2616).
@@ -187,7 +199,7 @@ public let NSURLSessionTransferSizeUnknown: Int64 = -1
 
 open class URLSession : NSObject, @unchecked Sendable {
     internal let _configuration: _Configuration
-    fileprivate let multiHandle: _MultiHandle
+    fileprivate let eventLoops: [_EventLoop]
     fileprivate var nextTaskIdentifier = 1
     internal let workQueue: DispatchQueue 
     internal let taskRegistry = URLSession._TaskRegistry()
@@ -239,7 +251,7 @@ open class URLSession : NSObject, @unchecked Sendable {
         self.configuration = configuration.copy() as! URLSessionConfiguration
         let c = URLSession._Configuration(URLSessionConfiguration: configuration)
         self._configuration = c
-        self.multiHandle = _MultiHandle(configuration: c, workQueue: workQueue)
+        self.eventLoops = URLSession._EventLoop.makeEventLoops(configuration: c, workQueue: workQueue, sessionIdentifier: identifier)
         // registering all the protocol classes with URLProtocol
         let _ = URLSession.registerProtocols
     }
@@ -265,7 +277,7 @@ open class URLSession : NSObject, @unchecked Sendable {
         self.configuration = configuration.copy() as! URLSessionConfiguration
         let c = URLSession._Configuration(URLSessionConfiguration: configuration)
         self._configuration = c
-        self.multiHandle = _MultiHandle(configuration: c, workQueue: workQueue)
+        self.eventLoops = URLSession._EventLoop.makeEventLoops(configuration: c, workQueue: workQueue, sessionIdentifier: identifier)
         // registering all the protocol classes with URLProtocol
         let _ = URLSession.registerProtocols
     }
@@ -412,6 +424,27 @@ open class URLSession : NSObject, @unchecked Sendable {
             }
         }
     }
+
+    /* invokes completionHandler with the number of transfers carried by each connection currently in use.
+     * A connection carrying more than one transfer is multiplexing them as HTTP/2 streams.
+     */
+    open func getStreamCountsPerConnection(completionHandler: @Sendable @escaping ([Int]) -> Void) {
+        collectStreamCounts(fromEventLoopAt: 0, counts: [], completionHandler: completionHandler)
+    }
+
+    /// Visits the event loops one after the other, each on its own queue.
+    fileprivate func collectStreamCounts(fromEventLoopAt index: Int, counts: [Int], completionHandler: @Sendable @escaping ([Int]) -> Void) {
+        guard index < eventLoops.count else {
+            delegateQueue.addOperation {
+                completionHandler(counts)
+            }
+            return
+        }
+        eventLoops[index].queue.async {
+            let loopCounts = self.eventLoops[index].multiHandle.streamCountsPerConnection()
+            self.collectStreamCounts(fromEventLoopAt: index + 1, counts: counts + loopCounts, completionHandler: completionHandler)
+        }
+    }
     
     /*
      * URLSessionTask objects are always created in a suspended state and
@@ -887,19 +920,64 @@ extension URLSession {
 }
 
 
+extension URLSession {
+    /// A serial queue together with the multi handle whose socket and timer
+    /// sources run on it.
+    ///
+    /// - SeeAlso: URLSessionConfiguration.eventLoopCount
+    internal struct _EventLoop {
+        let queue: DispatchQueue
+        let multiHandle: _MultiHandle
+
+        static func makeEventLoops(configuration: URLSession._Configuration, workQueue: DispatchQueue, sessionIdentifier: Int32) -> [_EventLoop] {
+            guard configuration.eventLoopCount > 1 else {
+                // A single event loop shares the session's queue, exactly
+                // like a session without event loops.
+                return [_EventLoop(queue: workQueue, multiHandle: _MultiHandle(configuration: configuration, workQueue: workQueue))]
+            }
+            return (0..<configuration.eventLoopCount).map { index in
+                // These deliberately don't target the shared queue that all
+                // session work queues target; that would serialize them again.
+                let queue = DispatchQueue(label: "URLSession<\(sessionIdentifier)>.EventLoop<\(index)>", target: .global())
+                return _EventLoop(queue: queue, multiHandle: _MultiHandle(configuration: configuration, workQueue: queue))
+            }
+        }
+    }
+
+    /// The index of the event loop that transfers for the given request run on.
+    ///
+    /// Requests to the same scheme, host and port always map to the same
+    /// event loop so that they can share connections.
+    internal func eventLoopIndex(for request: URLRequest) -> Int {
+        guard eventLoops.count > 1, let url = request.url else { return 0 }
+        var hasher = Hasher()
+        hasher.combine(url.scheme?.lowercased())
+        hasher.combine(url.host?.lowercased())
+        hasher.combine(url.port)
+        return Int(UInt(bitPattern: hasher.finalize()) % UInt(eventLoops.count))
+    }
+
+    /// The queue that a task bound to the given event loop must target.
+    internal func eventLoopQueue(at index: Int) -> DispatchQueue {
+        return eventLoops[index].queue
+    }
+}
+
 internal protocol URLSessionProtocol: AnyObject {
-    func add(handle: _EasyHandle)
-    func remove(handle: _EasyHandle)
+    func add(handle: _EasyHandle, for task: URLSessionTask)
+    func remove(handle: _EasyHandle, for task: URLSessionTask)
     func behaviour(for: URLSessionTask) -> URLSession._TaskBehaviour
     var configuration: URLSessionConfiguration { get }
     var delegate: URLSessionDelegate? { get }
 }
 extension URLSession: URLSessionProtocol {
-    func add(handle: _EasyHandle) {
-        multiHandle.add(handle)
+    /// - Note: This must be called on the task's `workQueue`.
+    func add(handle: _EasyHandle, for task: URLSessionTask) {
+        eventLoops[task.eventLoopIndex].multiHandle.add(handle)
     }
-    func remove(handle: _EasyHandle) {
-        multiHandle.remove(handle)
+    /// - Note: This must be called on the task's `workQueue`.
+    func remove(handle: _EasyHandle, for task: URLSessionTask) {
+        eventLoops[task.eventLoopIndex].multiHandle.remove(handle)
     }
 }
 /// This class is only used to allow `URLSessionTask.init()` to work.
@@ -912,10 +990,10 @@ final internal class _MissingURLSession: URLSessionProtocol {
     var configuration: URLSessionConfiguration {
         fatalError()
     }
-    func add(handle: _EasyHandle) {
+    func add(handle: _EasyHandle, for task: URLSessionTask) {
         fatalError()
     }
-    func remove(handle: _EasyHandle) {
+    func remove(handle: _EasyHandle, for task: URLSessionTask) {
         fatalError()
     }
     func behaviour(for: URLSessionTask) -> URLSession._TaskBehaviour {
@@ -54,6 +54,7 @@ open class URLSessionConfiguration : NSObject, NSCopying, @unchecked Sendable {
         self.urlCache = URLSessionConfiguration.default.urlCache
         self.shouldUseExtendedBackgroundIdleMode = URLSessionConfiguration.default.shouldUseExtendedBackgroundIdleMode
         self.protocolClasses = URLSessionConfiguration.default.protocolClasses
+        self.eventLoopCount = URLSessionConfiguration.default.eventLoopCount
         super.init()
     }
     
@@ -75,7 +76,8 @@ open class URLSessionConfiguration : NSObject, NSCopying, @unchecked Sendable {
                   urlCredentialStorage: .shared,
                   urlCache: .shared,
                   shouldUseExtendedBackgroundIdleMode: false,
-                  protocolClasses: [_HTTPURLProtocol.self, _FTPURLProtocol.self, _WebSocketURLProtocol.self])
+                  protocolClasses: [_HTTPURLProtocol.self, _FTPURLProtocol.self, _WebSocketURLProtocol.self],
+                  eventLoopCount: 1)
     }
     
     private init(identifier: String?,
@@ -95,7 +97,8 @@ open class URLSessionConfiguration : NSObject, NSCopying, @unchecked Sendable {
                  urlCredentialStorage: URLCredentialStorage?,
                  urlCache: URLCache?,
                  shouldUseExtendedBackgroundIdleMode: Bool,
-                 protocolClasses: [AnyClass]?)
+                 protocolClasses: [AnyClass]?,
+                 eventLoopCount: Int)
     {
         self.identifier = identifier
         self.requestCachePolicy = requestCachePolicy
@@ -115,6 +118,7 @@ open class URLSessionConfiguration : NSObject, NSCopying, @unchecked Sendable {
         self.urlCache = urlCache
         self.shouldUseExtendedBackgroundIdleMode = shouldUseExtendedBackgroundIdleMode
         self.protocolClasses = protocolClasses
+        self.eventLoopCount = eventLoopCount
     }
     
     open override func copy() -> Any {
@@ -140,7 +144,8 @@ open class URLSessionConfiguration : NSObject, NSCopying, @unchecked Sendable {
             urlCredentialStorage: urlCredentialStorage,
             urlCache: urlCache,
             shouldUseExtendedBackgroundIdleMode: shouldUseExtendedBackgroundIdleMode,
-            protocolClasses: protocolClasses)
+            protocolClasses: protocolClasses,
+            eventLoopCount: eventLoopCount)
     }
     
     open class var `default`: URLSessionConfiguration {
@@ -244,6 +249,15 @@ open class URLSessionConfiguration : NSObject, NSCopying, @unchecked Sendable {
      */
      open var protocolClasses: [AnyClass]?
 
+     /* The number of event loops that drive the session's transfers. Each event loop owns its own
+      connection pool and runs its socket and timer handling on its own serial queue, so sessions with
+      many concurrent small transfers can spread that work across several cores. Tasks are assigned to
+      an event loop by scheme, host and port, so connections to a given host are still reused. Delegate
+      messages for a single task are delivered in order regardless of this setting.
+      The default is 1; values less than 1 are treated as 1.
+      */
+     open var eventLoopCount: Int
+
      /* A Boolean value that indicates whether the session should wait for connectivity to become available, or fail immediately */
      @available(*, unavailable, message: "Not available on non-Darwin platforms")
      open var waitsForConnectivity: Bool { NSUnsupported() }
@@ -245,6 +245,11 @@ open class URLSessionTask : NSObject, NSCopying, @unchecked Sendable {
     /// All operations must run on this queue.
     internal let workQueue: DispatchQueue 
     
+    /// The session event loop that this task's transfers run on.
+    ///
+    /// - SeeAlso: URLSessionConfiguration.eventLoopCount
+    internal let eventLoopIndex: Int
+    
     public override init() {
         // Darwin Foundation oddly allows calling this initializer, even though
         // such a task is quite broken -- it doesn't have a session. And calling
@@ -257,6 +262,7 @@ open class URLSessionTask : NSObject, NSCopying, @unchecked Sendable {
         originalRequest = nil
         knownBody = URLSessionTask._Body.none
         workQueue = DispatchQueue(label: "URLSessionTask.notused.0")
+        eventLoopIndex = 0
         super.init()
     }
     /// Create a data task. If there is a httpBody in the URLRequest, use that as a parameter
@@ -273,7 +279,8 @@ open class URLSessionTask : NSObject, NSCopying, @unchecked Sendable {
     internal init(session: URLSession, request: URLRequest, taskIdentifier: Int, body: _Body?) {
         self.session = session
         /* make sure we're actually having a serial queue as it's used for synchronization */
-        self.workQueue = DispatchQueue.init(label: "org.swift.URLSessionTask.WorkQueue", target: session.workQueue)
+        self.eventLoopIndex = session.eventLoopIndex(for: request)
+        self.workQueue = DispatchQueue.init(label: "org.swift.URLSessionTask.WorkQueue", target: session.eventLoopQueue(at: eventLoopIndex))
         self.taskIdentifier = taskIdentifier
         self.originalRequest = request
         self.knownBody = body
@@ -529,6 +536,11 @@ open class URLSessionTask : NSObject, NSCopying, @unchecked Sendable {
         }
     }
     fileprivate var _priority: Float = URLSessionTask.defaultPriority
+    /// The priority, for readers already running on the work queue where
+    /// `priority` would deadlock.
+    internal var priorityOnWorkQueue: Float {
+        return _priority
+    }
 }
 
 extension URLSessionTask {
@@ -40,6 +40,18 @@ internal func xferInfoFunctionSupported() -> Bool {
     CFURLSessionOptionXFERINFOFUNCTION.value != 0
 }
 
+internal func pipeWaitSupported() -> Bool {
+    CFURLSessionOptionPIPEWAIT.value != 0
+}
+
+internal func streamWeightSupported() -> Bool {
+    CFURLSessionOptionSTREAM_WEIGHT.value != 0
+}
+
+internal func maxConcurrentStreamsSupported() -> Bool {
+    CFURLSessionMultiOptionMAX_CONCURRENT_STREAMS.value != 0
+}
+
 /// Minimal wrapper around the [curl easy interface](https://curl.haxx.se/libcurl/c/)
 ///
 /// An *easy handle* manages the state of a transfer inside libcurl.
@@ -319,16 +331,39 @@ extension _EasyHandle {
         // We need to retain the list for as long as the rawHandle is in use.
         headerList = list
     }
-    ///TODO: Wait for pipelining/multiplexing. Unavailable on Ubuntu 14.0
+    /// Wait for pipelining/multiplexing
+    ///
+    /// When set, libcurl prefers to wait for an existing connection to the
+    /// same host to confirm whether it can multiplex (HTTP/2) instead of
+    /// opening a new parallel connection right away.
     /// - SeeAlso: https://curl.haxx.se/libcurl/c/CURLOPT_PIPEWAIT.html
+    func set(waitForPipelining flag: Bool) {
+        guard pipeWaitSupported() else { return }
+        try! CFURLSession_easy_setopt_long(rawHandle, CFURLSessionOptionPIPEWAIT, flag ? 1 : 0).asError()
+    }
     
     //TODO: The public API does not allow us to use CFURLSessionOptionSTREAM_DEPENDS / CFURLSessionOptionSTREAM_DEPENDS_E
     // Might be good to add support for it, though.
     
-    ///TODO: Set numerical stream weight when CURLOPT_PIPEWAIT is enabled
+    /// Set numerical stream weight
+    ///
+    /// Only has an effect on multiplexed (HTTP/2) connections.
     /// - Parameter weight: values are clamped to lie between 0 and 1
     /// - SeeAlso: https://curl.haxx.se/libcurl/c/CURLOPT_STREAM_WEIGHT.html
     /// - SeeAlso: http://httpwg.org/specs/rfc7540.html#StreamPriority
+    func set(streamWeight weight: Float) {
+        guard streamWeightSupported() else { return }
+        try! CFURLSession_easy_setopt_long(rawHandle, CFURLSessionOptionSTREAM_WEIGHT, numericCast(_EasyHandle.http2StreamWeight(for: weight))).asError()
+    }
+
+    /// Maps a priority in the range 0...1 onto the HTTP/2 stream weight
+    /// range 1...256. The default priority of 0.5 maps to 129; invalid values
+    /// fall back to the HTTP/2 default weight of 16.
+    static func http2StreamWeight(for priority: Float) -> Int {
+        guard priority.isFinite else { return 16 }
+        let clamped = min(max(priority, 0), 1)
+        return 1 + Int((clamped * 255).rounded())
+    }
 
     /// Enable automatic decompression of HTTP downloads
     /// - SeeAlso: https://curl.haxx.se/libcurl/c/CURLOPT_ACCEPT_ENCODING.html
@@ -545,6 +580,18 @@ internal extension _EasyHandle {
         try! CFURLSession_easy_getinfo_long(rawHandle, CFURLSessionInfoOS_ERRNO, &errno).asError()
         return numericCast(errno)
     }
+    /// The socket of the connection this handle is currently using, if any.
+    ///
+    /// Several easy handles report the same socket when their transfers are
+    /// multiplexed over a single connection.
+    /// - SeeAlso: https://curl.haxx.se/libcurl/c/CURLINFO_ACTIVESOCKET.html
+    var connectionSocket: CFURLSession_socket_t? {
+        var socket = CFURLSessionSocketBad
+        guard CFURLSession_easy_getinfo_socket(rawHandle, CFURLSessionInfoACTIVESOCKET, &socket) == CFURLSessionEasyCodeOK, socket != CFURLSessionSocketBad else {
+            return nil
+        }
+        return socket
+    }
 }
 
 
@@ -73,7 +73,14 @@ extension URLSession._MultiHandle {
             try! CFURLSession_multi_setopt_l(rawHandle, CFURLSessionMultiOptionMAX_HOST_CONNECTIONS, numericCast(configuration.httpMaximumConnectionsPerHost)).asError()
         }
         
+        // 2 is CURLPIPE_MULTIPLEX: transfers to the same host share a single
+        // HTTP/2 connection whenever the server supports it. Together with
+        // CURLOPT_PIPEWAIT on the easy handles this keeps the number of
+        // connections per host low when many requests are in flight.
         try! CFURLSession_multi_setopt_l(rawHandle, CFURLSessionMultiOptionPIPELINING, configuration.httpShouldUsePipelining ? 3 : 2).asError()
+        if maxConcurrentStreamsSupported() {
+            try! CFURLSession_multi_setopt_l(rawHandle, CFURLSessionMultiOptionMAX_CONCURRENT_STREAMS, numericCast(URLSession._MultiHandle.maximumConcurrentStreamsPerConnection)).asError()
+        }
         //TODO: We may want to set
         //    CFURLSessionMultiOptionMAXCONNECTS
         //    CFURLSessionMultiOptionMAX_TOTAL_CONNECTIONS
@@ -250,6 +257,32 @@ private extension URLSession._MultiHandle {
 
 }
 
+internal extension URLSession._MultiHandle {
+    /// The number of HTTP/2 streams libcurl may open on a single connection
+    /// before it starts a new one. Servers may advertise a lower limit.
+    static let maximumConcurrentStreamsPerConnection = 100
+
+    /// The number of transfers carried by each connection currently in use.
+    ///
+    /// Transfers that are multiplexed over the same HTTP/2 connection are
+    /// counted against that connection. Transfers that have not yet been
+    /// assigned a connection are not counted.
+    func streamCountsPerConnection() -> [Int] {
+        return URLSession._MultiHandle.streamCounts(forConnectionSockets: easyHandles.map { $0.connectionSocket })
+    }
+
+    /// Groups transfers by the socket of the connection carrying them.
+    ///
+    /// A `nil` socket marks a transfer that is not using a connection yet.
+    static func streamCounts<Socket: Hashable>(forConnectionSockets sockets: [Socket?]) -> [Int] {
+        var counts: [Socket: Int] = [:]
+        for case let socket? in sockets {
+            counts[socket, default: 0] += 1
+        }
+        return Array(counts.values)
+    }
+}
+
 internal extension URLSession._MultiHandle {
     /// Add an easy handle -- start its transfer.
     func add(_ handle: _EasyHandle) {
@@ -81,7 +81,19 @@ open class XMLElement: XMLNode {
         @abstract Returns all of the child elements that match this name.
     */
     open func elements(forName name: String) -> [XMLElement] {
-        return self.filter({ _CFXMLNodeGetType($0._xmlNode) == _kCFXMLTypeElement }).filter({ $0.name == name }).compactMap({ $0 as? XMLElement })
+        guard _isLazilyWrapped else {
+            return self.filter({ _CFXMLNodeGetType($0._xmlNode) == _kCFXMLTypeElement }).filter({ $0.name == name }).compactMap({ $0 as? XMLElement })
+        }
+        // Match on the libxml2 nodes of a compact tree so that only the matching children get an XMLElement.
+        var result: [XMLElement] = []
+        var nextChild = _CFXMLNodeGetFirstChild(_xmlNode)
+        while let child = nextChild {
+            if _CFXMLNodeGetType(child) == _kCFXMLTypeElement && _CFXMLNodeQualifiedNameEqual(child, name) {
+                result.append(XMLElement._objectNodeForNode(child))
+            }
+            nextChild = _CFXMLNodeGetNextSibling(child)
+        }
+        return result
     }
 
     /*!
@@ -162,6 +174,10 @@ open class XMLElement: XMLNode {
             let temp = _CFXMLNodeGetNextSibling(attribute)
             _CFXMLUnlinkNode(attribute)
             if shouldFreeNode {
+                // In a compact tree, the text of an attribute without an object can still have one.
+                if _isLazilyWrapped {
+                    XMLNode._detachWrappedDescendants(of: attribute, includingAttributes: false)
+                }
                 _CFXMLFreeNode(attribute)
             }
 
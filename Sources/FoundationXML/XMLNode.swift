@@ -71,6 +71,11 @@ open class XMLNode: NSObject, NSCopying {
         public static let documentTidyHTML = Options(rawValue: 1 << 9)
         public static let documentTidyXML = Options(rawValue: 1 << 10)
         public static let documentValidate = Options(rawValue: 1 << 13)
+        /// Parses into a compact libxml2 tree: short text is stored inline in its node and names are shared
+        /// through the document's dictionary. The tree is owned by the document, and node objects for it are
+        /// created on demand and discarded once nothing references them, so a fresh object may be returned
+        /// for the same node later on. Not available on Darwin.
+        public static let documentCompactTree = Options(rawValue: 1 << 12)
         
         public static let nodeLoadExternalEntitiesAlways = Options(rawValue: 1 << 14)
         public static let nodeLoadExternalEntitiesSameOriginOnly = Options(rawValue: 1 << 15)
@@ -411,7 +416,11 @@ open class XMLNode: NSObject, NSCopying {
                 return returned == nil ? nil : unsafeBitCast(returned!, to: NSString.self) as String
                 
             case .element:
-                // As with Darwin, children's string values are just concatenated without spaces.
+                // As with Darwin, children's string values are just concatenated without spaces. The children of
+                // a compact tree are read directly rather than through an object for each of them.
+                if _isLazilyWrapped {
+                    return unsafeBitCast(_CFXMLElementCopyStringValue(_xmlNode), to: NSString.self) as String
+                }
                 return children?.compactMap({ $0.stringValue }).joined() ?? ""
                 
             default:
@@ -456,6 +465,12 @@ open class XMLNode: NSObject, NSCopying {
                 _childNodes.remove(node)
             }
         }
+        
+        // Nodes of a compact tree can have objects without being tracked in _childNodes, even when their parent
+        // has none, so look for them all the way down before the children are freed.
+        if _isLazilyWrapped {
+            XMLNode._detachWrappedDescendants(of: _xmlNode, includingAttributes: false)
+        }
     }
     
     internal func _removeAllChildren() {
@@ -576,7 +591,16 @@ open class XMLNode: NSObject, NSCopying {
      @abstract The amount of children, relevant for documents, elements, and document type declarations.
      */
     open var childCount: Int {
-        return self.children?.count ?? 0
+        guard _isLazilyWrapped else {
+            return self.children?.count ?? 0
+        }
+        switch kind {
+        case .document, .element, .DTDKind:
+            return _CFXMLNodeGetChildCount(_xmlNode)
+            
+        default:
+            return 0
+        }
     }
     
     /*!
@@ -851,21 +875,57 @@ open class XMLNode: NSObject, NSCopying {
      @returns An array whose elements are a kind of NSXMLNode.
      */
     open func nodes(forXPath xpath: String) throws -> [XMLNode] {
-        guard let nodes = _CFXMLNodesForXPath(_xmlNode, xpath) else {
-            return []
-        }
-        
+        return nodes(for: try _XPathCache.shared.expression(for: xpath))
+    }
+    
+    /*!
+     @method nodesForXPath:
+     @abstract Returns the nodes resulting from applying a precompiled XPath to this node using the node as the context item (".").
+     @returns An array whose elements are a kind of NSXMLNode.
+     */
+    public final func nodes(for xpath: XPath) -> [XMLNode] {
         var result: [XMLNode] = []
+        _enumerateNodes(for: xpath) { nodePtr in
+            result.append(XMLNode._objectNodeForNode(nodePtr))
+        }
+        return result
+    }
+    
+    /*!
+     @method stringValuesForXPath:error:
+     @abstract Returns the XPath string-value of each node resulting from applying an XPath to this node. No NSXMLNode objects are created for the results, which makes this considerably cheaper than mapping nodesForXPath:error: when only the values are needed.
+     @returns An array of strings, in document order.
+     */
+    public final func stringValues(forXPath xpath: String) throws -> [String] {
+        return stringValues(for: try _XPathCache.shared.expression(for: xpath))
+    }
+    
+    /*!
+     @method stringValuesForXPath:
+     @abstract Returns the XPath string-value of each node resulting from applying a precompiled XPath to this node, without creating NSXMLNode objects for the results.
+     @returns An array of strings, in document order.
+     */
+    public final func stringValues(for xpath: XPath) -> [String] {
+        var result: [String] = []
+        _enumerateNodes(for: xpath) { nodePtr in
+            let returned = _CFXMLCopyXPathStringValueForNode(nodePtr)
+            result.append(returned == nil ? "" : unsafeBitCast(returned!, to: NSString.self) as String)
+        }
+        return result
+    }
+    
+    private func _enumerateNodes(for xpath: XPath, _ body: (_CFXMLNodePtr) -> Void) {
+        guard let nodes = _CFXMLNodesForCompiledXPath(_xmlNode, xpath._compiled) else {
+            return
+        }
         
         let CFArrayGetCount = unsafeBitCast(CF.CFArrayGetCount, to: (@convention(c) (CFArray) -> CFIndex).self)
         let CFArrayGetValueAtIndex = unsafeBitCast(CF.CFArrayGetValueAtIndex, to: (@convention(c) (CFArray, CFIndex) -> UnsafeRawPointer?).self)
 
         for i in 0..<CFArrayGetCount(nodes) {
             let nodePtr = CFArrayGetValueAtIndex(nodes, i)!
-            result.append(XMLNode._objectNodeForNode(_CFXMLNodePtr(mutating: nodePtr)))
+            body(_CFXMLNodePtr(mutating: nodePtr))
         }
-        
-        return result
     }
     
     /*!
@@ -885,9 +945,23 @@ open class XMLNode: NSObject, NSCopying {
     
     internal var _childNodes: Set<XMLNode> = []
     
+    // Set for objects created on demand for a node of a compact tree; the tree only holds an unretained reference.
+    internal private(set) var _isLazilyWrapped = false
+    
     deinit {
         guard _xmlNode != nil else { return }
         
+        // A node that is still linked into a tree belongs to that tree. This is the common case for the
+        // objects of a compact document, which come and go while the document keeps its nodes.
+        if kind != .document && _CFXMLNodeGetParent(_xmlNode) != nil {
+            _CFXMLNodeSetPrivateData(_xmlNode, nil)
+            return
+        }
+        
+        if _isLazilyWrapped {
+            XMLNode._detachWrappedDescendants(of: _xmlNode, includingAttributes: true)
+        }
+        
         for node in _childNodes {
             node.detach()
         }
@@ -916,6 +990,17 @@ open class XMLNode: NSObject, NSCopying {
         _xmlNode = ptr
         super.init()
         
+        if let documentPtr = _CFXMLNodeGetDocument(_xmlNode), _CFXMLDocIsCompactTree(documentPtr) {
+            // The document owns every node of a compact tree, so neither the tree nor the parent object
+            // keeps this object alive; it only needs to keep the document around.
+            _isLazilyWrapped = true
+            _CFXMLNodeSetPrivateData(_xmlNode, Unmanaged.passUnretained(self).toOpaque())
+            if documentPtr != ptr {
+                _xmlDocument = XMLDocument._objectNodeForNode(documentPtr)
+            }
+            return
+        }
+        
         if let parent = _CFXMLNodeGetParent(_xmlNode) {
             let parentNode = XMLNode._objectNodeForNode(parent)
             parentNode._childNodes.insert(self)
@@ -931,6 +1016,38 @@ open class XMLNode: NSObject, NSCopying {
         }
     }
     
+    // Before the descendants of a node of a compact document are freed, hand every one that still has an
+    // object over to that object, which then owns it the same way it would after detach(). The attributes
+    // of `root` itself are only included when asked for; those of its descendants always are.
+    internal static func _detachWrappedDescendants(of root: _CFXMLNodePtr, includingAttributes: Bool) {
+        var pending: [_CFXMLNodePtr] = [root]
+        while let node = pending.popLast() {
+            let type = _CFXMLNodeGetType(node)
+            guard type == _kCFXMLTypeElement || type == _kCFXMLTypeAttribute else { continue }
+            
+            var nextChild = _CFXMLNodeGetFirstChild(node)
+            while let child = nextChild {
+                nextChild = _CFXMLNodeGetNextSibling(child)
+                if _CFXMLNodeGetPrivateData(child) != nil {
+                    _CFXMLUnlinkNode(child)
+                } else {
+                    pending.append(child)
+                }
+            }
+            
+            guard type == _kCFXMLTypeElement && (includingAttributes || node != root) else { continue }
+            var nextAttribute = _CFXMLNodeProperties(node)
+            while let attribute = nextAttribute {
+                nextAttribute = _CFXMLNodeGetNextSibling(attribute)
+                if _CFXMLNodeGetPrivateData(attribute) != nil {
+                    _CFXMLUnlinkNode(attribute)
+                } else {
+                    pending.append(attribute)
+                }
+            }
+        }
+    }
+    
     internal class func _objectNodeForNode(_ node: _CFXMLNodePtr) -> XMLNode {
         switch _CFXMLNodeGetType(node) {
         case _kCFXMLTypeElement:
@@ -1087,3 +1204,93 @@ extension XMLNode.Index {
         }
     }
 }
+
+extension XMLNode {
+    /*!
+     @class XPath
+     @abstract An XPath expression compiled once and reusable against any node. Compiled expressions are immutable and may be shared between threads.
+     */
+    public final class XPath : @unchecked Sendable {
+        /// The source text the expression was compiled from.
+        public let expression: String
+        
+        internal let _compiled: _CFXMLXPathPtr
+        
+        /*!
+         @method initWithExpression:error:
+         @abstract Compiles the given XPath. Throws if the expression is not syntactically valid.
+         */
+        public init(_ expression: String) throws {
+            guard let compiled = _CFXMLXPathCompile(expression) else {
+                throw NSError(domain: XMLParser.errorDomain, code: XMLParser.ErrorCode.internalError.rawValue, userInfo: [
+                    NSLocalizedDescriptionKey: "Invalid XPath expression: \(expression)"
+                ])
+            }
+            self.expression = expression
+            self._compiled = compiled
+        }
+        
+        deinit {
+            _CFXMLXPathFree(_compiled)
+        }
+    }
+}
+
+/// A bounded, least-recently-used cache of compiled XPath expressions keyed by their source text.
+/// `nodes(forXPath:)` and `stringValues(forXPath:)` go through it, so applications that run the same
+/// handful of queries against many documents pay for compilation once per expression.
+internal final class _XPathCache : @unchecked Sendable {
+    static let shared = _XPathCache(capacity: 128)
+    
+    private struct Entry {
+        let expression: XMLNode.XPath
+        var lastUse: UInt64
+    }
+    
+    let capacity: Int
+    private let lock = NSLock()
+    private var entries: [String: Entry] = [:]
+    private var clock: UInt64 = 0
+    
+    init(capacity: Int) {
+        precondition(capacity > 0)
+        self.capacity = capacity
+    }
+    
+    var count: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return entries.count
+    }
+    
+    func expression(for source: String) throws -> XMLNode.XPath {
+        lock.lock()
+        clock &+= 1
+        if let entry = entries[source] {
+            entries[source]!.lastUse = clock
+            lock.unlock()
+            return entry.expression
+        }
+        lock.unlock()
+        
+        // Compile outside the lock; if two threads race on the same source the later insert simply wins.
+        let compiled = try XMLNode.XPath(source)
+        
+        lock.lock()
+        defer { lock.unlock() }
+        clock &+= 1
+        if entries[source] == nil && entries.count >= capacity {
+            if let victim = entries.min(by: { $0.value.lastUse < $1.value.lastUse }) {
+                entries.removeValue(forKey: victim.key)
+            }
+        }
+        entries[source] = Entry(expression: compiled, lastUse: clock)
+        return compiled
+    }
+    
+    func removeAll() {
+        lock.lock()
+        defer { lock.unlock() }
+        entries.removeAll()
+    }
+}
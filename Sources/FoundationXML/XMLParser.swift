@@ -276,12 +276,10 @@ internal func _NSXMLParserStartElementNs(_ ctx: _CFXMLInterface, localname: Unsa
         }
         var attributeQName: String
         let attrLocalName = attributes[idx]!
-        let attrLocalNameString = UTF8STRING(attrLocalName)!
-        let attrPrefix = attributes[idx + 1]
-        if let attrPrefixString = UTF8STRING(attrPrefix), !attrPrefixString.isEmpty {
-            attributeQName = attrPrefixString + ":" + attrLocalNameString
+        if let attrPrefix = attributes[idx + 1], attrPrefix.pointee != 0 {
+            attributeQName = parser._internedQualifiedName(prefix: attrPrefix, localName: attrLocalName)
         } else {
-            attributeQName = attrLocalNameString
+            attributeQName = parser._internedName(attrLocalName)
         }
         // idx+2 = URI, which we throw away
         // idx+3 = value, i+4 = endvalue
@@ -298,19 +296,19 @@ internal func _NSXMLParserStartElementNs(_ ctx: _CFXMLInterface, localname: Unsa
         }
     }
 
-    var elementName: String = UTF8STRING(localname)!
+    var elementName: String = parser._internedName(localname)
     var namespaceURI: String? = nil
     var qualifiedName: String? = nil
     if parser.shouldProcessNamespaces {
         namespaceURI = UTF8STRING(URI) ?? ""
-        if let prefix = UTF8STRING(prefix) {
-            qualifiedName = prefix + ":" + elementName
+        if let prefix = prefix {
+            qualifiedName = parser._internedQualifiedName(prefix: prefix, localName: localname)
         } else {
             qualifiedName = elementName
         }
     }
-    else if let prefix = UTF8STRING(prefix) {
-        elementName = prefix + ":" + elementName
+    else if let prefix = prefix {
+        elementName = parser._internedQualifiedName(prefix: prefix, localName: localname)
     }
 
     parser.delegate?.parser(parser, didStartElement: elementName, namespaceURI: namespaceURI, qualifiedName: qualifiedName, attributes: attrDict)
@@ -319,19 +317,19 @@ internal func _NSXMLParserStartElementNs(_ ctx: _CFXMLInterface, localname: Unsa
 internal func _NSXMLParserEndElementNs(_ ctx: _CFXMLInterface , localname: UnsafePointer<UInt8>, prefix: UnsafePointer<UInt8>?, URI: UnsafePointer<UInt8>?) -> Void {
     let parser = ctx.parser
 
-    var elementName: String = UTF8STRING(localname)!
+    var elementName: String = parser._internedName(localname)
     var namespaceURI: String? = nil
     var qualifiedName: String? = nil
     if parser.shouldProcessNamespaces {
         namespaceURI = UTF8STRING(URI) ?? ""
-        if let prefix = UTF8STRING(prefix) {
-            qualifiedName = prefix + ":" + elementName
+        if let prefix = prefix {
+            qualifiedName = parser._internedQualifiedName(prefix: prefix, localName: localname)
         } else {
             qualifiedName = elementName
         }
     }
-    else if let prefix = UTF8STRING(prefix) {
-        elementName = prefix + ":" + elementName
+    else if let prefix = prefix {
+        elementName = parser._internedQualifiedName(prefix: prefix, localName: localname)
     }
 
     parser.delegate?.parser(parser, didEndElement: elementName, namespaceURI: namespaceURI, qualifiedName: qualifiedName)
@@ -409,12 +407,30 @@ open class XMLParser : NSObject {
     internal var _delegateAborted = false
     internal var _url: URL?
     internal var _namespaces = [[String:String]]()
+
+    // libxml2 interns element and attribute names in the parser context's
+    // dictionary, so for the lifetime of a context every occurrence of a name
+    // is reported with the same pointer. These caches map those pointers to
+    // Swift strings so that names aren't decoded again for every event.
+    internal struct _QualifiedNameKey : Hashable {
+        let prefix: UnsafePointer<UInt8>
+        let localName: UnsafePointer<UInt8>
+    }
+    internal static let _nameCacheLimit = 4096
+    internal var _nameCache = [UnsafePointer<UInt8> : String]()
+    internal var _qualifiedNameCache = [_QualifiedNameKey : String]()
     
     // initializes the parser with the specified URL.
     public convenience init?(contentsOf url: URL) {
         setupXMLParsing()
         if url.isFileURL {
-            if let stream = InputStream(url: url) {
+            // Prefer mapping the file: parse() then feeds the mapped pages to
+            // libxml2 in chunks without copying them, and the kernel is free to
+            // evict pages that have already been parsed.
+            if let data = try? Data(contentsOf: url, options: .alwaysMapped) {
+                self.init(data: data)
+                _url = url
+            } else if let stream = InputStream(url: url) {
                 self.init(stream: stream)
                 _url = url
             } else {
@@ -504,80 +520,103 @@ open class XMLParser : NSObject {
     }
 
     internal func parseData(_ data: Data, lastChunkOfData: Bool = false) -> Bool {
+        return data.withUnsafeBytes { (rawBuffer: UnsafeRawBufferPointer) -> Bool in
+            // Feed the data in chunks: libxml2 copies every chunk into its own
+            // input buffer, so handing it a large (possibly mapped) document in
+            // one go would duplicate the whole document in memory.
+            var offset = 0
+            repeat {
+                let count = min(_chunkSize, rawBuffer.count - offset)
+                let isLast = lastChunkOfData && offset + count == rawBuffer.count
+                let chunk = UnsafeRawBufferPointer(rebasing: rawBuffer[offset..<(offset + count)])
+                guard parseBytes(chunk, lastChunkOfData: isLast) else { return false }
+                offset += count
+            } while offset < rawBuffer.count
+            return true
+        }
+    }
+
+    internal func parseBytes(_ bytes: UnsafeRawBufferPointer, lastChunkOfData: Bool = false) -> Bool {
         _CFXMLInterfaceSetStructuredErrorFunc(interface, _structuredErrorFunc)
         defer { _CFXMLInterfaceSetStructuredErrorFunc(interface, nil) }
 
-        let handler: _CFXMLInterfaceSAXHandler? = (delegate != nil ? _handler : nil)
-        let unparsedData: Data
         // If the parser context is nil, we have not received enough bytes to create the push parser
         if _parserContext == nil {
-            // Look at the bomChunk and this data
-            let bomChunk: Data = {
-                guard var bomChunk = _bomChunk else {
-                    return data
-                }
-                bomChunk.append(data)
-                return bomChunk
-            }()
+            // Only the first 4 bytes are needed to detect the encoding. We
+            // only copy into the bomChunk if they are split across chunks.
+            guard _bomChunk != nil || bytes.count < 4 else {
+                return createParserContext(bomBytes: UnsafeRawBufferPointer(rebasing: bytes[..<4])) &&
+                    parseChunk(UnsafeRawBufferPointer(rebasing: bytes[4...]), lastChunkOfData: lastChunkOfData)
+            }
+            var bomChunk = _bomChunk ?? Data()
+            bomChunk.append(contentsOf: bytes)
             // If we have not received 4 bytes, save the bomChunk for next pass
             if bomChunk.count < 4 {
                 _bomChunk = bomChunk
                 return true
             }
-            // Prepare options (substitute entities, recover on errors)
-            var options = _kCFXMLInterfaceRecover | _kCFXMLInterfaceNoEnt
-            if shouldResolveExternalEntities {
-                options |= _kCFXMLInterfaceDTDLoad
-            }
-            if handler == nil {
-                options |= (_kCFXMLInterfaceNoError | _kCFXMLInterfaceNoWarning)
+            _bomChunk = nil
+            return bomChunk.withUnsafeBytes { (rawBuffer: UnsafeRawBufferPointer) -> Bool in
+                return createParserContext(bomBytes: UnsafeRawBufferPointer(rebasing: rawBuffer[..<4])) &&
+                    parseChunk(UnsafeRawBufferPointer(rebasing: rawBuffer[4...]), lastChunkOfData: lastChunkOfData)
             }
+        }
+        return parseChunk(bytes, lastChunkOfData: lastChunkOfData)
+    }
 
-            // Create the push context with the first 4 bytes
-            bomChunk.withUnsafeBytes { (rawBuffer: UnsafeRawBufferPointer) in
-                let bytes = rawBuffer.baseAddress!.assumingMemoryBound(to: CChar.self)
-                _parserContext = _CFXMLInterfaceCreatePushParserCtxt(handler, interface, bytes, 4, nil)
-            }
-            guard _parserContext != nil else {
-                if _parserError == nil {
-                    _parserError = NSError(domain: XMLParser.errorDomain, code: ErrorCode.outOfMemoryError.rawValue)
-                }
-                return false
-            };
-            _CFXMLInterfaceCtxtUseOptions(_parserContext, options)
-            // Prepare the remaining data for parsing
-            let dataRange = bomChunk.indices
-            let unparsed = Range(uncheckedBounds: (dataRange.startIndex.advanced(by: 4), dataRange.endIndex))
-            unparsedData = bomChunk.subdata(in: unparsed)
+    private func createParserContext(bomBytes: UnsafeRawBufferPointer) -> Bool {
+        let handler: _CFXMLInterfaceSAXHandler? = (delegate != nil ? _handler : nil)
+        // Prepare options (substitute entities, recover on errors)
+        var options = _kCFXMLInterfaceRecover | _kCFXMLInterfaceNoEnt
+        if shouldResolveExternalEntities {
+            options |= _kCFXMLInterfaceDTDLoad
         }
-        else {
-            unparsedData = data
+        if handler == nil {
+            options |= (_kCFXMLInterfaceNoError | _kCFXMLInterfaceNoWarning)
         }
 
-        let parseResult = unparsedData.withUnsafeBytes { (rawBuffer: UnsafeRawBufferPointer) -> Int32 in
-            let bytes = rawBuffer.baseAddress!.assumingMemoryBound(to: CChar.self)
-            return _CFXMLInterfaceParseChunk(_parserContext, bytes, Int32(unparsedData.count), lastChunkOfData ? 1 : 0)
+        // Create the push context with the first 4 bytes
+        let bytes = bomBytes.baseAddress!.assumingMemoryBound(to: CChar.self)
+        _parserContext = _CFXMLInterfaceCreatePushParserCtxt(handler, interface, bytes, Int32(bomBytes.count), nil)
+        guard _parserContext != nil else {
+            if _parserError == nil {
+                _parserError = NSError(domain: XMLParser.errorDomain, code: ErrorCode.outOfMemoryError.rawValue)
+            }
+            return false
         }
+        _CFXMLInterfaceCtxtUseOptions(_parserContext, options)
+        // Names from a previous context's dictionary are no longer valid.
+        _nameCache.removeAll()
+        _qualifiedNameCache.removeAll()
+        return true
+    }
 
-        let result = _handleParseResult(parseResult)
-        return result
+    private func parseChunk(_ bytes: UnsafeRawBufferPointer, lastChunkOfData: Bool) -> Bool {
+        guard let baseAddress = bytes.baseAddress else {
+            var empty: CChar = 0
+            return _handleParseResult(_CFXMLInterfaceParseChunk(_parserContext, &empty, 0, lastChunkOfData ? 1 : 0))
+        }
+        let parseResult = _CFXMLInterfaceParseChunk(_parserContext, baseAddress.assumingMemoryBound(to: CChar.self), Int32(bytes.count), lastChunkOfData ? 1 : 0)
+        return _handleParseResult(parseResult)
     }
 
     internal func parseFrom(_ stream : InputStream) -> Bool {
         var result = true
 
-        guard let buffer = malloc(_chunkSize)?.bindMemory(to: UInt8.self, capacity: _chunkSize) else { return false }
-        defer { free(buffer) }
+        // A single buffer is reused for the whole stream and handed to
+        // libxml2 directly.
+        let buffer = UnsafeMutableRawBufferPointer.allocate(byteCount: _chunkSize, alignment: MemoryLayout<UInt8>.alignment)
+        defer { buffer.deallocate() }
+        let bytes = buffer.baseAddress!.assumingMemoryBound(to: UInt8.self)
 
         stream.open()
         defer { stream.close() }
         parseLoop: while result {
-            switch stream.read(buffer, maxLength: _chunkSize) {
+            switch stream.read(bytes, maxLength: _chunkSize) {
             case let len where len > 0:
-                let data = Data(bytesNoCopy: buffer, count: len, deallocator: .none)
-                result = parseData(data)
+                result = parseBytes(UnsafeRawBufferPointer(rebasing: buffer[..<len]))
             case 0:
-                result = parseData(Data(), lastChunkOfData: true)
+                result = parseBytes(UnsafeRawBufferPointer(start: nil, count: 0), lastChunkOfData: true)
                 break parseLoop
             default: // See SR-13516, should be `case ..<0:`
                 result = false
@@ -592,6 +631,31 @@ open class XMLParser : NSObject {
         return result
     }
 
+    /// Returns the Swift string for a name interned in the parser context's dictionary.
+    internal func _internedName(_ name: UnsafePointer<UInt8>) -> String {
+        if let cached = _nameCache[name] {
+            return cached
+        }
+        let string = String(cString: name)
+        if _nameCache.count < XMLParser._nameCacheLimit {
+            _nameCache[name] = string
+        }
+        return string
+    }
+
+    /// Returns `prefix:localName` for names interned in the parser context's dictionary.
+    internal func _internedQualifiedName(prefix: UnsafePointer<UInt8>, localName: UnsafePointer<UInt8>) -> String {
+        let key = _QualifiedNameKey(prefix: prefix, localName: localName)
+        if let cached = _qualifiedNameCache[key] {
+            return cached
+        }
+        let string = _internedName(prefix) + ":" + _internedName(localName)
+        if _qualifiedNameCache.count < XMLParser._nameCacheLimit {
+            _qualifiedNameCache[key] = string
+        }
+        return string
+    }
+
     // called to start the event-driven parse. Returns YES in the event of a successful parse, and NO in case of error.
     open func parse() -> Bool {
         return Self.withCurrentParser(self) {
@@ -52,6 +52,34 @@
 #define NS_CURL_XFERINFOFUNCTION_SUPPORTED 0
 #endif
 
+// 7.43.0 or later
+#if LIBCURL_VERSION_MAJOR > 7 || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR > 43) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR == 43 && LIBCURL_VERSION_PATCH >= 0)
+#define NS_CURL_PIPEWAIT_SUPPORTED 1
+#else
+#define NS_CURL_PIPEWAIT_SUPPORTED 0
+#endif
+
+// 7.45.0 or later
+#if LIBCURL_VERSION_MAJOR > 7 || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR > 45) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR == 45 && LIBCURL_VERSION_PATCH >= 0)
+#define NS_CURL_ACTIVESOCKET_SUPPORTED 1
+#else
+#define NS_CURL_ACTIVESOCKET_SUPPORTED 0
+#endif
+
+// 7.46.0 or later
+#if LIBCURL_VERSION_MAJOR > 7 || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR > 46) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR == 46 && LIBCURL_VERSION_PATCH >= 0)
+#define NS_CURL_STREAM_WEIGHT_SUPPORTED 1
+#else
+#define NS_CURL_STREAM_WEIGHT_SUPPORTED 0
+#endif
+
+// 7.67.0 or later
+#if LIBCURL_VERSION_MAJOR > 7 || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR > 67) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR == 67 && LIBCURL_VERSION_PATCH >= 0)
+#define NS_CURL_MAX_CONCURRENT_STREAMS_SUPPORTED 1
+#else
+#define NS_CURL_MAX_CONCURRENT_STREAMS_SUPPORTED 0
+#endif
+
 FILE* aa = NULL;
 CURL * gcurl = NULL;
 
@@ -156,6 +184,10 @@ CFURLSessionEasyCode CFURLSession_easy_getinfo_charp(CFURLSessionEasyHandle _Non
     return MakeEasyCode(curl_easy_getinfo(curl, info.value, a));
 }
 
+CFURLSessionEasyCode CFURLSession_easy_getinfo_socket(CFURLSessionEasyHandle _Nonnull curl, CFURLSessionInfo info, CFURLSession_socket_t *_Nonnull a) {
+    return MakeEasyCode(curl_easy_getinfo(curl, info.value, a));
+}
+
 CFURLSessionMultiCode CFURLSession_multi_setopt_ptr(CFURLSessionMultiHandle _Nonnull multi_handle, CFURLSessionMultiOption option, void *_Nullable a) {
     return MakeMultiCode(curl_multi_setopt(multi_handle, option.value, a));
 }
@@ -601,6 +633,16 @@ CFURLSessionOption const CFURLSessionOptionXFERINFOFUNCTION = { CURLOPT_XFERINFO
 #else
 CFURLSessionOption const CFURLSessionOptionXFERINFOFUNCTION = { 0 };
 #endif
+#if NS_CURL_PIPEWAIT_SUPPORTED
+CFURLSessionOption const CFURLSessionOptionPIPEWAIT = { CURLOPT_PIPEWAIT };
+#else
+CFURLSessionOption const CFURLSessionOptionPIPEWAIT = { 0 };
+#endif
+#if NS_CURL_STREAM_WEIGHT_SUPPORTED
+CFURLSessionOption const CFURLSessionOptionSTREAM_WEIGHT = { CURLOPT_STREAM_WEIGHT };
+#else
+CFURLSessionOption const CFURLSessionOptionSTREAM_WEIGHT = { 0 };
+#endif
 
 CFURLSessionInfo const CFURLSessionInfoTEXT = { CURLINFO_TEXT };
 CFURLSessionInfo const CFURLSessionInfoHEADER_IN = { CURLINFO_HEADER_IN };
@@ -640,6 +682,11 @@ CFURLSessionInfo const CFURLSessionInfoNUM_CONNECTS = { CURLINFO_NUM_CONNECTS };
 CFURLSessionInfo const CFURLSessionInfoSSL_ENGINES = { CURLINFO_SSL_ENGINES };
 CFURLSessionInfo const CFURLSessionInfoCOOKIELIST = { CURLINFO_COOKIELIST };
 CFURLSessionInfo const CFURLSessionInfoLASTSOCKET = { CURLINFO_LASTSOCKET };
+#if NS_CURL_ACTIVESOCKET_SUPPORTED
+CFURLSessionInfo const CFURLSessionInfoACTIVESOCKET = { CURLINFO_ACTIVESOCKET };
+#else
+CFURLSessionInfo const CFURLSessionInfoACTIVESOCKET = { CURLINFO_NONE };
+#endif
 CFURLSessionInfo const CFURLSessionInfoFTP_ENTRY_PATH = { CURLINFO_FTP_ENTRY_PATH };
 CFURLSessionInfo const CFURLSessionInfoREDIRECT_URL = { CURLINFO_REDIRECT_URL };
 CFURLSessionInfo const CFURLSessionInfoPRIMARY_IP = { CURLINFO_PRIMARY_IP };
@@ -672,6 +719,11 @@ CFURLSessionMultiOption const CFURLSessionMultiOptionMAX_HOST_CONNECTIONS = { CU
 #else
 CFURLSessionMultiOption const CFURLSessionMultiOptionMAX_HOST_CONNECTIONS = { 0 };
 #endif
+#if NS_CURL_MAX_CONCURRENT_STREAMS_SUPPORTED
+CFURLSessionMultiOption const CFURLSessionMultiOptionMAX_CONCURRENT_STREAMS = { CURLMOPT_MAX_CONCURRENT_STREAMS };
+#else
+CFURLSessionMultiOption const CFURLSessionMultiOptionMAX_CONCURRENT_STREAMS = { 0 };
+#endif
 
 CFURLSessionMultiCode const CFURLSessionMultiCodeCALL_MULTI_PERFORM = { CURLM_CALL_MULTI_PERFORM };
 CFURLSessionMultiCode const CFURLSessionMultiCodeOK = { CURLM_OK };
@@ -726,6 +778,7 @@ int const CFURLSessionReadFuncAbort = CURL_READFUNC_ABORT;
 
 
 CFURLSession_socket_t const CFURLSessionSocketTimeout = CURL_SOCKET_TIMEOUT;
+CFURLSession_socket_t const CFURLSessionSocketBad = CURL_SOCKET_BAD;
 
 int const CFURLSessionSeekOk = CURL_SEEKFUNC_OK;
 int const CFURLSessionSeekCantSeek = CURL_SEEKFUNC_CANTSEEK;
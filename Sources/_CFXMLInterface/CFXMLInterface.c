@@ -106,6 +106,7 @@ const CFIndex _kCFXMLNodeCompactEmptyElement = 1 << 2;
 const CFIndex _kCFXMLNodePrettyPrint = 1 << 17;
 const CFIndex _kCFXMLNodeLoadExternalEntitiesNever = 1 << 19;
 const CFIndex _kCFXMLNodeLoadExternalEntitiesAlways = 1 << 14;
+const CFIndex _kCFXMLNodeCompactTree = 1 << 12;
 
 // We define this structure because libxml2's "notation" node does not contain the fields
 // nearly all other libxml2 node fields contain, that we use extensively.
@@ -538,6 +539,19 @@ CFStringRef _Nullable _CFXMLNodeCopyName(_CFXMLNodePtr node) {
     }
 }
 
+bool _CFXMLNodeQualifiedNameEqual(_CFXMLNodePtr node, const char* qualifiedName) {
+    xmlNodePtr xmlNode = (xmlNodePtr)node;
+    xmlChar* qName = _getQName(xmlNode);
+    if (qName == NULL) {
+        return false;
+    }
+    bool result = xmlStrEqual(qName, (const xmlChar*)qualifiedName) ? true : false;
+    if (qName != xmlNode->name) {
+        xmlFree(qName);
+    }
+    return result;
+}
+
 void _CFXMLNodeForceSetName(_CFXMLNodePtr node, const char* _Nullable name) {
     xmlNodePtr xmlNode = (xmlNodePtr)node;
     if (xmlNode->name) xmlFree((xmlChar*) xmlNode->name);
@@ -577,6 +591,29 @@ CFStringRef _CFXMLNodeCopyContent(_CFXMLNodePtr node) {
     }
 }
 
+static void _CFXMLBufferAppendStringValueOfChildren(xmlBufferPtr buffer, xmlNodePtr node) {
+    for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
+        if (child->type == XML_ELEMENT_NODE) {
+            _CFXMLBufferAppendStringValueOfChildren(buffer, child);
+        } else {
+            xmlChar* content = xmlNodeGetContent(child);
+            if (content != NULL) {
+                xmlBufferCat(buffer, content);
+                xmlFree(content);
+            }
+        }
+    }
+}
+
+CFStringRef _CFXMLElementCopyStringValue(_CFXMLNodePtr node) {
+    // Matches concatenating the stringValue of every child, without needing an NSXMLNode for each of them.
+    xmlBufferPtr buffer = xmlBufferCreate();
+    _CFXMLBufferAppendStringValueOfChildren(buffer, node);
+    CFStringRef result = __CFSwiftXMLParserBridgeCF.CFStringCreateWithCString(NULL, (const char*)xmlBufferContent(buffer), kCFStringEncodingUTF8);
+    xmlBufferFree(buffer);
+    return result;
+}
+
 void _CFXMLNodeSetContent(_CFXMLNodePtr node, const unsigned char* _Nullable  content) {
     // So handling set content on XML_ELEMENT_DECL is listed as a TODO !!! in libxml2's source code.
     // that means we have to do it ourselves.
@@ -713,6 +750,14 @@ _CFXMLNodePtr _CFXMLNodeGetFirstChild(_CFXMLNodePtr node) {
     return ((xmlNodePtr)node)->children;
 }
 
+CFIndex _CFXMLNodeGetChildCount(_CFXMLNodePtr node) {
+    CFIndex count = 0;
+    for (xmlNodePtr child = ((xmlNodePtr)node)->children; child != NULL; child = child->next) {
+        count++;
+    }
+    return count;
+}
+
 _CFXMLNodePtr _CFXMLNodeGetLastChild(_CFXMLNodePtr node) {
     return ((xmlNodePtr)node)->last;
 }
@@ -929,23 +974,35 @@ CFStringRef _CFXMLCopyStringWithOptions(_CFXMLNodePtr node, uint32_t options) {
     return result;
 }
 
-CFArrayRef _CFXMLNodesForXPath(_CFXMLNodePtr node, const unsigned char* xpath) {
+static CFArrayRef _Nullable _CFXMLNodesForXPathEvaluation(xmlNodePtr node, xmlXPathCompExprPtr _Nullable compiled, const xmlChar* _Nullable xpath) {
 
-    if (((xmlNodePtr)node)->doc == NULL) {
+    if (node->doc == NULL) {
         return NULL;
     }
     
-    if (((xmlNodePtr)node)->type == XML_DOCUMENT_NODE) {
+    if (node->type == XML_DOCUMENT_NODE) {
         node = ((xmlDocPtr)node)->children;
     }
     
-    xmlXPathContextPtr context = xmlXPathNewContext(((xmlNodePtr)node)->doc);
-    xmlNsPtr ns = ((xmlNodePtr)node)->ns;
+    xmlXPathContextPtr context = xmlXPathNewContext(node->doc);
+    xmlNsPtr ns = node->ns;
     while (ns != NULL) {
         xmlXPathRegisterNs(context, ns->prefix, ns->href);
         ns = ns->next;
     }
-    xmlXPathObjectPtr evalResult = xmlXPathNodeEval(node, xpath, context);
+
+    xmlXPathObjectPtr evalResult;
+    if (compiled != NULL) {
+        context->node = node;
+        evalResult = xmlXPathCompiledEval(compiled, context);
+    } else {
+        evalResult = xmlXPathNodeEval(node, xpath, context);
+    }
+
+    if (evalResult == NULL) {
+        xmlXPathFreeContext(context);
+        return NULL;
+    }
 
     xmlNodeSetPtr nodes = evalResult->nodesetval;
     int count = nodes ? nodes->nodeNr : 0;
@@ -961,6 +1018,35 @@ CFArrayRef _CFXMLNodesForXPath(_CFXMLNodePtr node, const unsigned char* xpath) {
     return results;
 }
 
+CFArrayRef _CFXMLNodesForXPath(_CFXMLNodePtr node, const unsigned char* xpath) {
+    return _CFXMLNodesForXPathEvaluation(node, NULL, xpath);
+}
+
+_CFXMLXPathPtr _Nullable _CFXMLXPathCompile(const unsigned char* xpath) {
+    return xmlXPathCompile(xpath);
+}
+
+void _CFXMLXPathFree(_CFXMLXPathPtr xpath) {
+    xmlXPathFreeCompExpr(xpath);
+}
+
+CFArrayRef _CFXMLNodesForCompiledXPath(_CFXMLNodePtr node, _CFXMLXPathPtr xpath) {
+    // A compiled expression is only read during evaluation; all per-evaluation state lives in the context.
+    return _CFXMLNodesForXPathEvaluation(node, xpath, NULL);
+}
+
+CFStringRef _Nullable _CFXMLCopyXPathStringValueForNode(_CFXMLNodePtr node) {
+    // XPath result sets may contain namespace nodes (xmlNs), which share the type field layout with xmlNode;
+    // xmlXPathCastNodeToString handles both and yields the XPath string-value without touching the node's _private.
+    xmlChar* value = xmlXPathCastNodeToString(node);
+    if (value == NULL) {
+        return NULL;
+    }
+    CFStringRef result = __CFSwiftXMLParserBridgeCF.CFStringCreateWithCString(NULL, (const char*)value, kCFStringEncodingUTF8);
+    xmlFree(value);
+    return result;
+}
+
 CFStringRef _Nullable _CFXMLCopyPathForNode(_CFXMLNodePtr node) {
     xmlChar* path = xmlGetNodePath(node);
     CFStringRef result = __CFSwiftXMLParserBridgeCF.CFStringCreateWithCString(NULL, (const char*)path, kCFStringEncodingUTF8);
@@ -1036,6 +1122,11 @@ _CFXMLNodePtr _CFXMLNodeHasProp(_CFXMLNodePtr node, const unsigned char* propert
     return result;
 }
 
+bool _CFXMLDocIsCompactTree(_CFXMLDocPtr doc) {
+    // libxml2 records the parser options on the document, so compactness travels with the tree itself.
+    return (((xmlDocPtr)doc)->parseFlags & XML_PARSE_COMPACT) != 0;
+}
+
 _CFXMLDocPtr _CFXMLDocPtrFromDataWithOptions(CFDataRef data, unsigned int options) {
     uint32_t xmlOptions = 0;
 
@@ -1053,6 +1144,10 @@ _CFXMLDocPtr _CFXMLDocPtrFromDataWithOptions(CFDataRef data, unsigned int option
         xmlOptions |= XML_PARSE_DTDLOAD;
     }
     
+    if (options & _kCFXMLNodeCompactTree) {
+        xmlOptions |= XML_PARSE_COMPACT;
+    }
+    
     xmlOptions |= XML_PARSE_RECOVER;
     xmlOptions |= XML_PARSE_NSCLEAN;
     
@@ -142,6 +142,7 @@ typedef void* _CFXMLNamespacePtr;
 typedef void* _CFXMLEntityPtr;
 typedef void* _CFXMLDTDPtr;
 typedef void* _CFXMLDTDNodePtr;
+typedef void* _CFXMLXPathPtr;
 
 _CFXMLNodePtr _CFXMLNewNode(_CFXMLNamespacePtr _Nullable name_space, const char* name);
 _CFXMLNodePtr _CFXMLCopyNode(_CFXMLNodePtr node, bool recursive);
@@ -163,11 +164,14 @@ CFStringRef _Nullable _CFXMLNodeCopyName(_CFXMLNodePtr node);
 void _CFXMLNodeForceSetName(_CFXMLNodePtr node, const char* _Nullable name);
 void _CFXMLNodeSetName(_CFXMLNodePtr node, const char* name);
 bool _CFXMLNodeNameEqual(_CFXMLNodePtr node, const char* name);
+bool _CFXMLNodeQualifiedNameEqual(_CFXMLNodePtr node, const char* qualifiedName);
 CFStringRef _Nullable _CFXMLNodeCopyContent(_CFXMLNodePtr node);
+CF_RETURNS_RETAINED CFStringRef _CFXMLElementCopyStringValue(_CFXMLNodePtr node);
 void _CFXMLNodeSetContent(_CFXMLNodePtr node,  const unsigned char* _Nullable content);
 void _CFXMLUnlinkNode(_CFXMLNodePtr node);
 
 _CFXMLNodePtr _Nullable _CFXMLNodeGetFirstChild(_CFXMLNodePtr node);
+CFIndex _CFXMLNodeGetChildCount(_CFXMLNodePtr node);
 _CFXMLNodePtr _Nullable _CFXMLNodeGetLastChild(_CFXMLNodePtr node);
 _CFXMLNodePtr _Nullable _CFXMLNodeGetNextSibling(_CFXMLNodePtr node);
 _CFXMLNodePtr _Nullable _CFXMLNodeGetPrevSibling(_CFXMLNodePtr node);
@@ -203,12 +207,17 @@ CFStringRef _Nullable _CFXMLCopyEntityContent(_CFXMLEntityPtr entity);
 CFStringRef _CFXMLCopyStringWithOptions(_CFXMLNodePtr node, uint32_t options);
 
 CF_RETURNS_RETAINED CFArrayRef _Nullable _CFXMLNodesForXPath(_CFXMLNodePtr node, const unsigned char* xpath);
+_CFXMLXPathPtr _Nullable _CFXMLXPathCompile(const unsigned char* xpath);
+void _CFXMLXPathFree(_CFXMLXPathPtr xpath);
+CF_RETURNS_RETAINED CFArrayRef _Nullable _CFXMLNodesForCompiledXPath(_CFXMLNodePtr node, _CFXMLXPathPtr xpath);
+CF_RETURNS_RETAINED CFStringRef _Nullable _CFXMLCopyXPathStringValueForNode(_CFXMLNodePtr node);
 CFStringRef _Nullable _CFXMLCopyPathForNode(_CFXMLNodePtr node);
 
 void _CFXMLCompletePropURI(_CFXMLNodePtr propertyNode, _CFXMLNodePtr node);
 _CFXMLNodePtr _Nullable _CFXMLNodeHasProp(_CFXMLNodePtr node, const unsigned char* propertyName, const unsigned char* _Nullable uri);
 
 _CFXMLDocPtr _CFXMLDocPtrFromDataWithOptions(CFDataRef data, unsigned int options);
+bool _CFXMLDocIsCompactTree(_CFXMLDocPtr doc);
 
 CFStringRef _Nullable _CFXMLNodeCopyLocalName(_CFXMLNodePtr node);
 CFStringRef _Nullable _CFXMLNodeCopyPrefix(_CFXMLNodePtr node);
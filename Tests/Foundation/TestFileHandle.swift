@@ -625,4 +625,102 @@ class TestFileHandle : XCTestCase {
 #endif
         XCTAssertNoThrow(try fh.synchronize())
     }
+
+    func test_asyncIO() async throws {
+        let url = createTemporaryFile()
+        let handle = try FileHandle(forUpdating: url)
+        defer { try? handle.close() }
+
+        // Large enough to need several transfers, both through registered buffers and around them.
+        var expected = Data()
+        for index in 0..<40 {
+            let chunk = Data(repeating: UInt8(index), count: index * 7919)
+            try await handle.asyncIO.write(contentsOf: chunk)
+            expected.append(chunk)
+        }
+        try await handle.asyncIO.synchronize()
+        try await handle.asyncIO.synchronize(dataOnly: true)
+        XCTAssertEqual(try handle.offset(), UInt64(expected.count))
+
+        try handle.seek(toOffset: 0)
+        let head = try await handle.asyncIO.read(upToCount: 1000)
+        XCTAssertEqual(head, expected.prefix(1000))
+        let rest = try await handle.asyncIO.readToEnd()
+        XCTAssertEqual(rest, expected.dropFirst(1000))
+        let atEnd = try await handle.asyncIO.read(upToCount: 10)
+        XCTAssertNil(atEnd)
+
+        // Many handles at once, as the operations of all of them share one ring.
+        let urls = (0..<32).map { createTemporaryFile(containing: Data("file \($0)".utf8)) }
+        let contents = try await withThrowingTaskGroup(of: (Int, Data?).self) { group in
+            for (index, url) in urls.enumerated() {
+                group.addTask {
+                    let handle = try FileHandle(forReadingFrom: url)
+                    defer { try? handle.close() }
+                    return (index, try await handle.asyncIO.readToEnd())
+                }
+            }
+            var contents = [Int : Data]()
+            for try await (index, data) in group {
+                contents[index] = data
+            }
+            return contents
+        }
+        for index in urls.indices {
+            XCTAssertEqual(contents[index], Data("file \(index)".utf8))
+        }
+    }
+
+#if NS_FOUNDATION_ALLOWS_TESTABLE_IMPORT && !os(Windows)
+    func test_mappedReads() throws {
+        let contents = Data((0..<(512 * 1024 + 123)).map { UInt8(truncatingIfNeeded: $0 &* 7) })
+        let url = createTemporaryFile(containing: contents)
+
+        for options: NSData.ReadingOptions in [[], .mappedIfSafe, .alwaysMapped] {
+            let data = try NSData(contentsOf: url, options: options)
+            XCTAssertEqual(Data(referencing: data), contents, "\(options)")
+        }
+
+        // Mapped reads start at the current position and move it like a read would.
+        let handle = try FileHandle(forReadingFrom: url)
+        defer { try? handle.close() }
+        try handle.seek(toOffset: 5000)
+        let tail = try handle._readDataOfLength(Int.max, untilEOF: true, options: .mappedIfSafe).toData()
+        XCTAssertEqual(tail, contents.dropFirst(5000))
+        XCTAssertEqual(try handle.offset(), UInt64(contents.count))
+        XCTAssertEqual(try handle.readToEnd(), nil)
+    }
+#endif
+
+#if !os(Windows)
+    // Compares buffered and mapped reads of whole files across sizes, to show where mapping starts to pay off; see
+    // skipUnlessBenchmarking(). Sizes above 64 MB are only run when FOUNDATION_BENCHMARK_LARGE_FILES is also set.
+    func test_benchmarkFileReadAcrossSizes() throws {
+        try skipUnlessBenchmarking()
+        var sizes = [4 << 10, 64 << 10, 1 << 20, 16 << 20, 64 << 20]
+        if ProcessInfo.processInfo.environment["FOUNDATION_BENCHMARK_LARGE_FILES"] != nil {
+            sizes += [256 << 20, 1 << 30, 4 << 30]
+        }
+        for size in sizes {
+            let url = createTemporaryFile()
+            defer { try? FileManager.default.removeItem(at: url) }
+            let writer = try FileHandle(forWritingTo: url)
+            try writer.write(contentsOf: Data(repeating: 0xA5, count: min(size, 1 << 20)))
+            try writer.truncate(atOffset: UInt64(size))
+            try writer.close()
+
+            // Enough reads of small files to rise above the clock's resolution, and a single read of the largest.
+            let iterations = max(1, min(1000, (256 << 20) / size))
+            var milliseconds: [Double] = []
+            for options: NSData.ReadingOptions in [[], .mappedIfSafe] {
+                let start = DispatchTime.now().uptimeNanoseconds
+                for _ in 0..<iterations {
+                    XCTAssertEqual(try NSData(contentsOf: url, options: options).length, size)
+                }
+                milliseconds.append(Double(DispatchTime.now().uptimeNanoseconds - start) / Double(iterations) / 1_000_000)
+            }
+            print("read \(size) bytes: buffered \(String(format: "%.3f", milliseconds[0])) ms, mapped \(String(format: "%.3f", milliseconds[1])) ms")
+        }
+    }
+#endif
 }
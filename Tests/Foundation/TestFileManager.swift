@@ -627,6 +627,79 @@ class TestFileManager : XCTestCase {
         XCTAssertEqual(contents, [subdirectory])
     }
 
+    func test_enumerateDirectoryInBatches() throws {
+        let fm = FileManager.default
+
+        try withTemporaryDirectory { root, _ in
+            var expected: [String: Int] = [:]
+            for directory in 0..<8 {
+                let subdirectory = root.appendingPathComponent("dir\(directory)/nested", isDirectory: true)
+                try fm.createDirectory(at: subdirectory, withIntermediateDirectories: true, attributes: nil)
+                expected["dir\(directory)"] = -1
+                expected["dir\(directory)/nested"] = -1
+                for file in 0..<20 {
+                    let relativePath = "dir\(directory)/nested/file\(file)"
+                    XCTAssertTrue(fm.createFile(atPath: root.appendingPathComponent(relativePath).path, contents: Data(count: file), attributes: nil))
+                    expected[relativePath] = file
+                }
+            }
+            XCTAssertTrue(fm.createFile(atPath: root.appendingPathComponent(".hidden").path, contents: Data(), attributes: nil))
+
+            var found: [String: Int] = [:]
+            var batches = 0
+            fm.enumerateDirectory(at: root, includingPropertiesForKeys: [.isDirectoryKey, .fileSizeKey, .nameKey], options: [.skipsHiddenFiles], batchSize: 16, maximumConcurrency: 4, errorHandler: { url, error in
+                XCTFail("Unexpected error at \(url): \(error)")
+                return true
+            }) { entries in
+                XCTAssertLessThanOrEqual(entries.count, 16)
+                batches += 1
+                for entry in entries {
+                    let relativePath = String(entry.url.path.dropFirst(root.path.count + 1))
+                    XCTAssertNil(found[relativePath], "\(relativePath) reported twice")
+                    XCTAssertEqual(entry.resourceValues.name, entry.url.lastPathComponent)
+                    if entry.resourceValues.isDirectory == true {
+                        found[relativePath] = -1
+                    } else {
+                        found[relativePath] = entry.resourceValues.fileSize
+                    }
+                }
+                return true
+            }
+            XCTAssertEqual(found, expected)
+            XCTAssertGreaterThan(batches, 1)
+
+            // Without .skipsHiddenFiles, a dot-file is reported as hidden.
+            var hidden: [String: Bool] = [:]
+            fm.enumerateDirectory(at: root, includingPropertiesForKeys: [.isHiddenKey], options: [.skipsSubdirectoryDescendants]) { entries in
+                for entry in entries {
+                    hidden[entry.url.lastPathComponent] = entry.resourceValues.isHidden
+                }
+                return true
+            }
+            XCTAssertEqual(hidden[".hidden"], true)
+            XCTAssertEqual(hidden["dir0"], false)
+
+            // Returning false stops the enumeration.
+            var calls = 0
+            fm.enumerateDirectory(at: root, includingPropertiesForKeys: nil, batchSize: 1) { _ in
+                calls += 1
+                return false
+            }
+            XCTAssertEqual(calls, 1)
+
+            // A missing root is reported to the error handler.
+            var errorURL: URL?
+            fm.enumerateDirectory(at: root.appendingPathComponent("missing"), includingPropertiesForKeys: nil, errorHandler: { url, _ in
+                errorURL = url
+                return true
+            }) { _ in
+                XCTFail("Nothing should be enumerated")
+                return true
+            }
+            XCTAssertEqual(errorURL?.lastPathComponent, "missing")
+        }
+    }
+
     func test_subpathsOfDirectoryAtPath() {
         let fm = FileManager.default
         let path = NSTemporaryDirectory() + "testdir"
@@ -1196,6 +1269,79 @@ class TestFileManager : XCTestCase {
         try testCopy()
     }
     
+#if !os(Windows) && !DARWIN_COMPATIBILITY_TESTS
+    func test_copyItemReportingStatistics() throws {
+        let fm = FileManager.default
+        try withTemporaryDirectory { tmpDir, _ in
+            let source = tmpDir.appendingPathComponent("source")
+            let destination = tmpDir.appendingPathComponent("destination")
+            for directory in 0..<4 {
+                let subdirectory = source.appendingPathComponent("dir\(directory)/nested")
+                try fm.createDirectory(at: subdirectory, withIntermediateDirectories: true)
+                for file in 0..<8 {
+                    let contents = Data((0..<(file * 4096 + directory)).map { UInt8(truncatingIfNeeded: $0 &* 31) })
+                    try contents.write(to: subdirectory.appendingPathComponent("file\(file)"))
+                }
+            }
+            try fm.createSymbolicLink(atPath: source.appendingPathComponent("link").path, withDestinationPath: "dir0/nested/file1")
+            try fm.setAttributes([.posixPermissions: 0o750], ofItemAtPath: source.appendingPathComponent("dir1").path)
+            let oldDate = Date(timeIntervalSince1970: 1_000_000_000)
+            try fm.setAttributes([.modificationDate: oldDate], ofItemAtPath: source.appendingPathComponent("dir2/nested/file3").path)
+
+            // A file with a hole in the middle.
+            let sparse = source.appendingPathComponent("sparse")
+            XCTAssertTrue(fm.createFile(atPath: sparse.path, contents: Data(repeating: 1, count: 4096)))
+            let handle = try FileHandle(forWritingTo: sparse)
+            try handle.seek(toOffset: 8 * 1024 * 1024)
+            try handle.write(contentsOf: Data(repeating: 2, count: 4096))
+            try handle.close()
+
+            let statistics = try fm.copyItem(at: source, to: destination, maximumConcurrency: 4)
+            XCTAssertEqual(statistics.regularFiles, 33)
+            XCTAssertEqual(statistics.directories, 9)
+            XCTAssertEqual(statistics.symbolicLinks, 1)
+            XCTAssertEqual(statistics.otherItems, 0)
+            XCTAssertEqual(statistics.filesByMethod.values.reduce(0, +), statistics.regularFiles)
+            XCTAssertEqual(statistics.bytesCopied + statistics.bytesSkippedInHoles, Int64(8 * 1024 * 1024 + 4096) + Int64((0..<4).reduce(0) { total, directory in total + (0..<8).reduce(0) { $0 + $1 * 4096 + directory } }))
+
+            for path in try fm.subpathsOfDirectory(atPath: source.path) {
+                let original = source.appendingPathComponent(path).path
+                let copy = destination.appendingPathComponent(path).path
+                let type = try fm.attributesOfItem(atPath: original)[.type] as? FileAttributeType
+                XCTAssertEqual(try fm.attributesOfItem(atPath: copy)[.type] as? FileAttributeType, type, path)
+                XCTAssertEqual(try fm.attributesOfItem(atPath: copy)[.posixPermissions] as? NSNumber, try fm.attributesOfItem(atPath: original)[.posixPermissions] as? NSNumber, path)
+                if type == .typeRegular {
+                    XCTAssertTrue(fm.contentsEqual(atPath: original, andPath: copy), path)
+                }
+            }
+            XCTAssertEqual(try fm.destinationOfSymbolicLink(atPath: destination.appendingPathComponent("link").path), "dir0/nested/file1")
+            // Set last, since adding its contents changed the directory's modification time.
+            try fm.setAttributes([.modificationDate: oldDate], ofItemAtPath: source.appendingPathComponent("dir2").path)
+            let withDates = tmpDir.appendingPathComponent("with-dates")
+            try fm.copyItem(at: source, to: withDates, maximumConcurrency: 4)
+            for path in ["dir2", "dir2/nested/file3"] {
+                let copy = try fm.attributesOfItem(atPath: withDates.appendingPathComponent(path).path)
+                XCTAssertEqual((copy[.modificationDate] as? Date)?.timeIntervalSince1970, oldDate.timeIntervalSince1970, path)
+                XCTAssertEqual(copy[.ownerAccountID] as? NSNumber, try fm.attributesOfItem(atPath: source.appendingPathComponent(path).path)[.ownerAccountID] as? NSNumber, path)
+            }
+
+            // A directory cannot be copied into its own subtree.
+            let inside = source.appendingPathComponent("dir0/inside")
+            XCTAssertThrowsError(try fm.copyItem(at: source, to: inside, maximumConcurrency: 4))
+            XCTAssertFalse(fm.fileExists(atPath: inside.path))
+
+            XCTAssertThrowsError(try fm.copyItem(at: source, to: destination, maximumConcurrency: 4)) {
+                XCTAssertEqual(($0 as? CocoaError)?.code, .fileWriteFileExists)
+            }
+
+            let single = try fm.copyItem(atPath: sparse.path, toPath: tmpDir.appendingPathComponent("sparse-copy").path, maximumConcurrency: 1)
+            XCTAssertEqual(single.regularFiles, 1)
+            XCTAssertEqual(single.directories, 0)
+            XCTAssertEqual(single.filesByMethod.count, 1)
+        }
+    }
+#endif
+    
 #if !DEPLOYMENT_RUNTIME_OBJC && !os(Android) // XDG tests require swift-corelibs-foundation
     
     // This test below is a black box test, and does not require @testable import.
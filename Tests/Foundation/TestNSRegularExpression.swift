@@ -387,4 +387,48 @@ class TestNSRegularExpression : XCTestCase {
         }
     }
 
+    func test_concurrentMatchesReuseMatchers() throws {
+        let regex = try NSRegularExpression(pattern: "([a-z]+)@([a-z]+)\\.com")
+        let string = "contact alice@example.com or bob@example.com for details"
+        let iterations = 64
+        DispatchQueue.concurrentPerform(iterations: iterations) { _ in
+            for _ in 0..<100 {
+                let matches = regex.matches(in: string, range: NSRange(location: 0, length: string.utf16.count))
+                XCTAssertEqual(matches.count, 2)
+                XCTAssertEqual(matches.last?.range(at: 1), NSRange(location: 29, length: 3))
+            }
+        }
+
+        let statistics = regex._matcherStatistics
+        XCTAssertEqual(statistics.clones + statistics.reuses, iterations * 100)
+        // Each thread clones at most a few times; everything else reuses a pooled matcher.
+        XCTAssertLessThan(statistics.clones, iterations * 10)
+    }
+
+    func test_simplePatterns() throws {
+        func ranges(_ pattern: String, in string: String, options: NSRegularExpression.Options = []) throws -> [NSRange] {
+            let regex = try NSRegularExpression(pattern: pattern, options: options)
+            return regex.matches(in: string, range: NSRange(location: 0, length: string.utf16.count)).map { $0.range }
+        }
+        let request = "GET /index.html HEAD 1234 x-y"
+        XCTAssertEqual(try ranges("HEAD", in: request), [NSRange(location: 16, length: 4)])
+        XCTAssertEqual(try ranges("index\\.html", in: request), [NSRange(location: 5, length: 10)])
+        XCTAssertEqual(try ranges("POST|HEAD|GET", in: request), [NSRange(location: 0, length: 3), NSRange(location: 16, length: 4)])
+        XCTAssertEqual(try ranges("ab|abcd", in: "abcd"), [NSRange(location: 0, length: 2)])
+        XCTAssertEqual(try ranges("[0-9]+", in: request), [NSRange(location: 21, length: 4)])
+        XCTAssertEqual(try ranges("\\d", in: "a1b2"), [NSRange(location: 1, length: 1), NSRange(location: 3, length: 1)])
+        XCTAssertEqual(try ranges("[x-]+", in: request), [NSRange(location: 26, length: 2)])
+        XCTAssertEqual(try ranges(".", in: "a.b", options: .ignoreMetacharacters), [NSRange(location: 1, length: 1)])
+
+        // Strings that are not ASCII are matched by ICU, with UTF-16 offsets.
+        XCTAssertEqual(try ranges("HEAD", in: "café HEAD"), [NSRange(location: 5, length: 4)])
+        XCTAssertEqual(try ranges("[a-z]+", in: "café"), [NSRange(location: 0, length: 3)])
+        // Options that change how literals match are handled by ICU.
+        XCTAssertEqual(try ranges("head", in: request, options: .caseInsensitive), [NSRange(location: 16, length: 4)])
+
+        let regex = try NSRegularExpression(pattern: "HEAD")
+        XCTAssertEqual(regex.firstMatch(in: request, range: NSRange(location: 17, length: 12))?.range, nil)
+        XCTAssertEqual(regex.rangeOfFirstMatch(in: request, range: NSRange(location: 10, length: 12)), NSRange(location: 16, length: 4))
+        XCTAssertEqual(regex.stringByReplacingMatches(in: request, range: NSRange(location: 0, length: request.utf16.count), withTemplate: "PUT"), "GET /index.html PUT 1234 x-y")
+    }
 }
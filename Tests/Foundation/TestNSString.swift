@@ -7,6 +7,16 @@
 // See http://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
 //
 
+#if NS_FOUNDATION_ALLOWS_TESTABLE_IMPORT
+    #if canImport(SwiftFoundation) && !DEPLOYMENT_RUNTIME_OBJC
+        @testable import SwiftFoundation
+    #else
+        @testable import Foundation
+    #endif
+#endif
+
+import CoreFoundation
+
 #if os(macOS) || os(iOS)
 internal let kCFStringEncodingMacRoman =  CFStringBuiltInEncodings.macRoman.rawValue
 internal let kCFStringEncodingWindowsLatin1 =  CFStringBuiltInEncodings.windowsLatin1.rawValue
@@ -535,6 +545,78 @@ class TestNSString: LoopbackServerTest {
         XCTAssertEqual(NSString(stringLiteral: "жжж").capitalized, "Жжж")
     }
 
+    func test_asciiCaseMapping() {
+        // Every length around the word size, with letters at the edges and a non-ASCII tail
+        let alphabet = Array("aBcDeFgHiJkLmNoPqRsTuVwXyZ @[`{09'.")
+        for length in 0..<40 {
+            let ascii = String((0..<length).map { alphabet[$0 % alphabet.count] })
+            for string in [ascii, ascii + "É", "É" + ascii] {
+                XCTAssertEqual(NSString(string: string).uppercased, string.uppercased())
+                XCTAssertEqual(NSString(string: string).lowercased, string.lowercased())
+                XCTAssertEqual(NSString(string: string).caseInsensitiveCompare(string.uppercased()), .orderedSame)
+                XCTAssertEqual(NSString(string: string).caseInsensitiveCompare(string.lowercased() + "a"), .orderedAscending)
+            }
+        }
+        XCTAssertEqual(NSString(string: "content-type: TEXT/HTML; CHARSET=UTF-8").capitalized, "Content-Type: Text/Html; Charset=Utf-8")
+        XCTAssertEqual(NSString(string: "HTTPHEADERS don't SHOUT").capitalized, "Httpheaders Don't Shout")
+        XCTAssertEqual(NSString(string: "ÉCOLE normale SUPÉRIEURE").capitalized, "École Normale Supérieure")
+        XCTAssertEqual(NSString(string: "X-Forwarded-For-Something").caseInsensitiveCompare("x-forwarded-for-somethinG"), .orderedSame)
+        XCTAssertEqual(NSString(string: "X-Forwarded-For-Something").caseInsensitiveCompare("x-forwarded-for-somethinH"), .orderedAscending)
+        XCTAssertEqual(NSString(string: "X-Forwarded-Fos-Something").caseInsensitiveCompare("x-forwarded-for-something"), .orderedDescending)
+    }
+
+#if !DARWIN_COMPATIBILITY_TESTS
+    func test_caseInsensitiveDictionaryKeys() {
+        func eightBit(_ string: String) -> CFString {
+            let bytes = Array(string.utf8)
+            return CFStringCreateWithBytes(nil, bytes, bytes.count, CFStringBuiltInEncodings.ASCII.rawValue, false)
+        }
+        // A string created from ASCII characters is stored in eight bits unless it keeps the caller's buffer.
+        func utf16(_ string: String) -> CFString {
+            let characters = malloc(2 * string.utf16.count)!.bindMemory(to: UniChar.self, capacity: string.utf16.count)
+            _ = UnsafeMutableBufferPointer(start: characters, count: string.utf16.count).initialize(from: string.utf16)
+            return CFStringCreateWithCharactersNoCopy(nil, characters, string.utf16.count, kCFAllocatorMalloc)
+        }
+        func key(_ string: CFString) -> UnsafeRawPointer {
+            return UnsafeRawPointer(Unmanaged.passUnretained(string).toOpaque())
+        }
+
+        let pairs: [(CFString, CFString)] = [
+            (eightBit("Content-Type"), eightBit("content-type")),
+            (eightBit("Content-Type"), utf16("CONTENT-TYPE")),
+            (utf16("Content-Type"), utf16("content-type")),
+            (eightBit("STRASSE"), utf16("straße")),
+            (utf16("STRASSE"), utf16("straße")),
+        ]
+        XCTAssertNil(CFStringGetCharactersPtr(eightBit("Content-Type")))
+        XCTAssertNotNil(CFStringGetCharactersPtr(utf16("Content-Type")))
+
+        var keyCallBacks = _kCFCaseInsensitiveStringDictionaryKeyCallBacks
+        for (first, second) in pairs {
+            XCTAssertEqual(_CFStringHashCaseInsensitive(first), _CFStringHashCaseInsensitive(second), "\(first) and \(second)")
+            XCTAssertTrue(_CFStringEqualCaseInsensitive(first, second), "\(first) and \(second)")
+
+            let dictionary = CFDictionaryCreateMutable(nil, 0, &keyCallBacks, nil)!
+            CFDictionarySetValue(dictionary, key(first), UnsafeRawPointer(bitPattern: 1))
+            CFDictionarySetValue(dictionary, key(second), UnsafeRawPointer(bitPattern: 2))
+            XCTAssertEqual(CFDictionaryGetCount(dictionary), 1, "\(first) and \(second)")
+            XCTAssertEqual(CFDictionaryGetValue(dictionary, key(first)), UnsafeRawPointer(bitPattern: 2))
+        }
+
+        let contentType = eightBit("Content-Type")
+        let contentLength = utf16("Content-Length")
+        let truncated = eightBit("Content-Typ")
+        let shouted = utf16("CONTENT-LENGTH")
+        let dictionary = CFDictionaryCreateMutable(nil, 0, &keyCallBacks, nil)!
+        CFDictionarySetValue(dictionary, key(contentType), UnsafeRawPointer(bitPattern: 1))
+        CFDictionarySetValue(dictionary, key(contentLength), UnsafeRawPointer(bitPattern: 2))
+        XCTAssertEqual(CFDictionaryGetCount(dictionary), 2)
+        XCTAssertNil(CFDictionaryGetValue(dictionary, key(truncated)))
+        XCTAssertEqual(CFDictionaryGetValue(dictionary, key(shouted)), UnsafeRawPointer(bitPattern: 2))
+        withExtendedLifetime((contentType, contentLength, truncated, shouted)) {}
+    }
+#endif
+
     func test_longLongValue() {
         let string1: NSString = "123"
         XCTAssertEqual(string1.longLongValue, 123)
@@ -1768,4 +1850,280 @@ class TestNSString: LoopbackServerTest {
         let producedData = nativeString?.data(using: .windowsCP1252)
         XCTAssertEqual(producedData, cp1252Data)
     }
+
+    func test_collationKey() {
+        let locale = Locale(identifier: "en_US")
+        func key(_ string: String, _ options: String.CompareOptions = [], in other: Locale? = nil) -> Data {
+            guard let key = string.collationKey(options: options, locale: other ?? locale) else {
+                XCTFail("No collation key for \(string)")
+                return Data()
+            }
+            return key
+        }
+
+        XCTAssertTrue(key("apple").lexicographicallyPrecedes(key("Banana")))
+        XCTAssertTrue(key("file2", .numeric).lexicographicallyPrecedes(key("file10", .numeric)))
+        XCTAssertTrue(key("file10").lexicographicallyPrecedes(key("file2")))
+        XCTAssertEqual(key("Resume", .caseInsensitive), key("resume", .caseInsensitive))
+        XCTAssertNotEqual(key("Resume"), key("resume"))
+        XCTAssertEqual(key("résumé", .diacriticInsensitive), key("resume", .diacriticInsensitive))
+        // The empty string still has a key, made of the separators between the collation levels, and it sorts first.
+        XCTAssertFalse(key("").isEmpty)
+        XCTAssertTrue(key("").lexicographicallyPrecedes(key("a")))
+
+        // Long strings outgrow the initial key buffer.
+        let long = String(repeating: "ж", count: 1000)
+        XCTAssertTrue(key(long).lexicographicallyPrecedes(key(long + "a")))
+
+        // Keys agree with comparing in the same locale, including across the thread's cached collators.
+        let words = ["zebra", "Äpfel", "apple", "Zoo", "file10", "file2", "émigré", "emigre"]
+        let sorted = words.sorted { key($0, .caseInsensitive).lexicographicallyPrecedes(key($1, .caseInsensitive)) }
+        for (lhs, rhs) in zip(sorted, sorted.dropFirst()) {
+            XCTAssertNotEqual(lhs.compare(rhs, options: .caseInsensitive, locale: locale), .orderedDescending, "\(lhs) should not sort after \(rhs)")
+        }
+
+        // Swedish sorts "Ä" after "Z"; alternating locales must not mix up the cached collators.
+        let swedish = Locale(identifier: "sv_SE")
+        for _ in 0..<3 {
+            XCTAssertTrue(key("Äpfel").lexicographicallyPrecedes(key("Zoo")))
+            XCTAssertTrue(key("Zoo", in: swedish).lexicographicallyPrecedes(key("Äpfel", in: swedish)))
+            XCTAssertEqual("Äpfel".compare("Zoo", locale: locale), .orderedAscending)
+            XCTAssertEqual("Äpfel".compare("Zoo", locale: swedish), .orderedDescending)
+        }
+    }
+
+    func test_literalSearch() {
+        // A long haystack exercises several of the windows a Swift-backed string is searched in.
+        let filler = String(repeating: "abcab", count: 300)
+        let text = "needle" + filler + "ab€needle" + filler + "needle"
+        let utf16 = Array(text.utf16)
+        let strings: [NSString] = [
+            NSString(string: text),
+            utf16.withUnsafeBufferPointer { NSString(characters: $0.baseAddress!, length: $0.count) },
+        ]
+        let asciiText = "needle" + filler + "needle"
+        let ascii = asciiText.data(using: .ascii)!.withUnsafeBytes {
+            NSString(bytes: $0.baseAddress!, length: $0.count, encoding: String.Encoding.ascii.rawValue)!
+        }
+
+        for string in strings {
+            let length = string.length
+            XCTAssertEqual(string.range(of: "needle", options: .literal), NSRange(location: 0, length: 6))
+            XCTAssertEqual(string.range(of: "needle", options: [.literal, .backwards]), NSRange(location: length - 6, length: 6))
+            XCTAssertEqual(string.range(of: "€needle", options: .literal), NSRange(location: 6 + 1500 + 2, length: 7))
+            XCTAssertEqual(string.range(of: "needle", options: [.literal, .anchored, .backwards]), NSRange(location: length - 6, length: 6))
+            XCTAssertEqual(string.range(of: "eedle", options: [.literal, .anchored]).location, NSNotFound)
+            XCTAssertEqual(string.range(of: "needle", options: .literal, range: NSRange(location: 1, length: 1500)).location, NSNotFound)
+            XCTAssertEqual(string.range(of: "cabx", options: .literal).location, NSNotFound)
+            XCTAssertEqual(string.components(separatedBy: "needle").count, 4)
+            XCTAssertEqual(string.replacingOccurrences(of: "needle", with: "pin", options: .literal, range: NSRange(location: 0, length: length)), "pin" + filler + "ab€pin" + filler + "pin")
+            XCTAssertEqual(string.replacingOccurrences(of: "abcab", with: "", options: [.literal, .backwards], range: NSRange(location: 0, length: length)), "needleab€needleneedle")
+        }
+
+        XCTAssertEqual(ascii.range(of: "needle"), NSRange(location: 0, length: 6))
+        XCTAssertEqual(ascii.range(of: "needle", options: .backwards), NSRange(location: ascii.length - 6, length: 6))
+        XCTAssertEqual(ascii.range(of: "NEEDLE", options: .caseInsensitive), NSRange(location: 0, length: 6))
+        XCTAssertEqual(ascii.components(separatedBy: "b").count, 601)
+        XCTAssertEqual("aaaa".replacingOccurrences(of: "aa", with: "b"), "bb")
+        XCTAssertEqual("aaaaa".components(separatedBy: "aa"), ["", "", "a"])
+    }
+
+    func test_characterSetScanning() {
+        // Long runs switch the scan over to its Latin-1 table; the surrogate pairs must still be tested as whole characters.
+        let spaces = String(repeating: " \t", count: 100)
+        let text = spaces + "😀word😀" + spaces
+        let utf16 = Array(text.utf16)
+        let strings: [NSString] = [
+            NSString(string: text),
+            utf16.withUnsafeBufferPointer { NSString(characters: $0.baseAddress!, length: $0.count) },
+        ]
+        let emoji = CharacterSet(charactersIn: "😀")
+
+        for string in strings {
+            let length = string.length
+            XCTAssertEqual(string.trimmingCharacters(in: .whitespaces), "😀word😀")
+            XCTAssertEqual(string.trimmingCharacters(in: CharacterSet.whitespaces.union(emoji)), "word")
+            XCTAssertEqual(string.rangeOfCharacter(from: emoji), NSRange(location: 200, length: 2))
+            XCTAssertEqual(string.rangeOfCharacter(from: emoji, options: .backwards), NSRange(location: 206, length: 2))
+            XCTAssertEqual(string.rangeOfCharacter(from: emoji, options: .anchored, range: NSRange(location: 200, length: 8)), NSRange(location: 200, length: 2))
+            XCTAssertEqual(string.rangeOfCharacter(from: emoji, options: [.anchored, .backwards], range: NSRange(location: 200, length: 8)), NSRange(location: 206, length: 2))
+            XCTAssertEqual(string.rangeOfCharacter(from: .letters, options: .anchored).location, NSNotFound)
+            XCTAssertEqual(string._rangeOfCharacter(notIn: .whitespaces, range: NSRange(location: 0, length: length)), NSRange(location: 200, length: 2))
+            XCTAssertEqual(string._rangeOfCharacter(notIn: .whitespaces, options: .backwards, range: NSRange(location: 0, length: length)), NSRange(location: 206, length: 2))
+            XCTAssertEqual(string.components(separatedBy: emoji).count, 3)
+        }
+
+        let latin1 = NSString(string: String(repeating: "é", count: 100) + "x")
+        XCTAssertEqual(latin1.trimmingCharacters(in: CharacterSet(charactersIn: "é")), "x")
+        XCTAssertEqual("  \t ".trimmingCharacters(in: .whitespaces), "")
+        XCTAssertEqual("a".trimmingCharacters(in: .whitespaces), "a")
+    }
+
+    func test_normalization() {
+        let composed = "Ame\u{0301}lie, Pho\u{031B}\u{0309}, \u{212B}, e\u{0323}\u{0302}"
+        XCTAssertEqual(Array(composed.precomposedStringWithCanonicalMapping.unicodeScalars), Array("Amélie, Phở, Å, ệ".unicodeScalars))
+        XCTAssertEqual(Array("Amélie, ệ, Å".decomposedStringWithCanonicalMapping.unicodeScalars), Array("Ame\u{0301}lie, e\u{0323}\u{0302}, A\u{030A}".unicodeScalars))
+        XCTAssertEqual(Array("e\u{0302}\u{0323}".decomposedStringWithCanonicalMapping.unicodeScalars), ["e", "\u{0323}", "\u{0302}"])
+        XCTAssertEqual("\u{FB01}le \u{2460}".decomposedStringWithCompatibilityMapping, "file 1")
+        XCTAssertEqual("\u{FB01}le \u{2460}".precomposedStringWithCompatibilityMapping, "file 1")
+
+        // Characters excluded from composition, and singletons, are never treated as normalized already.
+        XCTAssertEqual(Array("\u{0958}".precomposedStringWithCanonicalMapping.unicodeScalars), ["\u{0915}", "\u{093C}"])
+        XCTAssertEqual(Array("\u{2126}".precomposedStringWithCanonicalMapping.unicodeScalars), ["\u{03A9}"])
+
+        // Normalized strings come back unchanged, including when only their end needs work.
+        let prefix = String(repeating: "Amélie, 日本語, 😀 ", count: 100)
+        for text in [prefix, prefix + "e\u{0301}"] {
+            let utf16 = Array(text.utf16)
+            let strings: [NSString] = [
+                NSString(string: text),
+                utf16.withUnsafeBufferPointer { NSString(characters: $0.baseAddress!, length: $0.count) },
+            ]
+            for string in strings {
+                XCTAssertEqual(string.precomposedStringWithCanonicalMapping, prefix + (text == prefix ? "" : "é"))
+                XCTAssertEqual(string.decomposedStringWithCanonicalMapping.precomposedStringWithCanonicalMapping, prefix + (text == prefix ? "" : "é"))
+            }
+        }
+        XCTAssertEqual("plain ASCII".precomposedStringWithCompatibilityMapping, "plain ASCII")
+        XCTAssertEqual("".decomposedStringWithCanonicalMapping, "")
+    }
+
+    // Normalizing mixed text, part of which is already normalized, against fully decomposed text.
+    func test_benchmarkPrecomposingMixedText() throws {
+        try benchmarkPrecomposing(decomposedFirst: false)
+    }
+
+    func test_benchmarkPrecomposingDecomposedText() throws {
+        try benchmarkPrecomposing(decomposedFirst: true)
+    }
+
+    private func benchmarkPrecomposing(decomposedFirst: Bool) throws {
+        try skipUnlessBenchmarking()
+        let fragments = [
+            // Latin, precomposed
+            "Où est passée la fenêtre de l'hôtel ? ",
+            "Déjà vu, très élégant, naïve façade. ",
+            "Tiếng Việt có dấu thanh và dấu phụ trên nhiều chữ cái. ",
+            "Zwölf Boxkämpfer jagen Viktor quer über den großen Sylter Deich. ",
+            "Příliš žluťoučký kůň úpěl ďábelské ódy. ",
+            // Latin with combining marks that have no precomposed form
+            "x\u{0301}y\u{0323}z\u{0308} a\u{0332}b\u{0332}c\u{0332} ",
+            "q\u{0303}u\u{0303}e\u{0303} m\u{0304}\u{0301} ",
+            // Already decomposed sequences
+            "Cafe\u{0301} cre\u{0300}me bru\u{0302}le\u{0301}e ",
+            "n\u{0303}andu\u{0301} a\u{030A}ngstro\u{0308}m ",
+            "\u{1100}\u{1161}\u{11A8}\u{1102}\u{1165} ",
+            // Greek and Cyrillic
+            "Ξεσκεπάζω την ψυχοφθόρα βδελυγμία. ",
+            "Съешь же ещё этих мягких французских булок. ",
+            // CJK
+            "漢字仮名交じり文で書かれた文章です。",
+            "いろはにほへと ちりぬるを わかよたれそ つねならむ。",
+            "我能吞下玻璃而不伤身体。",
+            // Hangul, precomposed
+            "다람쥐 헌 쳇바퀴에 타고파. ",
+            "키스의 고유조건은 입술끼리 만나야 하고 특별한 기술은 필요치 않다. ",
+            // ASCII
+            "The quick brown fox jumps over the lazy dog. ",
+            "Pack my box with five dozen liquor jugs. ",
+        ]
+        // Paragraphs of a few fragments each, picked by a fixed linear congruential sequence so every run sees
+        // the same text.
+        var state: UInt32 = 12345
+        var paragraphs: [String] = []
+        for _ in 0..<8000 {
+            var paragraph = ""
+            for _ in 0..<3 {
+                state = state &* 1_103_515_245 &+ 12345
+                paragraph += fragments[Int((state >> 16) % UInt32(fragments.count))]
+            }
+            paragraphs.append(paragraph)
+        }
+        let strings = paragraphs.map { NSString(string: decomposedFirst ? $0.decomposedStringWithCanonicalMapping : $0) }
+        let expected = paragraphs.map { $0.precomposedStringWithCanonicalMapping.utf16.count }
+
+#if NS_FOUNDATION_ALLOWS_TESTABLE_IMPORT
+        // The share of paragraphs that the quick check passes without normalizing, against the share actually in NFC.
+        let quickCheckHits = strings.filter { $0._passesPrecomposedQuickCheck }.count
+        // Swift compares strings by canonical equivalence, so compare the code units.
+        let normalized = strings.filter { ($0 as String).utf16.elementsEqual($0.precomposedStringWithCanonicalMapping.utf16) }.count
+        print("precomposing \(decomposedFirst ? "decomposed" : "mixed") text: quick check hit rate \(String(format: "%.1f", 100 * Double(quickCheckHits) / Double(strings.count)))% of paragraphs, \(String(format: "%.1f", 100 * Double(normalized) / Double(strings.count)))% already in NFC")
+#endif
+
+        measure {
+            for (string, count) in zip(strings, expected) {
+                XCTAssertEqual(string.precomposedStringWithCanonicalMapping.utf16.count, count)
+            }
+        }
+    }
+
+    func test_transformPipeline() {
+        let mutable = NSMutableString(string: "ａｂｃ ｄｅｆ")
+        var updated = NSRange(location: NSNotFound, length: 0)
+        XCTAssertTrue(mutable.applyTransform(StringTransform.fullwidthToHalfwidth.rawValue, reverse: false, range: NSRange(location: 0, length: 3), updatedRange: &updated))
+        XCTAssertEqual(mutable, "abc ｄｅｆ")
+        XCTAssertEqual(updated, NSRange(location: 0, length: 3))
+        XCTAssertEqual(NSString(string: "Ｃａｆé").applyingTransform(.fullwidthToHalfwidth, reverse: false), "Café")
+
+        guard let pipeline = StringTransform.Pipeline([.fullwidthToHalfwidth, .stripDiacritics]) else {
+            XCTFail("Pipeline should be created")
+            return
+        }
+        XCTAssertEqual(pipeline.apply(to: "Ｃａｆé Ｚüｒｉｃｈ"), "Cafe Zurich")
+        XCTAssertEqual(pipeline.apply(to: ""), "")
+        let inputs = (0..<100).map { "Ｎａïｖｅ \($0) " + String(repeating: "ñ", count: $0 * 20) }
+        let expected = (0..<100).map { "Naive \($0) " + String(repeating: "n", count: $0 * 20) }
+        XCTAssertEqual(pipeline.apply(to: inputs), expected)
+        XCTAssertEqual(pipeline.apply(to: []), [])
+
+        XCTAssertEqual(StringTransform.Pipeline([.fullwidthToHalfwidth], reverse: true)?.apply(to: "abc"), "ａｂｃ")
+        XCTAssertNil(StringTransform.Pipeline([.toLatin, StringTransform("Not-A-Transform")]))
+
+        // A pipeline can be shared between threads.
+        DispatchQueue.concurrentPerform(iterations: 8) { _ in
+            for (input, output) in zip(inputs, expected) {
+                XCTAssertEqual(pipeline.apply(to: input), output)
+            }
+        }
+    }
+
+    func test_enumerateLineViews() {
+        var long = ""
+        for i in 0 ..< 300 {
+            long += "line \(i)" + ["\n", "\r\n", "\r", "\u{0085}", "\u{2028}", "\u{2029}"][i % 6]
+        }
+        let texts = ["", "\n", "no terminator", "a\r\n\r\nb\n\rc", "e\u{0300}\u{2028}\u{00C2}\u{0084}x\u{2027}", long, long + "tail"]
+        for text in texts {
+            var expected: [(String, NSRange)] = []
+            // A bridged string and a CF string take different paths through the line scan, and must agree.
+            for nstext in [text as NSString, NSString(data: Data(text.utf8), encoding: String.Encoding.utf8.rawValue)!] {
+                var lines: [(String, NSRange)] = []
+                nstext.enumerateSubstrings(in: NSRange(location: 0, length: nstext.length), options: .byLines) { substring, _, enclosingRange, _ in
+                    lines.append((substring!, enclosingRange))
+                }
+                if expected.isEmpty {
+                    expected = lines
+                }
+                XCTAssertEqual(lines.map { $0.0 }, expected.map { $0.0 })
+                XCTAssertEqual(lines.map { $0.1 }, expected.map { $0.1 })
+            }
+
+            var views: [(String, NSRange)] = []
+            text.enumerateLineViews { line, enclosingRange, _ in
+                views.append((String(line), NSRange(enclosingRange, in: text)))
+            }
+            XCTAssertEqual(views.map { $0.0 }, expected.map { $0.0 }, "Lines of \(text.debugDescription)")
+            XCTAssertEqual(views.map { $0.1 }, expected.map { $0.1 }, "Line ranges of \(text.debugDescription)")
+        }
+
+        var count = 0
+        long.dropFirst(5).enumerateLineViews { line, _, stop in
+            count += 1
+            if count == 1 {
+                XCTAssertEqual(line, "0")
+            }
+            stop = (count == 200)
+        }
+        XCTAssertEqual(count, 200)
+    }
 }
@@ -69,4 +69,41 @@ class TestNSURL: XCTestCase {
         XCTAssertEqual(NSURL(fileURLWithPath: "/path/../file", isDirectory: false).resolvingSymlinksInPath?.absoluteString, "file:///file")
         XCTAssertEqual(NSURL(fileURLWithPath: "/path/to/./file/..", isDirectory: false).resolvingSymlinksInPath?.absoluteString, "file:///path/to")
     }
+
+    func test_componentsAreStableAcrossAccesses() {
+        let url = NSURL(string: "http://us%65r:pa%73s@ex%61mple.com:8080/a%20b/c;p?q=%31&r#fr%61g")!
+        for _ in 0..<3 {
+            XCTAssertEqual(url.scheme, "http")
+            XCTAssertEqual(url.user, "user")
+            XCTAssertEqual(url.password, "pa%73s")
+            XCTAssertEqual(url.host, "example.com")
+            XCTAssertEqual(url.port, 8080)
+            XCTAssertEqual(url.path, "/a b/c")
+            XCTAssertEqual(url.query, "q=%31&r")
+            XCTAssertEqual(url.fragment, "fr%61g")
+        }
+
+        // Non-ASCII strings take the UTF-16 parsing path. NSURL(string:) rejects literal non-ASCII characters, so
+        // build the URL from its data representation, which keeps them as they are.
+        let unicode = NSURL(dataRepresentation: Data("http://example.com/café?q=ü#frag".utf8), relativeTo: nil)
+        for _ in 0..<3 {
+            XCTAssertEqual(unicode.scheme, "http")
+            XCTAssertEqual(unicode.host, "example.com")
+            XCTAssertEqual(unicode.path, "/café")
+            XCTAssertEqual(unicode.query, "q=ü")
+            XCTAssertEqual(unicode.fragment, "frag")
+        }
+        let encoded = NSURL(string: "http://example.com/caf%C3%A9?q=%E2%9C%93")!
+        XCTAssertEqual(encoded.host, "example.com")
+        XCTAssertEqual(encoded.path, "/café")
+        XCTAssertEqual(encoded.query, "q=%E2%9C%93")
+
+        // The first accesses race to fill in the component strings.
+        let shared = NSURL(string: "https://example.com/path/to/resource?key=value")!
+        DispatchQueue.concurrentPerform(iterations: 64) { _ in
+            XCTAssertEqual(shared.host, "example.com")
+            XCTAssertEqual(shared.path, "/path/to/resource")
+            XCTAssertEqual(shared.query, "key=value")
+        }
+    }
 }
@@ -760,6 +760,148 @@ class TestOperationQueue : XCTestCase {
         queue.addOperation(blockOperation)
         waitForExpectations(timeout: 1.0)
     }
+
+    func test_WorkStealingScheduling() {
+        let queue = OperationQueue()
+        queue.schedulingMode = .workStealing
+        queue.maxConcurrentOperationCount = 3
+        XCTAssertEqual(queue.schedulingMode, .workStealing)
+
+        let concurrency = Mutex((running: 0, peak: 0))
+        let finished = Mutex(Set<Int>())
+        let orderViolations = Atomic<Int>(0)
+        let count = 2_000
+
+        // A binary tree: every operation depends on its parent.
+        var ops = [BlockOperation]()
+        for index in 0..<count {
+            let op = BlockOperation {
+                concurrency.withLock { state in
+                    state.running += 1
+                    state.peak = max(state.peak, state.running)
+                }
+                if index > 0 && !finished.withLock({ $0.contains((index - 1) / 2) }) {
+                    orderViolations.wrappingAdd(1, ordering: .relaxed)
+                }
+                finished.withLock { _ = $0.insert(index) }
+                concurrency.withLock { $0.running -= 1 }
+            }
+            if index > 0 {
+                op.addDependency(ops[(index - 1) / 2])
+            }
+            ops.append(op)
+        }
+        queue.addOperations(ops.reversed(), waitUntilFinished: false)
+
+        let barrierSawEverything = Atomic<Bool>(false)
+        queue.addBarrierBlock {
+            barrierSawEverything.store(finished.withLock { $0.count } == count, ordering: .relaxed)
+        }
+        queue.waitUntilAllOperationsAreFinished()
+
+        XCTAssertEqual(finished.withLock { $0.count }, count)
+        XCTAssertEqual(orderViolations.load(ordering: .relaxed), 0)
+        XCTAssertLessThanOrEqual(concurrency.withLock { $0.peak }, 3)
+        XCTAssertTrue(barrierSawEverything.load(ordering: .relaxed))
+        XCTAssertEqual(queue.operationCount, 0)
+    }
+
+    func test_WorkStealingOperationWaitingForAnother() {
+        // Every processor's worker runs an operation that waits until a later one of the same queue has run.
+        let queue = OperationQueue()
+        queue.schedulingMode = .workStealing
+        let waiterCount = ProcessInfo.processInfo.activeProcessorCount
+        let started = DispatchSemaphore(value: 0)
+        let released = DispatchSemaphore(value: 0)
+        let timedOut = Atomic<Int>(0)
+        for _ in 0..<waiterCount {
+            queue.addOperation {
+                started.signal()
+                if released.wait(timeout: .now() + 10) == .timedOut {
+                    timedOut.wrappingAdd(1, ordering: .relaxed)
+                }
+            }
+        }
+        for _ in 0..<waiterCount {
+            XCTAssertEqual(started.wait(timeout: .now() + 10), .success)
+        }
+        queue.addOperation {
+            for _ in 0..<waiterCount {
+                released.signal()
+            }
+        }
+        queue.waitUntilAllOperationsAreFinished()
+        XCTAssertEqual(timedOut.load(ordering: .relaxed), 0)
+    }
+
+    func test_BulkDependencyGraph() {
+        for mode in [OperationQueue.SchedulingMode.dispatch, .workStealing] {
+            let queue = OperationQueue()
+            queue.schedulingMode = mode
+            let layers = 8
+            let width = 100
+            let finishedPerLayer = Mutex([Int](repeating: 0, count: layers))
+            let orderViolations = Atomic<Int>(0)
+
+            // Every operation depends on every operation of the layer before it.
+            var graph = [[BlockOperation]]()
+            for layer in 0..<layers {
+                let ops = (0..<width).map { _ in
+                    BlockOperation {
+                        finishedPerLayer.withLock { finished in
+                            if layer > 0 && finished[layer - 1] != width {
+                                orderViolations.wrappingAdd(1, ordering: .relaxed)
+                            }
+                            finished[layer] += 1
+                        }
+                    }
+                }
+                if let previous = graph.last {
+                    for op in ops {
+                        op.addDependencies(previous + previous)
+                        XCTAssertEqual(op.dependencies.count, width)
+                    }
+                }
+                graph.append(ops)
+            }
+            queue.addOperations(graph.reversed().flatMap { $0 })
+            queue.waitUntilAllOperationsAreFinished()
+
+            XCTAssertEqual(finishedPerLayer.withLock { $0 }, [Int](repeating: width, count: layers))
+            XCTAssertEqual(orderViolations.load(ordering: .relaxed), 0)
+        }
+    }
+
+    func test_CancelParkedOperation() {
+        let queue = OperationQueue()
+        let gate = BlockOperation { Thread.sleep(forTimeInterval: 0.2) }
+        let ranBlocked = Atomic<Bool>(false)
+        let blocked = BlockOperation { ranBlocked.store(true, ordering: .relaxed) }
+        blocked.addDependency(gate)
+        let blockedFinished = expectation(description: "Cancelled operation finished")
+        blocked.completionBlock = { blockedFinished.fulfill() }
+        queue.addOperations([blocked, gate])
+        blocked.cancel()
+        waitForExpectations(timeout: 2.0)
+        XCTAssertFalse(ranBlocked.load(ordering: .relaxed))
+        queue.waitUntilAllOperationsAreFinished()
+    }
+
+    func test_WorkStealingBarrierOnEmptyQueue() {
+        let queue = OperationQueue()
+        queue.schedulingMode = .workStealing
+        let barrierFinished = Atomic<Bool>(false)
+        queue.addBarrierBlock {
+            Thread.sleep(forTimeInterval: 0.2)
+            barrierFinished.store(true, ordering: .releasing)
+        }
+        let ranAfterBarrier = expectation(description: "Operation ran after the barrier")
+        queue.addOperation {
+            XCTAssertTrue(barrierFinished.load(ordering: .acquiring))
+            ranAfterBarrier.fulfill()
+        }
+        waitForExpectations(timeout: 2.0)
+    }
 }
 
 class AsyncOperation: Operation, @unchecked Sendable {
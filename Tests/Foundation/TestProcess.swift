@@ -726,6 +726,41 @@ class TestProcess : XCTestCase {
             close(fd)
         }
     }
+
+    #if !canImport(Darwin)
+    func test_fileDescriptorsAreNotInheritedWhenClosedIndividually() throws {
+        // Without a way to close a range of descriptors in the child, each one is closed on its own. The
+        // copy of the termination socket the child keeps, at descriptor 3, must survive that.
+        Process._closesInheritedDescriptorsIndividually = true
+        defer { Process._closesInheritedDescriptorsIndividually = false }
+        let someExtraFDs = [dup(1), dup(1), dup(1), dup(1), dup(1), dup(1), dup(1)]
+        defer {
+            for fd in someExtraFDs {
+                close(fd)
+            }
+        }
+
+        let task = Process()
+        task.executableURL = try xdgTestHelperURL()
+        task.arguments = ["--print-open-file-descriptors"]
+        task.standardInput = FileHandle.nullDevice
+        let stdoutPipe = Pipe()
+        task.standardOutput = stdoutPipe.fileHandleForWriting
+        task.standardError = FileHandle.nullDevice
+        try task.run()
+
+        try stdoutPipe.fileHandleForWriting.close()
+        let stdoutData = try stdoutPipe.fileHandleForReading.readToEnd()
+        task.waitUntilExit()
+        XCTAssertEqual(task.terminationReason, .exit)
+        XCTAssertEqual(task.terminationStatus, 0)
+        let descriptors = String(decoding: stdoutData ?? Data(), as: Unicode.UTF8.self).split(separator: "\n")
+        XCTAssertEqual(Array(descriptors.prefix(3)), ["0", "1", "2"])
+        // Apart from the standard streams, only the termination socket and possibly /dev/urandom remain.
+        XCTAssertTrue(descriptors.contains("3"), "\(descriptors)")
+        XCTAssertLessThanOrEqual(descriptors.count, 5, "\(descriptors)")
+    }
+    #endif
     #endif
 
     func test_pipeCloseBeforeLaunch() throws {
@@ -825,6 +860,104 @@ class TestProcess : XCTestCase {
         let parentPgrp = Int(getpgrp())
         XCTAssertNotEqual(parentPgrp, childPgrp, "Child process group \(parentPgrp) should not equal parent process group \(childPgrp)")
     }
+
+    func test_outputCapture() throws {
+        final class LineCollector: @unchecked Sendable {
+            let lock = NSLock()
+            var lines: [String] = []
+            var batches = 0
+        }
+        let collector = LineCollector()
+        let expectedLines = (0..<20_000).map { "line \($0) 🐶" } + ["unterminated"]
+        let input = Data(expectedLines.joined(separator: "\n").utf8)
+
+        let process = Process()
+        process.executableURL = try xdgTestHelperURL()
+        process.arguments = ["--cat"]
+        let inputPipe = Pipe()
+        process.standardInput = inputPipe
+        let capture = Process.OutputCapture { lines in
+            collector.lock.lock()
+            collector.lines += lines.map { String(decoding: $0, as: UTF8.self) }
+            collector.batches += 1
+            collector.lock.unlock()
+        }
+        process.standardOutput = capture
+        process.standardError = FileHandle.nullDevice
+        try process.run()
+
+        try inputPipe.fileHandleForWriting.write(contentsOf: input)
+        try inputPipe.fileHandleForWriting.close()
+        process.waitUntilExit()
+        XCTAssertEqual(process.terminationStatus, 0)
+
+        try capture.waitUntilFinished()
+        XCTAssertEqual(capture.capturedData, input)
+        XCTAssertEqual(capture.byteCount, input.count)
+        collector.lock.lock()
+        XCTAssertEqual(collector.lines, expectedLines)
+        // Lines are delivered per read, not one call each.
+        XCTAssertLessThan(collector.batches, expectedLines.count)
+        collector.lock.unlock()
+    }
+
+    func test_outputCaptureForwardingToFile() throws {
+        try withTemporaryDirectory { directory, _ in
+            let path = directory.appendingPathComponent("output").path
+            XCTAssertTrue(FileManager.default.createFile(atPath: path, contents: nil))
+            let file = try FileHandle(forWritingTo: URL(fileURLWithPath: path))
+
+            let input = Data((0..<100_000).map { UInt8(truncatingIfNeeded: $0) })
+            let process = Process()
+            process.executableURL = try xdgTestHelperURL()
+            process.arguments = ["--cat"]
+            let inputPipe = Pipe()
+            process.standardInput = inputPipe
+            let capture = Process.OutputCapture(retainingOutput: false, forwardingTo: file)
+            process.standardOutput = capture
+            process.standardError = FileHandle.nullDevice
+            try process.run()
+
+            try inputPipe.fileHandleForWriting.write(contentsOf: input)
+            try inputPipe.fileHandleForWriting.close()
+            process.waitUntilExit()
+            try capture.waitUntilFinished()
+            try file.close()
+
+            XCTAssertEqual(capture.capturedData, Data())
+            XCTAssertEqual(capture.byteCount, input.count)
+            XCTAssertEqual(FileManager.default.contents(atPath: path), input)
+        }
+    }
+
+    func test_environmentReusedAcrossLaunches() throws {
+        // Launches with an equal environment share one encoded block; a changed environment must not.
+        let template = ["HELLO": "WORLD", "EMPTY": "", "UNICODE": "caf\u{E9} \u{1F600}"]
+        for _ in 0..<3 {
+            let (output, _) = try runTask([try xdgTestHelperURL().path, "--env"], environment: template)
+            XCTAssertEqual(try parseEnv(output), template)
+        }
+        var changed = template
+        changed["HELLO"] = "THERE"
+        let (output, _) = try runTask([try xdgTestHelperURL().path, "--env"], environment: changed)
+        XCTAssertEqual(try parseEnv(output), changed)
+    }
+
+    func test_benchmarkSpawnLatency() throws {
+        try skipUnlessBenchmarking()
+        let helper = try xdgTestHelperURL()
+        measure {
+            for _ in 0..<50 {
+                let process = Process()
+                process.executableURL = helper
+                process.arguments = ["--exit", "0"]
+                process.environment = ["FOUNDATION_SPAWN_BENCHMARK": "1"]
+                XCTAssertNoThrow(try process.run())
+                process.waitUntilExit()
+                XCTAssertEqual(process.terminationStatus, 0)
+            }
+        }
+    }
 #endif
 }
 
@@ -387,6 +387,21 @@ class TestScanner : XCTestCase {
         }
     }
     
+    func testSkipLongRunsAndSupplementaryCharacters() {
+        // Characters outside the BMP can be skipped too, not only tested by scanCharacters(from:).
+        withScanner(for: "\u{1F600} \u{1F600}42 \u{1F600}") {
+            $0.charactersToBeSkipped = CharacterSet(unicodeScalarsIn: "\u{1F600} ")
+            expectEqual($0.scanInt(), 42, "Skip a mix of spaces and emoji")
+            expectEqual($0.isAtEnd, true, "Only skipped characters are left")
+        }
+
+        withScanner(for: String(repeating: " ", count: 200) + "word" + String(repeating: " ", count: 200) + "next") {
+            expectEqual($0.scanCharacters(from: .letters), "word", "Skip a long run of whitespace")
+            expectEqual($0.scanUpToCharacters(from: .whitespaces), "next", "Skip the second run before scanning up to the end")
+            expectEqual($0.isAtEnd, true)
+        }
+    }
+
     func testScanCharactersFromSet() {
         // Scan skipping whitespace:
         withScanner(for: "   doremifasol123 whoa") {
@@ -513,4 +528,30 @@ class TestScanner : XCTestCase {
         // Check a normal scanner has no locale set
         XCTAssertNil(Scanner(string: "foo").locale)
     }
+
+    func testUTF8Stream() {
+        let text = "  name = Lily 👩🏻‍💻\nsize: -42 18446744073709551616 3.25e2 0.1 1e\n-- end --"
+        let data = Data(text.utf8)
+        // A tiny chunk size makes every token cross chunk boundaries, including in the middle of the emoji.
+        let scanners = [Scanner.UTF8Stream(data: data), Scanner.UTF8Stream(stream: InputStream(data: data), chunkSize: 3)]
+        for scanner in scanners {
+            XCTAssertEqual(scanner.scanCharacters(from: .letters)?.string, "name")
+            XCTAssertNil(scanner.scanString("=="))
+            XCTAssertEqual(scanner.scanString("=")?.string, "=")
+            XCTAssertEqual(scanner.scanUpToCharacters(from: .newlines)?.string, "Lily 👩🏻‍💻")
+            XCTAssertTrue(scanner.scanUpToString(":")! == "size")
+            XCTAssertNotNil(scanner.scanString(":"))
+            XCTAssertEqual(scanner.scanInt(), -42)
+            XCTAssertEqual(scanner.scanUInt64(), UInt64.max, "Overflow must clamp like Scanner")
+            XCTAssertEqual(scanner.scanDouble(), 325)
+            XCTAssertEqual(scanner.scanDouble(), 0.1)
+            XCTAssertNil(scanner.scanDouble(), "An exponent without digits is not a number")
+            XCTAssertEqual(scanner.scanString("1e")?.count, 2)
+            XCTAssertNil(scanner.scanInt())
+            XCTAssertEqual(scanner.byteOffset, text.utf8.count - "-- end --".utf8.count)
+            XCTAssertEqual(scanner.scanUpToString("not there")?.string, "-- end --")
+            XCTAssertTrue(scanner.isAtEnd)
+            XCTAssertNil(scanner.scanUpToCharacters(from: .newlines))
+        }
+    }
 }
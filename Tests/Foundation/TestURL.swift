@@ -776,6 +776,41 @@ class TestURL : XCTestCase {
         }
     }
     
+    func test_URLResourceValuesStatCache() throws {
+        try FileManager.default.createDirectory(at: writableTestDirectoryURL, withIntermediateDirectories: true)
+        let fileURL = writableTestDirectoryURL.appendingPathComponent("statCache")
+        try Data(count: 10).write(to: fileURL)
+        let url = NSURL(fileURLWithPath: fileURL.path)
+
+        // Asking for one stat-derived value caches the others from the same stat.
+        let first = try url.resourceValues(forKeys: [.fileSizeKey])
+        XCTAssertEqual(first[.fileSizeKey] as? Int, 10)
+        try Data(count: 20).write(to: fileURL)
+        let cached = try url.resourceValues(forKeys: [.fileSizeKey, .isRegularFileKey, .linkCountKey])
+        XCTAssertEqual(cached[.fileSizeKey] as? Int, 10)
+        XCTAssertEqual(cached[.isRegularFileKey] as? Bool, true)
+        XCTAssertEqual(cached[.linkCountKey] as? Int, 1)
+
+        // Temporary values survive a refresh; removing any stat-derived value drops the whole set.
+        url.setTemporaryResourceValue("temporary", forKey: .isDirectoryKey)
+        let refreshed = try url.refreshResourceValues(forKeys: [.fileSizeKey, .isDirectoryKey])
+        XCTAssertEqual(refreshed[.fileSizeKey] as? Int, 20)
+        XCTAssertEqual(refreshed[.isDirectoryKey] as? String, "temporary")
+        try Data(count: 30).write(to: fileURL)
+        url.removeCachedResourceValue(forKey: .linkCountKey)
+        XCTAssertEqual(try url.resourceValues(forKeys: [.fileSizeKey])[.fileSizeKey] as? Int, 30)
+
+        let missingURL = writableTestDirectoryURL.appendingPathComponent("statCacheMissing")
+        let urls = [fileURL, missingURL, writableTestDirectoryURL!]
+        for concurrency in [1, 3] {
+            let results = URL.resourceValues(forKeys: [.fileSizeKey, .isDirectoryKey], of: urls, maximumConcurrency: concurrency)
+            XCTAssertEqual(results.count, 3)
+            XCTAssertEqual(try results[0].get().fileSize, 30)
+            XCTAssertThrowsError(try results[1].get())
+            XCTAssertEqual(try results[2].get().isDirectory, true)
+        }
+    }
+
     func test_dataFromNonFileURL() {
         do {
             // Tests the up-call to FoundationNetworking to perform the network request
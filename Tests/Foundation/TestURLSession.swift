@@ -2170,8 +2170,105 @@ final class TestURLSession: LoopbackServerTest, @unchecked Sendable {
         }
         #endif
     }
-    
+
+    func test_getStreamCountsPerConnection() async throws {
+        let session = URLSession(configuration: .default, delegate: nil, delegateQueue: nil)
+        @Sendable func streamCounts() async -> [Int] {
+            await withCheckedContinuation { continuation in
+                session.getStreamCountsPerConnection { continuation.resume(returning: $0) }
+            }
+        }
+        let idleCounts = await streamCounts()
+        XCTAssertEqual(idleCounts, [])
+
+        let requestCount = 2
+        var expectations: [XCTestExpectation] = []
+        for index in 0..<requestCount {
+            let url = try XCTUnwrap(URL(string: "http://127.0.0.1:\(TestURLSession.serverPort)/country.txt"))
+            var request = URLRequest(url: url)
+            request.addValue("2", forHTTPHeaderField: "X-Pause")
+            let completed = expectation(description: "GET \(url) #\(index)")
+            let task = session.dataTask(with: request) { _, _, _ in
+                completed.fulfill()
+            }
+            task.priority = URLSessionTask.highPriority
+            task.resume()
+            expectations.append(completed)
+        }
+
+        // The server holds each response for two seconds, so every transfer
+        // is attached to a connection well before the first one completes.
+        var busyCounts = await streamCounts()
+        let deadline = Date(timeIntervalSinceNow: 1.5)
+        while busyCounts.reduce(0, +) < requestCount && Date() < deadline {
+            try await Task.sleep(nanoseconds: 50_000_000)
+            busyCounts = await streamCounts()
+        }
+        // Every in-flight transfer is counted against exactly one connection,
+        // and no more connections are reported than there are transfers.
+        XCTAssertEqual(busyCounts.reduce(0, +), requestCount)
+        XCTAssertGreaterThan(busyCounts.count, 0)
+        XCTAssertLessThanOrEqual(busyCounts.count, requestCount)
+
+        await fulfillment(of: expectations, timeout: 12)
+        session.finishTasksAndInvalidate()
+    }
+
+    func test_multipleEventLoops() async throws {
+        let config = URLSessionConfiguration.default
+        XCTAssertEqual(config.eventLoopCount, 1)
+        config.eventLoopCount = 4
+        XCTAssertEqual((config.copy() as! URLSessionConfiguration).eventLoopCount, 4)
+        config.timeoutIntervalForRequest = 8
+        let session = URLSession(configuration: config, delegate: nil, delegateQueue: nil)
+
+        // Transfers are spread across the loops by host, so reach the server under several names for the loopback
+        // address. Each is its own host to the session; the resolver maps all of them to 127.0.0.1.
+        let hosts = ["127.0.0.1", "localhost", "127.1", "127.0.1", "2130706433", "0x7f000001", "0177.0.0.1", "127.000.000.001"]
+        let capitals = [("Nepal", "Kathmandu"), ("Peru", "Lima"), ("Italy", "Rome"), ("USA", "Washington, D.C."), ("UK", "London")]
+        var expectations: [XCTestExpectation] = []
+        var tasks: [URLSessionDataTask] = []
+        for (index, host) in hosts.enumerated() {
+            let (path, capital) = capitals[index % capitals.count]
+            let url = try XCTUnwrap(URL(string: "http://\(host):\(TestURLSession.serverPort)/\(path)"))
+            let expect = expectation(description: "GET \(url) on one of several event loops")
+            expectations.append(expect)
+            let task = session.dataTask(with: url) { data, response, error in
+                defer { expect.fulfill() }
+                XCTAssertNil(error, "\(url)")
+                XCTAssertEqual((response as? HTTPURLResponse)?.statusCode, 200, "\(url)")
+                XCTAssertEqual(data.flatMap { String(data: $0, encoding: .utf8) }, capital, "\(url)")
+            }
+            tasks.append(task)
+            task.resume()
+        }
+        await fulfillment(of: expectations, timeout: 20)
 #if NS_FOUNDATION_ALLOWS_TESTABLE_IMPORT
+        XCTAssertGreaterThan(Set(tasks.map { $0.eventLoopIndex }).count, 1, "All transfers ran on one event loop")
+#endif
+        session.finishTasksAndInvalidate()
+    }
+
+#if NS_FOUNDATION_ALLOWS_TESTABLE_IMPORT
+    func test_streamCountsGroupTransfersSharingAConnection() {
+        let first = 7, second = 9
+        XCTAssertEqual(URLSession._MultiHandle.streamCounts(forConnectionSockets: [Int?]()), [])
+        XCTAssertEqual(URLSession._MultiHandle.streamCounts(forConnectionSockets: [Int?](repeating: nil, count: 2)), [])
+        // Three transfers multiplexed over one connection report a single count of three.
+        XCTAssertEqual(URLSession._MultiHandle.streamCounts(forConnectionSockets: [first, first, nil, first]), [3])
+        XCTAssertEqual(URLSession._MultiHandle.streamCounts(forConnectionSockets: [first, second, first]).sorted(), [1, 2])
+    }
+
+    func test_http2StreamWeight() {
+        XCTAssertEqual(_EasyHandle.http2StreamWeight(for: 0), 1)
+        XCTAssertEqual(_EasyHandle.http2StreamWeight(for: URLSessionTask.defaultPriority), 129)
+        XCTAssertEqual(_EasyHandle.http2StreamWeight(for: 1), 256)
+        XCTAssertEqual(_EasyHandle.http2StreamWeight(for: 7), 256)
+        XCTAssertEqual(_EasyHandle.http2StreamWeight(for: -1), 1)
+        XCTAssertEqual(_EasyHandle.http2StreamWeight(for: .nan), 16)
+        XCTAssertLessThan(_EasyHandle.http2StreamWeight(for: URLSessionTask.lowPriority), _EasyHandle.http2StreamWeight(for: URLSessionTask.highPriority))
+    }
+
     func test_webSocket() async throws {
         guard #available(macOS 12, iOS 13.0, watchOS 6.0, tvOS 13.0, *) else { return }
         guard URLSessionWebSocketTask.supportsWebSockets else {
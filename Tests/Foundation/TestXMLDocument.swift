@@ -121,6 +121,94 @@ class TestXMLDocument : LoopbackServerTest {
         #endif
     }
 
+    func test_compiledXPath() throws {
+        let compiled = try XMLNode.XPath("/library/book/title")
+        XCTAssertEqual(compiled.expression, "/library/book/title")
+
+        let first = try XMLDocument(xmlString: "<library><book><title>Dune</title></book><book><title>Emma</title></book></library>", options: [])
+        let second = try XMLDocument(xmlString: "<library><book><title>Ulysses</title></book></library>", options: [])
+
+        // The same compiled expression can be evaluated against unrelated documents.
+        XCTAssertEqual(first.stringValues(for: compiled), ["Dune", "Emma"])
+        XCTAssertEqual(second.stringValues(for: compiled), ["Ulysses"])
+
+        let titles = first.nodes(for: compiled)
+        XCTAssertEqual(titles.count, 2)
+        XCTAssertEqual(titles.map { $0.name }, ["title", "title"])
+        XCTAssertEqual(titles.map { $0.stringValue }, try first.nodes(forXPath: "/library/book/title").map { $0.stringValue })
+
+        XCTAssertEqual(try first.stringValues(forXPath: "//book[2]/title"), ["Emma"])
+        XCTAssertEqual(try first.stringValues(forXPath: "/library/magazine"), [])
+        XCTAssertEqual(try first.stringValues(forXPath: "/library"), ["DuneEmma"])
+
+        XCTAssertThrowsError(try XMLNode.XPath("/library/["))
+        XCTAssertThrowsError(try first.nodes(forXPath: "/library/["))
+    }
+
+    func test_compactTree() throws {
+        let xmlString = "<catalog><item id=\"1\">a<b>b</b></item><note>n</note><item id=\"2\">c</item><item id=\"3\">d</item></catalog>"
+        let doc = try XMLDocument(xmlString: xmlString, options: [.documentCompactTree])
+        let root = try XCTUnwrap(doc.rootElement())
+
+        XCTAssertEqual(root.childCount, 4)
+        XCTAssertEqual(root.stringValue, "abncd")
+        let items = root.elements(forName: "item")
+        XCTAssertEqual(items.map { $0.attribute(forName: "id")?.stringValue }, ["1", "2", "3"])
+
+        // While an object is referenced, lookups keep returning it.
+        XCTAssert(items[0] === root.child(at: 0))
+        XCTAssert(items[0].parent === root)
+
+        // Objects that are no longer referenced go away while the document keeps their nodes.
+        weak var weakNote: XMLNode?
+        do {
+            let note = try XCTUnwrap(root.child(at: 1))
+            XCTAssertEqual(note.name, "note")
+            weakNote = note
+        }
+        XCTAssertNil(weakNote)
+        XCTAssertEqual(root.child(at: 1)?.stringValue, "n")
+
+        let detached = items[2]
+        detached.detach()
+        XCTAssertNil(detached.parent)
+        XCTAssertEqual(root.childCount, 3)
+        XCTAssertEqual(detached.xmlString, "<item id=\"3\">d</item>")
+
+        root.addChild(XMLElement(name: "extra", stringValue: "e"))
+        XCTAssertEqual(root.stringValue, "abnce")
+        XCTAssertEqual(root.xmlString, "<catalog><item id=\"1\">a<b>b</b></item><note>n</note><item id=\"2\">c</item><extra>e</extra></catalog>")
+
+        weak var weakDocument: XMLDocument?
+        do {
+            let other = try XMLDocument(xmlString: xmlString, options: [.documentCompactTree])
+            XCTAssertEqual(other.rootElement()?.elements(forName: "item").count, 3)
+            weakDocument = other
+        }
+        XCTAssertNil(weakDocument)
+    }
+
+    func test_compactTreeDescendantObjectsOutliveReplacedContent() throws {
+        let doc = try XMLDocument(xmlString: "<root><a><b>deep</b></a><c k=\"value\"/></root>", options: [.documentCompactTree])
+        let root = try XCTUnwrap(doc.rootElement())
+        let c = try XCTUnwrap(root.elements(forName: "c").first)
+
+        // XPath hands out objects for these nodes without creating any for their parents.
+        let attributeText = try XCTUnwrap(root.nodes(forXPath: "c/@k/text()").first)
+        XCTAssertEqual(attributeText.kind, .text)
+        c.attributes = nil
+        XCTAssertNil(c.attribute(forName: "k"))
+        XCTAssertNil(attributeText.parent)
+        XCTAssertEqual(attributeText.stringValue, "value")
+
+        let grandchild = try XCTUnwrap(root.nodes(forXPath: "a/b").first)
+        root.stringValue = "replaced"
+        XCTAssertEqual(root.xmlString, "<root>replaced</root>")
+        XCTAssertNil(grandchild.parent)
+        XCTAssertEqual(grandchild.stringValue, "deep")
+        XCTAssertEqual(grandchild.xmlString, "<b>deep</b>")
+    }
+
     func test_elementCreation() {
         let element = XMLElement(name: "test", stringValue: "This is my value")
         XCTAssertEqual(element.xmlString, "<test>This is my value</test>")
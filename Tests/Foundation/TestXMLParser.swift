@@ -240,4 +240,58 @@ class TestXMLParser : XCTestCase {
             ])
         }
     }
+
+    func test_largeDocumentFromFileAndStream() throws {
+        class Counter: NSObject, XMLParserDelegate {
+            var started: [String: Int] = [:]
+            var ended = 0
+            var attributes: Set<String> = []
+            var characters = 0
+            func parser(_ parser: XMLParser, didStartElement elementName: String, namespaceURI: String?, qualifiedName qName: String?, attributes attributeDict: [String : String]) {
+                started[elementName, default: 0] += 1
+                attributes.formUnion(attributeDict.keys)
+            }
+            func parser(_ parser: XMLParser, didEndElement elementName: String, namespaceURI: String?, qualifiedName qName: String?) {
+                ended += 1
+            }
+            func parser(_ parser: XMLParser, foundCharacters string: String) {
+                characters += string.utf8.count
+            }
+        }
+
+        // Large enough to be fed to libxml2 in several chunks, with names
+        // and the byte order mark detection spanning chunk boundaries.
+        let itemCount = 20_000
+        var xml = "<?xml version='1.0' encoding='UTF-8'?><feed xmlns:x='urn:x'>"
+        for i in 0..<itemCount {
+            xml += "<x:item id='\(i)' x:kind='k'><title>t\(i % 10)</title></x:item>"
+        }
+        xml += "</feed>"
+        let data = Data(xml.utf8)
+        XCTAssertGreaterThan(data.count, 4096 * 32 * 4)
+
+        func check(_ parser: XMLParser?, file: StaticString = #filePath, line: UInt = #line) {
+            guard let parser = parser else {
+                XCTFail("Could not create parser", file: file, line: line)
+                return
+            }
+            let counter = Counter()
+            parser.delegate = counter
+            XCTAssertTrue(parser.parse(), file: file, line: line)
+            XCTAssertEqual(counter.started["feed"], 1, file: file, line: line)
+            XCTAssertEqual(counter.started["x:item"], itemCount, file: file, line: line)
+            XCTAssertEqual(counter.started["title"], itemCount, file: file, line: line)
+            XCTAssertEqual(counter.ended, 2 * itemCount + 1, file: file, line: line)
+            XCTAssertEqual(counter.attributes, ["xmlns:x", "id", "x:kind"], file: file, line: line)
+            XCTAssertEqual(counter.characters, 2 * itemCount, file: file, line: line)
+        }
+
+        try withTemporaryDirectory { dir, _ in
+            let url = dir.appendingPathComponent("feed.xml")
+            try data.write(to: url)
+            check(XMLParser(contentsOf: url))
+            check(XMLParser(stream: try XCTUnwrap(InputStream(url: url))))
+        }
+        check(XMLParser(data: data))
+    }
 }
@@ -518,6 +518,13 @@ private func printStderr(_ msg: String) {
     try? FileHandle.standardError.write(contentsOf: Data(msg.utf8))
 }
 
+// Benchmarks are too slow for routine test runs, and only run when NS_FOUNDATION_RUN_BENCHMARKS is set to YES.
+func skipUnlessBenchmarking() throws {
+    guard ProcessInfo.processInfo.environment["NS_FOUNDATION_RUN_BENCHMARKS"] == "YES" else {
+        throw XCTSkip("Set NS_FOUNDATION_RUN_BENCHMARKS=YES to run benchmarks")
+    }
+}
+
 func shouldAttemptXFailTests(_ reason: String) -> Bool {
     if shouldRunXFailTests {
         return true